@@ -73,6 +73,7 @@ bool AIInfer::init(const std::string &model_path) {
         session_ = std::make_unique<Ort::Session>(env_,model_path.c_str(),session_options_);
         // 获取输入/输出及诶但名称
         getModelInputOutputNmames(session_.get(), input_names_, output_names_);
+        input_shape_ = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
         std::cout << input_names_.size() << std::endl;
         std::cout << "ONNX模型加载成功，输入节点：" << input_names_[0]
         << "，输出节点：" << output_names_[0] << "\n" << std::endl;
@@ -137,24 +138,7 @@ AIResult AIInfer::infer(const float *input_data, int input_size) {
         float * output_data = output_tensors[0].GetTensorMutableData<float>();
         size_t output_size = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
         
-        // 找到概率最大的类别（Top-1）
-        int max_index = 0;
-        float max_score = 0.0f;
-        for (int i = 0; i < output_size; ++i) {
-            if (output_data[i] > max_score) {
-                max_score = output_data[i];
-                max_index = i;
-            }
-        }
-        std::string class_name;
-        if (max_index >= 0 && max_index < imagenet_labels_.size()) {
-            class_name = imagenet_labels_[max_index];
-        } else {
-            class_name = "unknown";  // 无效ID时显示未知
-        }
-        result.class_name = class_name;  // 临时占位
-        result.confidence = max_score;
-        result.is_valid = (max_score > 0.5f);  // 置信度>0.5视为有效
+        result = topResult(output_data, output_size);
         
     } catch (const Ort::Exception e) {
         std::cerr << "推理失败：" << e.what() << std::endl;
@@ -162,6 +146,73 @@ AIResult AIInfer::infer(const float *input_data, int input_size) {
     return result;
 }
 
+std::vector<AIResult> AIInfer::inferBatch(const float* input_data, int batch_size, int height, int width) {
+    std::vector<AIResult> results;
+    if (!session_ || !input_data || batch_size <= 0 || height <= 0 || width <= 0) {
+        std::cerr << "批量推理参数无效" << std::endl;
+        return results;
+    }
+    // 模型的 H/W 是固定值时必须与输入一致，否则 ORT 会按错误的形状读取（甚至越界）
+    if (input_shape_.size() == 4 &&
+        ((input_shape_[2] > 0 && input_shape_[2] != height) || (input_shape_[3] > 0 && input_shape_[3] != width))) {
+        std::cerr << "批量推理输入尺寸 " << width << "x" << height << " 与模型输入 "
+                  << input_shape_[3] << "x" << input_shape_[2] << " 不一致" << std::endl;
+        return results;
+    }
+    const size_t sample_size = static_cast<size_t>(3) * height * width;
+    
+    try {
+        // 输入形状 [N,3,H,W]，直接包装调用者的连续缓冲区（不复制）
+        std::vector<int64_t> input_dims = {batch_size, 3, height, width};
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info,
+                                                                  const_cast<float*>(input_data),
+                                                                  sample_size * batch_size,
+                                                                  input_dims.data(),
+                                                                  input_dims.size()
+                                                                  );
+        const char* input_name_ptr = input_names_[0].c_str();
+        const char* output_name_ptr = output_names_[0].c_str();
+        std::vector<Ort::Value> output_tensors = session_->Run(Ort::RunOptions{nullptr},
+                                                               &input_name_ptr, &input_tensor, 1,
+                                                               &output_name_ptr, 1);
+        
+        // 输出 [N, 类别数]，逐帧取 Top-1
+        const float* output_data = output_tensors[0].GetTensorMutableData<float>();
+        const size_t output_size = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
+        const size_t class_count = output_size / batch_size;
+        results.reserve(batch_size);
+        for (int i = 0; i < batch_size; ++i) {
+            results.push_back(topResult(output_data + i * class_count, class_count));
+        }
+    } catch (const Ort::Exception& e) {
+        std::cerr << "批量推理失败：" << e.what() << std::endl;
+        results.clear();
+    }
+    return results;
+}
+
+AIResult AIInfer::topResult(const float* scores, size_t count) const {
+    AIResult result;
+    // 找到概率最大的类别（Top-1）
+    int max_index = 0;
+    float max_score = 0.0f;
+    for (int i = 0; i < static_cast<int>(count); ++i) {
+        if (scores[i] > max_score) {
+            max_score = scores[i];
+            max_index = i;
+        }
+    }
+    if (max_index >= 0 && max_index < static_cast<int>(imagenet_labels_.size())) {
+        result.class_name = imagenet_labels_[max_index];
+    } else {
+        result.class_name = "unknown";  // 无效ID时显示未知
+    }
+    result.confidence = max_score;
+    result.is_valid = (max_score > 0.5f);  // 置信度>0.5视为有效
+    return result;
+}
+
 void AIInfer::destroy() {
     // ONNX Runtime的对象会自动析构，无需手动释放
     session_.reset();
@@ -28,17 +28,32 @@ public:
     
     //开始推理：输入归一化结果，输出结果
     AIResult infer(const float * input_data, int input_size);
+    
+    /**
+     * 批量推理：一次 Run 处理 N 帧
+     * @param input_data 连续的 [N,3,height,width] 输入（如 BatchTensorBuilder::data()）
+     * @param batch_size 帧数 N
+     * @param height 输入高度（如 BatchTensorBuilder::height()）
+     * @param width 输入宽度
+     * @return 每帧的结果（失败或与模型输入形状不符时返回空）
+     * @note 需要模型的 batch 维是动态的（mobilenetv2-12 为动态 batch）；模型的 H/W 为固定值时必须一致
+     */
+    std::vector<AIResult> inferBatch(const float* input_data, int batch_size, int height, int width);
         
     //销毁资源
     void destroy();
     
 private:
+    // 由一帧的输出概率取 Top-1 结果
+    AIResult topResult(const float* scores, size_t count) const;
+    
     // ONNX Runtime 核心对象
     Ort::Env env_;                              //环境对象（全局唯一）
     Ort::SessionOptions session_options_;       //会话配置（优化级别，线程数）
     std::unique_ptr<Ort::Session> session_;     //推理会话
     std::vector<std::string> input_names_;      //输入节点名称
     std::vector<std::string> output_names_;     //输出节点名称
+    std::vector<int64_t> input_shape_;          //模型输入形状（NCHW，动态维为 -1）
     
     std::vector<std::string> imagenet_labels_;  //需要查的对应的表
 };
@@ -0,0 +1,45 @@
+//
+//  motion_gate.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include "motion_gate.h"
+
+MotionGate::MotionGate(float threshold, int max_skip_frames)
+: threshold_(threshold), max_skip_frames_(max_skip_frames) {
+}
+
+bool MotionGate::shouldInfer(const VideoFrame& frame) {
+    const float motion = frame.motionScore();
+    bool infer = !has_result_ || motion < 0;
+    if (!infer) {
+        accumulated_motion_ += motion;
+        infer = accumulated_motion_ >= threshold_ ||
+                (max_skip_frames_ > 0 && frames_since_infer_ >= max_skip_frames_);
+    }
+    if (!infer) {
+        frames_since_infer_++;
+        skipped_count_++;
+    }
+    return infer;
+}
+
+void MotionGate::update(const AIResult& result) {
+    last_result_ = result;
+    has_result_ = true;
+    accumulated_motion_ = 0.0f;
+    frames_since_infer_ = 0;
+    inferred_count_++;
+}
+
+void MotionGate::reset() {
+    accumulated_motion_ = 0.0f;
+    frames_since_infer_ = 0;
+    has_result_ = false;
+    last_result_ = AIResult{"", 0.0f, false};
+    inferred_count_ = 0;
+    skipped_count_ = 0;
+}
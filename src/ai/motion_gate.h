@@ -0,0 +1,54 @@
+//
+//  motion_gate.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef MOTION_GATE_H
+#define MOTION_GATE_H
+
+#include "infer_engine.h"
+#include "../common/media_frame.h"
+
+/**
+ * 基于码流运动矢量的推理门控：画面静止时跳过推理，复用上一次的 AIResult
+ * 按上次推理以来的累计运动量判断（缓慢平移逐帧运动量很小，累计起来也会触发推理）；
+ * 运动量未知的帧（I 帧、未导出运动矢量）总是推理，并设置最长跳过帧数防止长时间不刷新
+ * 用法：shouldInfer(frame) 为 true 时推理并调用 update(result)，否则直接用 lastResult()
+ */
+class MotionGate {
+public:
+    /**
+     * @param threshold 累计运动量阈值（像素，见 VideoFrame::motionScore）
+     * @param max_skip_frames 最多连续跳过的帧数（<= 0 表示不限制）
+     */
+    explicit MotionGate(float threshold = 2.0f, int max_skip_frames = 250);
+    
+    // 当前帧是否需要推理（返回 false 时计入跳过）
+    bool shouldInfer(const VideoFrame& frame);
+    
+    // 记录推理结果，累计运动量清零
+    void update(const AIResult& result);
+    
+    // 上一次推理结果（还没有推理过时 is_valid 为 false）
+    const AIResult& lastResult() const { return last_result_; }
+    
+    // 清空状态（跳转、换文件后调用）
+    void reset();
+    
+    int inferredCount() const { return inferred_count_; }
+    int skippedCount() const { return skipped_count_; }
+    
+private:
+    float threshold_;
+    int max_skip_frames_;
+    float accumulated_motion_ = 0.0f;   // 上次推理以来的累计运动量
+    int frames_since_infer_ = 0;
+    bool has_result_ = false;
+    AIResult last_result_{"", 0.0f, false};
+    int inferred_count_ = 0;
+    int skipped_count_ = 0;
+};
+
+#endif /* MOTION_GATE_H */
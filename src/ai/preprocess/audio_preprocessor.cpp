@@ -0,0 +1,396 @@
+//
+//  audio_preprocessor.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "audio_preprocessor.h"
+#include "../../util/simd/cpu_features.h"
+#include "../../util/audio/sample_converter.h"
+#include "../../common/log/log.h"
+
+static const float kPi = 3.14159265358979323846f;
+
+// ------------------------------
+// 计算内核（标量 / AVX2）
+// ------------------------------
+
+// 蝶形：a' = a + b*w，b' = a - b*w（n 个连续元素）
+static void butterflyScalar(float* a_re, float* a_im, float* b_re, float* b_im,
+                            const float* w_re, const float* w_im, int n) {
+    for (int i = 0; i < n; ++i) {
+        const float t_re = b_re[i] * w_re[i] - b_im[i] * w_im[i];
+        const float t_im = b_re[i] * w_im[i] + b_im[i] * w_re[i];
+        b_re[i] = a_re[i] - t_re;
+        b_im[i] = a_im[i] - t_im;
+        a_re[i] += t_re;
+        a_im[i] += t_im;
+    }
+}
+
+// 幅度谱 / 功率谱
+static void magnitudeScalar(const float* re, const float* im, float* out, int n, bool power) {
+    for (int i = 0; i < n; ++i) {
+        const float p = re[i] * re[i] + im[i] * im[i];
+        out[i] = power ? p : std::sqrt(p);
+    }
+}
+
+static float dotScalar(const float* a, const float* b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#if SIMD_X86_AVX2
+SIMD_TARGET_AVX2
+static void butterflyAVX2(float* a_re, float* a_im, float* b_re, float* b_im,
+                          const float* w_re, const float* w_im, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 br = _mm256_loadu_ps(b_re + i);
+        const __m256 bi = _mm256_loadu_ps(b_im + i);
+        const __m256 wr = _mm256_loadu_ps(w_re + i);
+        const __m256 wi = _mm256_loadu_ps(w_im + i);
+        const __m256 t_re = _mm256_fmsub_ps(br, wr, _mm256_mul_ps(bi, wi));
+        const __m256 t_im = _mm256_fmadd_ps(br, wi, _mm256_mul_ps(bi, wr));
+        const __m256 ar = _mm256_loadu_ps(a_re + i);
+        const __m256 ai = _mm256_loadu_ps(a_im + i);
+        _mm256_storeu_ps(b_re + i, _mm256_sub_ps(ar, t_re));
+        _mm256_storeu_ps(b_im + i, _mm256_sub_ps(ai, t_im));
+        _mm256_storeu_ps(a_re + i, _mm256_add_ps(ar, t_re));
+        _mm256_storeu_ps(a_im + i, _mm256_add_ps(ai, t_im));
+    }
+    butterflyScalar(a_re + i, a_im + i, b_re + i, b_im + i, w_re + i, w_im + i, n - i);
+}
+
+SIMD_TARGET_AVX2
+static void magnitudeAVX2(const float* re, const float* im, float* out, int n, bool power) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 r = _mm256_loadu_ps(re + i);
+        const __m256 m = _mm256_loadu_ps(im + i);
+        const __m256 p = _mm256_fmadd_ps(r, r, _mm256_mul_ps(m, m));
+        _mm256_storeu_ps(out + i, power ? p : _mm256_sqrt_ps(p));
+    }
+    magnitudeScalar(re + i, im + i, out + i, n - i, power);
+}
+
+SIMD_TARGET_AVX2
+static float dotAVX2(const float* a, const float* b, int n) {
+    __m256 acc = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc);
+    }
+    // 水平求和
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum) + dotScalar(a + i, b + i, n - i);
+}
+#endif
+
+// HTK mel 刻度
+static float hzToMel(float hz) {
+    return 2595.0f * std::log10(1.0f + hz / 700.0f);
+}
+
+static float melToHz(float mel) {
+    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+// ------------------------------
+// LogMelExtractor
+// ------------------------------
+LogMelExtractor::LogMelExtractor(const LogMelConfig& config) : config_(config) {
+    const int fft_size = config_.fft_size;
+    if (config_.sample_rate <= 0 || config_.window_size <= 0 || config_.hop_size <= 0 || config_.num_mels <= 0 ||
+        config_.hop_size > config_.window_size) {
+        error_msg_ = "log-mel 参数无效：采样率/窗长/帧移/mel 数必须大于 0，且帧移不大于窗长";
+        LOG_ERROR(error_msg_);
+        return;
+    }
+    if (fft_size < 4 || (fft_size & (fft_size - 1)) != 0 || fft_size < config_.window_size) {
+        error_msg_ = "log-mel 参数无效：fft_size 必须是 2 的幂且不小于窗长";
+        LOG_ERROR(error_msg_);
+        return;
+    }
+    if (config_.fmin < 0 || config_.fmax <= config_.fmin || config_.fmax > config_.sample_rate / 2.0f) {
+        error_msg_ = "log-mel 参数无效：频率范围需满足 0 <= fmin < fmax <= sample_rate/2";
+        LOG_ERROR(error_msg_);
+        return;
+    }
+    use_avx2_ = CpuInfo::hasAVX2();
+    initWindow();
+    initFFT();
+    initMelFilters();
+    fft_re_.resize(fft_size / 2);
+    fft_im_.resize(fft_size / 2);
+    bins_re_.resize(fft_size / 2 + 1);
+    bins_im_.resize(fft_size / 2 + 1);
+    spectrum_.resize(fft_size / 2 + 1);
+}
+
+void LogMelExtractor::initWindow() {
+    // 周期 Hann 窗，窗长之外补零到 fft_size
+    window_.assign(config_.fft_size, 0.0f);
+    for (int i = 0; i < config_.window_size; ++i) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * kPi * i / config_.window_size);
+    }
+}
+
+void LogMelExtractor::initFFT() {
+    // 实数 FFT（N 点）= 复数 FFT（N/2 点，偶数点作实部、奇数点作虚部）+ 后处理
+    const int n = config_.fft_size / 2;
+    int bits = 0;
+    while ((1 << bits) < n) {
+        ++bits;
+    }
+    bit_reverse_.resize(n);
+    for (int i = 0; i < n; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bit_reverse_[i] = reversed;
+    }
+    
+    // 各级旋转因子连续存放：第 s 级（半长 half）存 half 个
+    twiddle_re_.clear();
+    twiddle_im_.clear();
+    for (int half = 1; half < n; half <<= 1) {
+        for (int j = 0; j < half; ++j) {
+            const float angle = -kPi * j / half;
+            twiddle_re_.push_back(std::cos(angle));
+            twiddle_im_.push_back(std::sin(angle));
+        }
+    }
+    
+    post_re_.resize(n + 1);
+    post_im_.resize(n + 1);
+    for (int k = 0; k <= n; ++k) {
+        const float angle = -2.0f * kPi * k / config_.fft_size;
+        post_re_[k] = std::cos(angle);
+        post_im_[k] = std::sin(angle);
+    }
+}
+
+void LogMelExtractor::initMelFilters() {
+    const int num_bins = config_.fft_size / 2 + 1;
+    const float bin_hz = static_cast<float>(config_.sample_rate) / config_.fft_size;
+    const float mel_min = hzToMel(config_.fmin);
+    const float mel_max = hzToMel(config_.fmax);
+    
+    // num_mels + 2 个边界点在 mel 刻度上等间距
+    std::vector<float> edges(config_.num_mels + 2);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        edges[i] = melToHz(mel_min + (mel_max - mel_min) * i / (config_.num_mels + 1));
+    }
+    
+    mel_start_.clear();
+    mel_length_.clear();
+    mel_offset_.clear();
+    mel_weights_.clear();
+    for (int m = 0; m < config_.num_mels; ++m) {
+        const float lower = edges[m];
+        const float center = edges[m + 1];
+        const float upper = edges[m + 2];
+        int start = -1;
+        int end = -1;
+        std::vector<float> weights;
+        for (int k = 0; k < num_bins; ++k) {
+            const float hz = k * bin_hz;
+            float weight = 0.0f;
+            if (hz > lower && hz <= center) {
+                weight = (hz - lower) / (center - lower);
+            } else if (hz > center && hz < upper) {
+                weight = (upper - hz) / (upper - center);
+            }
+            if (weight > 0.0f) {
+                if (start < 0) {
+                    start = k;
+                }
+                end = k;
+            }
+            weights.push_back(weight);
+        }
+        if (start < 0) {
+            // 频带太窄没有覆盖任何频点（mel 数相对 FFT 点数过多），输出恒为 log(offset)
+            start = 0;
+            end = -1;
+        }
+        mel_start_.push_back(start);
+        mel_length_.push_back(end - start + 1);
+        mel_offset_.push_back(mel_weights_.size());
+        mel_weights_.insert(mel_weights_.end(), weights.begin() + start, weights.begin() + end + 1);
+    }
+}
+
+void LogMelExtractor::complexFFT(float* re, float* im) {
+    const int n = config_.fft_size / 2;
+    for (int i = 0; i < n; ++i) {
+        const int j = bit_reverse_[i];
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    size_t twiddle_offset = 0;
+    for (int half = 1; half < n; half <<= 1) {
+        const float* w_re = twiddle_re_.data() + twiddle_offset;
+        const float* w_im = twiddle_im_.data() + twiddle_offset;
+        for (int start = 0; start < n; start += 2 * half) {
+            // 前几级 half < 8 不够一个向量宽度，走标量
+#if SIMD_X86_AVX2
+            if (use_avx2_ && half >= 8) {
+                butterflyAVX2(re + start, im + start, re + start + half, im + start + half, w_re, w_im, half);
+                continue;
+            }
+#endif
+            butterflyScalar(re + start, im + start, re + start + half, im + start + half, w_re, w_im, half);
+        }
+        twiddle_offset += half;
+    }
+}
+
+void LogMelExtractor::computeFrame(const float* samples, float* mel_out) {
+    const int n = config_.fft_size / 2;
+    float* re = fft_re_.data();
+    float* im = fft_im_.data();
+    // 加窗，同时把实数序列打包成 N/2 点复数序列（窗长之外的 window_ 为 0，不会越界读取）
+    for (int i = 0; i < n; ++i) {
+        const int even = 2 * i;
+        re[i] = even < config_.window_size ? samples[even] * window_[even] : 0.0f;
+        im[i] = even + 1 < config_.window_size ? samples[even + 1] * window_[even + 1] : 0.0f;
+    }
+    complexFFT(re, im);
+    
+    // 后处理得到实数 FFT 的 0..N/2 频点：X[k] = E[k] + W^k * O[k]
+    float* x_re = bins_re_.data();
+    float* x_im = bins_im_.data();
+    for (int k = 0; k <= n; ++k) {
+        const int k1 = k % n;
+        const int k2 = (n - k) % n;
+        const float a = re[k1], b = im[k1];
+        const float c = re[k2], d = im[k2];
+        const float e_re = 0.5f * (a + c);
+        const float e_im = 0.5f * (b - d);
+        const float o_re = 0.5f * (b + d);
+        const float o_im = -0.5f * (a - c);
+        x_re[k] = e_re + post_re_[k] * o_re - post_im_[k] * o_im;
+        x_im[k] = e_im + post_re_[k] * o_im + post_im_[k] * o_re;
+    }
+    
+#if SIMD_X86_AVX2
+    if (use_avx2_) {
+        magnitudeAVX2(x_re, x_im, spectrum_.data(), n + 1, config_.power);
+        for (int m = 0; m < config_.num_mels; ++m) {
+            const float energy = dotAVX2(mel_weights_.data() + mel_offset_[m], spectrum_.data() + mel_start_[m], mel_length_[m]);
+            mel_out[m] = std::log(energy + config_.log_offset);
+        }
+        return;
+    }
+#endif
+    magnitudeScalar(x_re, x_im, spectrum_.data(), n + 1, config_.power);
+    for (int m = 0; m < config_.num_mels; ++m) {
+        const float energy = dotScalar(mel_weights_.data() + mel_offset_[m], spectrum_.data() + mel_start_[m], mel_length_[m]);
+        mel_out[m] = std::log(energy + config_.log_offset);
+    }
+}
+
+void LogMelExtractor::processPending() {
+    const size_t window = config_.window_size;
+    const size_t hop = config_.hop_size;
+    size_t offset = 0;
+    while (offset + window <= pending_.size()) {
+        const size_t old_size = mel_frames_.size();
+        mel_frames_.resize(old_size + config_.num_mels);
+        computeFrame(pending_.data() + offset, mel_frames_.data() + old_size);
+        offset += hop;
+    }
+    // 只保留下一个窗口还要用到的采样
+    if (offset > 0) {
+        offset = std::min(offset, pending_.size());
+        pending_.erase(pending_.begin(), pending_.begin() + offset);
+    }
+}
+
+bool LogMelExtractor::pushSamples(const float* samples, size_t count) {
+    if (!isValid()) {
+        return false;
+    }
+    if (!samples || count == 0) {
+        return true;
+    }
+    pending_.insert(pending_.end(), samples, samples + count);
+    processPending();
+    return true;
+}
+
+bool LogMelExtractor::pushFrame(const AudioFrame& frame) {
+    if (!isValid()) {
+        return false;
+    }
+    const int nb_samples = frame.nbSamples();
+    if (nb_samples <= 0 || frame.channels() <= 0 || !frame.data()) {
+        return true;
+    }
+    mono_.resize(nb_samples);
+    if (!SampleConverter::toMonoFloat(frame, mono_.data())) {
+        LOG_ERROR("log-mel 不支持的采样格式：" + SampleFormatToString(frame.sampleFormat()));
+        return false;
+    }
+    if (frame.sampleRate() == config_.sample_rate) {
+        return pushSamples(mono_.data(), mono_.size());
+    }
+    
+    // 采样率不一致：重采样到 config.sample_rate（采样率变化时重建重采样器）
+    if (!resampler_ || resampler_->inRate() != frame.sampleRate()) {
+        resampler_ = std::make_unique<Resampler>(frame.sampleRate(), config_.sample_rate);
+        if (!resampler_->isValid()) {
+            LOG_ERROR("log-mel 重采样器创建失败：" + resampler_->getErrorMsg());
+            resampler_.reset();
+            return false;
+        }
+    }
+    resampled_.clear();
+    resampler_->process(mono_.data(), mono_.size(), resampled_);
+    return pushSamples(resampled_.data(), resampled_.size());
+}
+
+bool LogMelExtractor::readTensor(float* output, int num_frames, int hop_frames, MelLayout layout) {
+    if (!output || num_frames <= 0 || availableFrames() < static_cast<size_t>(num_frames)) {
+        return false;
+    }
+    const int num_mels = config_.num_mels;
+    if (layout == MelLayout::TIME_MAJOR) {
+        std::memcpy(output, mel_frames_.data(), sizeof(float) * num_frames * num_mels);
+    } else {
+        for (int t = 0; t < num_frames; ++t) {
+            const float* frame = mel_frames_.data() + t * num_mels;
+            for (int m = 0; m < num_mels; ++m) {
+                output[m * num_frames + t] = frame[m];
+            }
+        }
+    }
+    // 丢弃已经滑过的帧，重叠部分留给下一个张量
+    const size_t drop = static_cast<size_t>(std::max(0, std::min(hop_frames, num_frames))) * num_mels;
+    mel_frames_.erase(mel_frames_.begin(), mel_frames_.begin() + drop);
+    return true;
+}
+
+void LogMelExtractor::reset() {
+    pending_.clear();
+    mel_frames_.clear();
+    if (resampler_) {
+        resampler_->reset();
+    }
+}
@@ -0,0 +1,122 @@
+//
+//  audio_preprocessor.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef AUDIO_PREPROCESSOR_H
+#define AUDIO_PREPROCESSOR_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include "../../common/media_frame.h"
+#include "../../util/audio/resampler.h"
+
+// log-mel 参数（默认值与 YAMNet 等常见音频分类模型一致：16kHz、25ms 窗、10ms 帧移、64 个 mel 频带）
+struct LogMelConfig {
+    int sample_rate = 16000;    // 输入采样率
+    int window_size = 400;      // 分析窗长（采样点）
+    int hop_size = 160;         // 帧移（采样点）
+    int fft_size = 512;         // FFT 点数（2 的幂，不小于窗长）
+    int num_mels = 64;          // mel 频带数
+    float fmin = 125.0f;        // 最低频率（Hz）
+    float fmax = 7500.0f;       // 最高频率（Hz），不超过 sample_rate / 2
+    float log_offset = 0.001f;  // log(mel + log_offset)，避免 log(0)
+    bool power = false;         // true: 功率谱 |X|^2；false: 幅度谱 |X|
+};
+
+// 输出张量布局
+enum class MelLayout {
+    TIME_MAJOR,     // [帧数, mel 数]
+    MEL_MAJOR       // [mel 数, 帧数]
+};
+
+/**
+ * 流式 log-mel 频谱提取：把解码出的 PCM 转成音频分类模型（ONNX）的输入张量
+ * - 按帧移滑动重叠窗口，跨 AudioFrame 保留未用完的采样，每个窗口只计算一次
+ * - 已算好的 mel 帧缓存起来，相邻两次推理的张量重叠部分不重复计算
+ * - FFT 蝶形运算、幅度谱和 mel 滤波器组在支持 AVX2 的 CPU 上走向量化路径，否则走标量路径
+ * 用法：循环 pushFrame()/pushSamples()，availableFrames() 足够时 readTensor() 取张量送入模型
+ */
+class LogMelExtractor {
+public:
+    explicit LogMelExtractor(const LogMelConfig& config = LogMelConfig());
+    
+    // 参数是否有效（无效时 getErrorMsg() 说明原因）
+    bool isValid() const { return error_msg_.empty(); }
+    std::string getErrorMsg() const { return error_msg_; }
+    const LogMelConfig& config() const { return config_; }
+    
+    /**
+     * 输入单声道 float PCM（采样率需等于 config.sample_rate）
+     * @return 成功返回true
+     */
+    bool pushSamples(const float* samples, size_t count);
+    
+    /**
+     * 输入解码得到的音频帧（任意采样格式；多声道取平均混成单声道，采样率不同时重采样到 config.sample_rate）
+     * @return 成功返回true；格式不支持返回false
+     */
+    bool pushFrame(const AudioFrame& frame);
+    
+    // 已计算、尚未被 readTensor 丢弃的 mel 帧数
+    size_t availableFrames() const { return mel_frames_.size() / config_.num_mels; }
+    
+    /**
+     * 取出 num_frames 帧 log-mel 作为模型输入，然后丢弃最前面的 hop_frames 帧
+     * @param output 输出缓冲区，大小至少 num_frames * num_mels
+     * @param num_frames 张量帧数（如 YAMNet 为 96）
+     * @param hop_frames 相邻两个张量之间的帧移（小于 num_frames 时相邻张量重叠，重叠部分直接复用）
+     * @param layout 输出布局
+     * @return 可用帧数不足返回false
+     */
+    bool readTensor(float* output, int num_frames, int hop_frames, MelLayout layout = MelLayout::TIME_MAJOR);
+    
+    // 清空所有缓存的采样和 mel 帧（跳转后调用）
+    void reset();
+    
+private:
+    void initWindow();
+    void initFFT();
+    void initMelFilters();
+    // 计算一个窗口的 log-mel（输出 num_mels 个值）
+    void computeFrame(const float* samples, float* mel_out);
+    // 原地复数 FFT（fft_size / 2 点，SoA 布局）
+    void complexFFT(float* re, float* im);
+    // 处理 pending_ 中所有完整窗口
+    void processPending();
+    
+    LogMelConfig config_;
+    std::string error_msg_;
+    bool use_avx2_ = false;
+    
+    std::vector<float> window_;         // Hann 窗（长度 fft_size，窗长之外补零）
+    std::vector<int> bit_reverse_;      // 复数 FFT 位反转下标
+    std::vector<float> twiddle_re_;     // 各级蝶形的旋转因子（按级连续存放，内层循环可以直接向量化）
+    std::vector<float> twiddle_im_;
+    std::vector<float> post_re_;        // 实数 FFT 后处理旋转因子 e^{-2πik/N}
+    std::vector<float> post_im_;
+    
+    // mel 滤波器组：只存每个滤波器的非零区间
+    std::vector<int> mel_start_;        // 起始频点
+    std::vector<int> mel_length_;       // 非零频点数
+    std::vector<size_t> mel_offset_;    // 在 mel_weights_ 中的偏移
+    std::vector<float> mel_weights_;
+    
+    std::vector<float> pending_;        // 尚未用完的采样（跨帧保留）
+    std::vector<float> mel_frames_;     // 已计算的 mel 帧（num_mels 个一组）
+    
+    // 计算缓冲区（复用，避免每帧分配）
+    std::vector<float> fft_re_;
+    std::vector<float> fft_im_;
+    std::vector<float> bins_re_;        // 实数 FFT 结果（0..N/2 频点）
+    std::vector<float> bins_im_;
+    std::vector<float> spectrum_;       // 幅度谱 / 功率谱
+    std::vector<float> mono_;           // pushFrame 混音结果
+    std::vector<float> resampled_;      // pushFrame 重采样结果
+    std::unique_ptr<Resampler> resampler_;  // 输入采样率与配置不同时创建
+};
+
+#endif /* AUDIO_PREPROCESSOR_H */
@@ -0,0 +1,86 @@
+//
+//  batch_tensor_builder.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <algorithm>
+#include <cstring>
+#include "batch_tensor_builder.h"
+#include "image_preprocessor.h"
+#include "../../common/log/log.h"
+
+static constexpr size_t kTensorAlignment = 64;
+
+BatchTensorBuilder::BatchTensorBuilder(int max_batch, int width, int height, ResizeMode mode,
+                                       const std::vector<float>& mean, const std::vector<float>& std)
+: max_batch_(std::max(1, max_batch)), width_(width), height_(height), mode_(mode), mean_(mean), std_(std),
+  sample_size_(static_cast<size_t>(3) * width * height) {
+    storage_.resize(sample_size_ * max_batch_ * sizeof(float) + kTensorAlignment - 1);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(storage_.data());
+    data_ = reinterpret_cast<float*>((address + kTensorAlignment - 1) & ~(kTensorAlignment - 1));
+    slot_valid_.assign(max_batch_, 0);
+    bgr_frames_.assign(max_batch_, nullptr);
+}
+
+BatchTensorBuilder::~BatchTensorBuilder() {
+    for (AVFrame*& frame : bgr_frames_) {
+        av_frame_free(&frame);
+    }
+}
+
+bool BatchTensorBuilder::build(const std::vector<const AVFrame*>& frames, ThreadPool* pool) {
+    if (frames.empty() || static_cast<int>(frames.size()) > max_batch_) {
+        LOG_ERROR("批量张量构建失败：帧数为 " + std::to_string(frames.size()) + "，上限 " + std::to_string(max_batch_));
+        batch_size_ = 0;
+        return false;
+    }
+    batch_size_ = static_cast<int>(frames.size());
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    workers.parallelFor(batch_size_, [this, &frames](int i) {
+        slot_valid_[i] = fillSlot(i, frames[i], nullptr) ? 1 : 0;
+        if (!slot_valid_[i]) {
+            std::memset(slot(i), 0, sample_size_ * sizeof(float));
+        }
+    });
+    return std::all_of(slot_valid_.begin(), slot_valid_.begin() + batch_size_, [](char ok) { return ok != 0; });
+}
+
+bool BatchTensorBuilder::buildFromRois(const AVFrame* frame, const std::vector<RoiRect>& rois, ThreadPool* pool) {
+    if (!frame || rois.empty() || static_cast<int>(rois.size()) > max_batch_) {
+        LOG_ERROR("批量张量构建失败：ROI 数为 " + std::to_string(rois.size()) + "，上限 " + std::to_string(max_batch_));
+        batch_size_ = 0;
+        return false;
+    }
+    batch_size_ = static_cast<int>(rois.size());
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    workers.parallelFor(batch_size_, [this, frame, &rois](int i) {
+        slot_valid_[i] = fillSlot(i, frame, &rois[i]) ? 1 : 0;
+        if (!slot_valid_[i]) {
+            std::memset(slot(i), 0, sample_size_ * sizeof(float));
+        }
+    });
+    return std::all_of(slot_valid_.begin(), slot_valid_.begin() + batch_size_, [](char ok) { return ok != 0; });
+}
+
+bool BatchTensorBuilder::fillSlot(int index, const AVFrame* frame, const RoiRect* roi) {
+    if (!frame) {
+        return false;
+    }
+    const RoiRect region = roi ? *roi : FrameConverter::displayRect(frame);
+    const AVPixelFormat fmt = static_cast<AVPixelFormat>(frame->format);
+    if (fmt == AV_PIX_FMT_YUV420P || fmt == AV_PIX_FMT_YUVJ420P || fmt == AV_PIX_FMT_NV12 || fmt == AV_PIX_FMT_NV21) {
+        return ImagePreprocessor::yuvRoiToNormalizedTensor(frame, region, slot(index), width_, height_, mode_, mean_, std_);
+    }
+    // 其余格式：转 BGR 再归一化（每个槽位独占自己的中转帧，可并行）
+    if (!bgr_frames_[index]) {
+        bgr_frames_[index] = av_frame_alloc();
+        if (!bgr_frames_[index]) {
+            return false;
+        }
+    }
+    return converter_.convertRoiToBgr(frame, region, bgr_frames_[index], width_, height_, mode_) &&
+           ImagePreprocessor::normalizeBGRFrame(bgr_frames_[index], slot(index), mean_, std_);
+}
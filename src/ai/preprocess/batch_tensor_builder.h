@@ -0,0 +1,95 @@
+//
+//  batch_tensor_builder.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef BATCH_TENSOR_BUILDER_H
+#define BATCH_TENSOR_BUILDER_H
+
+#include <vector>
+#include <memory>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include "../../util/frame/frame_converter.h"
+#include "../../util/thread/thread_pool.h"
+
+/**
+ * 批量输入张量构建：把多帧（可来自不同的流、不同尺寸/格式）写入一块预分配、64 字节对齐的连续 [N,3,H,W] 缓冲区，
+ * 直接交给 AIInfer::inferBatch
+ * 每个槽位在线程池上并行填充：YUV420P/YUVJ420P/NV12/NV21 走 ImagePreprocessor::yuvToNormalizedTensor 一遍完成，
+ * 其余格式走 FrameConverter + normalizeBGRFrame
+ */
+class BatchTensorBuilder {
+public:
+    /**
+     * @param max_batch 最大帧数（缓冲区按此预分配）
+     * @param width 模型输入宽度
+     * @param height 模型输入高度
+     * @param mode 缩放模式
+     * @param mean 各通道均值
+     * @param std 各通道标准差
+     */
+    BatchTensorBuilder(int max_batch, int width, int height, ResizeMode mode,
+                       const std::vector<float>& mean, const std::vector<float>& std);
+    ~BatchTensorBuilder();
+    
+    BatchTensorBuilder(const BatchTensorBuilder&) = delete;
+    BatchTensorBuilder& operator=(const BatchTensorBuilder&) = delete;
+    
+    /**
+     * 构建批量张量
+     * @param frames 输入帧（个数不超过 max_batch），第 i 帧写入第 i 个槽位
+     * @param pool 线程池，nullptr 使用 ThreadPool::shared()
+     * @return 全部槽位成功返回true；失败的槽位填 0，可通过 slotValid() 查询
+     */
+    bool build(const std::vector<const AVFrame*>& frames, ThreadPool* pool = nullptr);
+    
+    /**
+     * 两阶段流水线：同一帧的多个检测框一次写入批量张量，第 i 个 ROI 写入第 i 个槽位
+     * 每个框直接从源帧裁剪缩放到自己的槽位，不为每个框分配中间帧或重建缩放上下文
+     * @param frame 源帧
+     * @param rois 感兴趣区域（个数不超过 max_batch），缩放模式作用于每个 ROI
+     * @param pool 线程池，nullptr 使用 ThreadPool::shared()
+     * @return 全部槽位成功返回true；无效 ROI 的槽位填 0，可通过 slotValid() 查询
+     */
+    bool buildFromRois(const AVFrame* frame, const std::vector<RoiRect>& rois, ThreadPool* pool = nullptr);
+    
+    // 批量张量首地址（64 字节对齐），前 batchSize() 个槽位有效
+    const float* data() const { return data_; }
+    float* slot(int index) { return data_ + static_cast<size_t>(index) * sample_size_; }
+    
+    int batchSize() const { return batch_size_; }
+    int maxBatch() const { return max_batch_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    // 单帧元素个数（3 * H * W）
+    size_t sampleSize() const { return sample_size_; }
+    bool slotValid(int index) const { return index >= 0 && index < batch_size_ && slot_valid_[index] != 0; }
+    
+private:
+    // roi 为 nullptr 时处理整幅画面
+    bool fillSlot(int index, const AVFrame* frame, const RoiRect* roi);
+    
+    int max_batch_;
+    int width_;
+    int height_;
+    ResizeMode mode_;
+    std::vector<float> mean_;
+    std::vector<float> std_;
+    size_t sample_size_;
+    
+    std::vector<uint8_t> storage_;          // 多分配 63 字节用于对齐
+    float* data_ = nullptr;
+    int batch_size_ = 0;
+    std::vector<char> slot_valid_;
+    
+    FrameConverter converter_;              // 非 YUV420 系列格式的回退路径（线程安全）
+    std::vector<AVFrame*> bgr_frames_;      // 每个槽位一个 BGR 中转帧（回退路径用）
+};
+
+#endif /* BATCH_TENSOR_BUILDER_H */
@@ -6,8 +6,10 @@
 //
 
 #include <stdio.h>
+#include <algorithm>
 #include "image_preprocessor.h"
 #include "../../common/log/log.h"
+#include "../../util/frame/yuv_resize_kernel.h"
 
 
 bool ImagePreprocessor::normalizeBGRFrame(const AVFrame* bgr_frame, float* output_buf,
@@ -76,3 +78,95 @@ bool ImagePreprocessor::normalizeBGRFrame(const AVFrame* bgr_frame, float* outpu
     
     return true;
 }
+
+bool ImagePreprocessor::yuvToNormalizedTensor(const AVFrame* yuv_frame, float* output_buf, int dst_w, int dst_h,
+                                              ResizeMode mode,
+                                              const std::vector<float>& mean,
+                                              const std::vector<float>& std) {
+    if (!yuv_frame || !output_buf) {
+        LOG_ERROR("YUV归一化失败：输入帧或输出缓冲区为空");
+        return false;
+    }
+    return yuvRoiToNormalizedTensor(yuv_frame, FrameConverter::displayRect(yuv_frame), output_buf, dst_w, dst_h, mode, mean, std);
+}
+
+bool ImagePreprocessor::yuvRoiToNormalizedTensor(const AVFrame* yuv_frame, const RoiRect& roi, float* output_buf,
+                                                 int dst_w, int dst_h, ResizeMode mode,
+                                                 const std::vector<float>& mean,
+                                                 const std::vector<float>& std) {
+    if (!yuv_frame || !output_buf) {
+        LOG_ERROR("YUV归一化失败：输入帧或输出缓冲区为空");
+        return false;
+    }
+    const AVPixelFormat src_fmt = static_cast<AVPixelFormat>(yuv_frame->format);
+    if (!YuvResizeKernel::supportsFormat(src_fmt)) {
+        LOG_ERROR("YUV归一化失败：暂不支持的像素格式（仅支持YUV420P、YUVJ420P、NV12、NV21）");
+        return false;
+    }
+    if (dst_w <= 0 || dst_h <= 0 || yuv_frame->width < 2 || yuv_frame->height < 2) {
+        LOG_ERROR("YUV归一化失败：尺寸无效");
+        return false;
+    }
+    if (mean.size() < 3 || std.size() < 3 || std[0] == 0 || std[1] == 0 || std[2] == 0) {
+        LOG_ERROR("YUV归一化失败：均值/标准差参数无效");
+        return false;
+    }
+    const int rotation = DisplayRotation::fromFrame(yuv_frame);
+    const RoiRect display = FrameConverter::displayRect(yuv_frame);
+    RoiRect region;
+    if (!FrameConverter::clampRoi(roi, display.width, display.height, region)) {
+        LOG_ERROR("YUV归一化失败：ROI无效");
+        return false;
+    }
+    
+    // 1. 几何：与 FrameConverter 相同的裁剪区域和有效画面（在显示方向的 ROI 内计算，再换算到源图坐标）
+    int mid_w = dst_w, mid_h = dst_h;
+    RoiRect crop;
+    crop.width = region.width;
+    crop.height = region.height;
+    FrameConverter::calcCropResizeParams(region.width, region.height, dst_w, dst_h, mode,
+                                         crop.x, crop.y, crop.width, crop.height, mid_w, mid_h);
+    crop.x += region.x;
+    crop.y += region.y;
+    crop = FrameConverter::displayRectToSource(crop, yuv_frame->width, yuv_frame->height, rotation);
+    // 裁剪起点对齐到色度采样网格（与 FrameConverter 一致）
+    crop.x &= ~1;
+    crop.y &= ~1;
+    const int out_w = mode == ResizeMode::KEEP_BLACK ? mid_w : dst_w;
+    const int out_h = mode == ResizeMode::KEEP_BLACK ? mid_h : dst_h;
+    const int x_off = (dst_w - out_w) / 2;
+    const int y_off = (dst_h - out_h) / 2;
+    
+    // 2. 归一化系数：[0,255] → (x/255 - mean)/std
+    YuvResizeJob job;
+    for (int c = 0; c < 3; ++c) {
+        job.scale[c] = 1.0f / (255.0f * std[c]);
+        job.bias[c] = -mean[c] / std[c];
+    }
+    
+    // 3. 黑边：BGR 为 0，归一化后为 bias
+    const size_t channel_size = static_cast<size_t>(dst_w) * dst_h;
+    float* out_planes[3] = {output_buf, output_buf + channel_size, output_buf + 2 * channel_size};
+    if (mode == ResizeMode::KEEP_BLACK && (out_w != dst_w || out_h != dst_h)) {
+        for (int c = 0; c < 3; ++c) {
+            std::fill(out_planes[c], out_planes[c] + channel_size, job.bias[c]);
+        }
+    }
+    
+    // 4. 缩放 + 颜色转换 + 旋转 + 归一化一遍写入有效区域
+    job.frame = yuv_frame;
+    job.crop_x = crop.x;
+    job.crop_y = crop.y;
+    job.crop_w = crop.width;
+    job.crop_h = crop.height;
+    job.out_w = out_w;
+    job.out_h = out_h;
+    job.rotation = rotation;
+    const size_t region_offset = static_cast<size_t>(y_off) * dst_w + x_off;
+    for (int c = 0; c < 3; ++c) {
+        job.planes[c] = out_planes[c] + region_offset;
+    }
+    job.plane_stride = dst_w;
+    YuvResizeKernel::run(job);
+    return true;
+}
@@ -18,12 +18,45 @@ extern "C" {
 #include <libavdevice/avdevice.h>
 }
 
+#include "../../util/frame/frame_converter.h"
+
 class ImagePreprocessor {
 public:
     // BGR帧归一化：[0,255] → [(x/255 - mean)/std]
     static bool normalizeBGRFrame(const AVFrame* bgr_frame, float* output_buf,
                                   const std::vector<float>& mean,
                                   const std::vector<float>& std);
+    
+    /**
+     * YUV 帧一步完成裁剪/缩放/颜色转换/归一化，直接写出 NCHW 浮点张量（不经过中间 BGR 帧）
+     * 输出与 FrameConverter::convertCropResizeYuvToBgr + normalizeBGRFrame 相同：通道顺序 B、G、R，
+     * 几何由 FrameConverter::calcCropResizeParams 计算，KEEP_BLACK 的黑边为黑色归一化后的值
+     * 缩放和颜色转换由 YuvResizeKernel 完成（双线性插值，颜色矩阵按帧的 colorspace 和 color_range 选择，AVX2 运行时分发）；
+     * 帧带显示矩阵副数据时在同一遍取样中旋转到正确朝向
+     * @param yuv_frame 输入帧（YUV420P、YUVJ420P、NV12、NV21）
+     * @param output_buf 输出缓冲区（3 * dst_w * dst_h 个 float）
+     * @param dst_w 目标宽度
+     * @param dst_h 目标高度
+     * @param mode 缩放模式（STRETCH/KEEP_BLACK/CROP）
+     * @param mean 各通道均值
+     * @param std 各通道标准差
+     * @return 成功返回true
+     */
+    static bool yuvToNormalizedTensor(const AVFrame* yuv_frame, float* output_buf, int dst_w, int dst_h,
+                                      ResizeMode mode,
+                                      const std::vector<float>& mean,
+                                      const std::vector<float>& std);
+    
+    /**
+     * 只处理源图中的一个区域（检测框）：ROI 代替整幅画面作为缩放模式的输入，其余与 yuvToNormalizedTensor 相同
+     * 两阶段流水线中每个框直接写入批量张量中自己的槽位，不经过中间帧
+     * @param roi 感兴趣区域（显示方向坐标，超出画面的部分会被裁掉）
+     * @return 成功返回true；ROI 与画面没有交集或小于 2x2 时返回false
+     */
+    static bool yuvRoiToNormalizedTensor(const AVFrame* yuv_frame, const RoiRect& roi, float* output_buf,
+                                         int dst_w, int dst_h, ResizeMode mode,
+                                         const std::vector<float>& mean,
+                                         const std::vector<float>& std);
 };
 
 #endif /* IMAGE_PREPROCESSOR_H */
@@ -0,0 +1,154 @@
+//
+//  quality_gate.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include "quality_gate.h"
+#include "../util/simd/cpu_features.h"
+
+// 一行的累加量：亮度和、亮度平方和、拉普拉斯和、拉普拉斯平方和
+struct RowSums {
+    int64_t sum = 0;
+    int64_t sum_sq = 0;
+    int64_t lap = 0;
+    int64_t lap_sq = 0;
+};
+
+// 四邻域拉普拉斯：上 + 下 + 左 + 右 - 4 * 中，统计 [x_begin, x_end) 列
+static void rowStatsScalar(const uint8_t* up, const uint8_t* row, const uint8_t* down,
+                           int x_begin, int x_end, RowSums& sums) {
+    for (int x = x_begin; x < x_end; ++x) {
+        const int c = row[x];
+        const int lap = up[x] + down[x] + row[x - 1] + row[x + 1] - 4 * c;
+        sums.sum += c;
+        sums.sum_sq += c * c;
+        sums.lap += lap;
+        sums.lap_sq += lap * lap;
+    }
+}
+
+#if SIMD_X86_AVX2
+// 返回已处理到的列
+SIMD_TARGET_AVX2
+static int rowStatsAVX2(const uint8_t* up, const uint8_t* row, const uint8_t* down,
+                        int x_begin, int x_end, RowSums& sums) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    __m256i sum_sq = _mm256_setzero_si256();
+    __m256i lap_sum = _mm256_setzero_si256();
+    __m256i lap_sq = _mm256_setzero_si256();    // 每次迭代每个 32 位通道最多增加 2 * 1020^2，一行内不会溢出
+    int x = x_begin;
+    for (; x + 16 <= x_end; x += 16) {
+        const __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)));
+        const __m256i l = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x - 1)));
+        const __m256i r = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x + 1)));
+        const __m256i u = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x)));
+        const __m256i d = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x)));
+        const __m256i lap = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(u, d), _mm256_add_epi16(l, r)),
+                                             _mm256_slli_epi16(c, 2));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(c, ones));
+        sum_sq = _mm256_add_epi32(sum_sq, _mm256_madd_epi16(c, c));
+        lap_sum = _mm256_add_epi32(lap_sum, _mm256_madd_epi16(lap, ones));
+        lap_sq = _mm256_add_epi32(lap_sq, _mm256_madd_epi16(lap, lap));
+    }
+    alignas(32) int32_t lanes[4][8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), sum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), sum_sq);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), lap_sum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[3]), lap_sq);
+    for (int i = 0; i < 8; ++i) {
+        sums.sum += lanes[0][i];
+        sums.sum_sq += lanes[1][i];
+        sums.lap += lanes[2][i];
+        sums.lap_sq += static_cast<uint32_t>(lanes[3][i]);
+    }
+    return x;
+}
+#endif
+
+QualityGate::QualityGate(const QualityGateConfig& config) : config_(config) {
+    config_.row_step = std::max(1, config_.row_step);
+    use_avx2_ = CpuInfo::hasAVX2();
+}
+
+FrameQuality QualityGate::measure(const VideoFrame& frame) const {
+    FrameQuality quality;
+    const PixelFormat fmt = frame.pixelFormat();
+    const auto& data = frame.data();
+    const auto& linesize = frame.linesize();
+    const int width = frame.width();
+    const int height = frame.height();
+    const bool has_luma_plane = fmt == PixelFormat::YUV420P || fmt == PixelFormat::YUVJ420P || fmt == PixelFormat::NV12 ||
+                                fmt == PixelFormat::NV21 || fmt == PixelFormat::YUV422P || fmt == PixelFormat::YUV444P;
+    if (!has_luma_plane || data.empty() || linesize.empty() ||
+        data[0] == nullptr || width < 3 || height < 3) {
+        return quality;
+    }
+    
+    // 去掉一圈边界，保证邻域不越界
+    const uint8_t* plane = data[0];
+    const int stride = linesize[0];
+    RowSums sums;
+    int64_t count = 0;
+    for (int y = 1; y < height - 1; y += config_.row_step) {
+        const uint8_t* row = plane + static_cast<size_t>(y) * stride;
+        int x = 1;
+#if SIMD_X86_AVX2
+        if (use_avx2_) {
+            RowSums row_sums;
+            x = rowStatsAVX2(row - stride, row, row + stride, 1, width - 1, row_sums);
+            sums.sum += row_sums.sum;
+            sums.sum_sq += row_sums.sum_sq;
+            sums.lap += row_sums.lap;
+            sums.lap_sq += row_sums.lap_sq;
+        }
+#endif
+        rowStatsScalar(row - stride, row, row + stride, x, width - 1, sums);
+        count += width - 2;
+    }
+    
+    const double inv = 1.0 / static_cast<double>(count);
+    const double mean = sums.sum * inv;
+    const double lap_mean = sums.lap * inv;
+    quality.mean_luma = static_cast<float>(mean);
+    quality.contrast = static_cast<float>(std::sqrt(std::max(0.0, sums.sum_sq * inv - mean * mean)));
+    quality.sharpness = static_cast<float>(std::max(0.0, sums.lap_sq * inv - lap_mean * lap_mean));
+    quality.is_valid = true;
+    return quality;
+}
+
+bool QualityGate::shouldInfer(const VideoFrame& frame, FrameQuality* quality) {
+    const FrameQuality q = measure(frame);
+    if (quality != nullptr) {
+        *quality = q;
+    }
+    last_reject_ = QualityReject::NONE;
+    if (q.is_valid) {
+        if (q.mean_luma < config_.min_luma) {
+            last_reject_ = QualityReject::DARK;
+        } else if (q.mean_luma > config_.max_luma) {
+            last_reject_ = QualityReject::BRIGHT;
+        } else if (q.contrast < config_.min_contrast) {
+            last_reject_ = QualityReject::BLANK;
+        } else if (q.sharpness < config_.min_sharpness) {
+            last_reject_ = QualityReject::BLURRED;
+        }
+    }
+    if (last_reject_ == QualityReject::NONE) {
+        passed_count_++;
+        return true;
+    }
+    rejected_count_[static_cast<int>(last_reject_)]++;
+    return false;
+}
+
+void QualityGate::reset() {
+    last_reject_ = QualityReject::NONE;
+    passed_count_ = 0;
+    std::fill(std::begin(rejected_count_), std::end(rejected_count_), 0);
+}
@@ -0,0 +1,79 @@
+//
+//  quality_gate.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef QUALITY_GATE_H
+#define QUALITY_GATE_H
+
+#include "../common/media_frame.h"
+
+// 单帧画质指标（均在 Y 平面的采样网格上统计）
+struct FrameQuality {
+    float mean_luma = 0.0f;     // 平均亮度（0-255）
+    float contrast = 0.0f;      // 亮度标准差
+    float sharpness = 0.0f;     // 拉普拉斯响应方差（越小越模糊）
+    bool is_valid = false;      // 像素格式不支持时为 false
+};
+
+// 画质门限
+struct QualityGateConfig {
+    float min_luma = 20.0f;         // 低于此亮度视为过暗（夜间、黑场）
+    float max_luma = 240.0f;        // 高于此亮度视为过曝（白场、闪光）
+    float min_contrast = 8.0f;      // 低于此对比度视为空白画面（纯色、遮挡）
+    float min_sharpness = 20.0f;    // 低于此清晰度视为模糊（失焦、运动模糊、转场）
+    int row_step = 4;               // 每隔 row_step 行采样一行
+};
+
+// 未通过的原因
+enum class QualityReject {
+    NONE,
+    DARK,
+    BRIGHT,
+    BLANK,
+    BLURRED
+};
+
+/**
+ * 推理前的画质门控：直接在解码输出的 Y 平面上计算平均亮度、对比度和拉普拉斯清晰度，
+ * 不合格的帧跳过 FrameConverter / ImagePreprocessor / AIInfer
+ * 每行 AVX2 一次处理 16 个像素（不支持时走标量），采样行间隔由 row_step 控制
+ * 支持带 8 位 Y 平面的格式（YUV420P、YUVJ420P、NV12、NV21、YUV422P、YUV444P），其余格式一律放行
+ */
+class QualityGate {
+public:
+    explicit QualityGate(const QualityGateConfig& config = QualityGateConfig());
+    
+    /**
+     * 计算单帧画质指标（不计入统计）
+     * @param frame 解码帧
+     * @return 画质指标，格式不支持时 is_valid 为 false
+     */
+    FrameQuality measure(const VideoFrame& frame) const;
+    
+    /**
+     * 判断当前帧是否值得推理
+     * @param frame 解码帧
+     * @param quality 可选，输出本帧画质指标
+     * @return 通过返回true；未通过返回false，原因见 lastReject()
+     */
+    bool shouldInfer(const VideoFrame& frame, FrameQuality* quality = nullptr);
+    
+    QualityReject lastReject() const { return last_reject_; }
+    
+    int passedCount() const { return passed_count_; }
+    int rejectedCount(QualityReject reason) const { return rejected_count_[static_cast<int>(reason)]; }
+    
+    void reset();
+    
+private:
+    QualityGateConfig config_;
+    bool use_avx2_ = false;
+    QualityReject last_reject_ = QualityReject::NONE;
+    int passed_count_ = 0;
+    int rejected_count_[5] = {0};
+};
+
+#endif /* QUALITY_GATE_H */
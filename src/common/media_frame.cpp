@@ -14,39 +14,60 @@ extern "C" {
 #include <libavutil/avutil.h>
 #include <libavutil/frame.h>
 #include <libavutil/pixdesc.h>
+#include <libavutil/samplefmt.h>
 #include <libavutil/rational.h> // 用于时间基准转换
 }
 
 // ------------------------------
 // 像素格式转换工具
 // ------------------------------
-//PixelFormat MediaFrame::avPixelFormatToCustom(int av_fmt) {
-//    switch (av_fmt) {
-//        case AV_PIX_FMT_YUV420P:  return PixelFormat::YUV420P;
-//        case AV_PIX_FMT_BGR24:    return PixelFormat::BGR24;
-//        case AV_PIX_FMT_RGB24:    return PixelFormat::RGB24;
-//        case AV_PIX_FMT_UYVY422:  return PixelFormat::UYVY422;
-//        default:                  return PixelFormat::UNKNOWN;
-//    }
-//}
-//
-//int MediaFrame::customPixelFormatToAV(PixelFormat fmt) {
-//    switch (fmt) {
-//        case PixelFormat::YUV420P: return AV_PIX_FMT_YUV420P;
-//        case PixelFormat::BGR24:   return AV_PIX_FMT_BGR24;
-//        case PixelFormat::RGB24:   return AV_PIX_FMT_RGB24;
-//        case PixelFormat::UYVY422: return AV_PIX_FMT_UYVY422;
-//        default:                   return AV_PIX_FMT_NONE;
-//    }
-//}
+PixelFormat AVPixelFormatToPixelFormat(int av_fmt) {
+    switch (av_fmt) {
+        case AV_PIX_FMT_YUV420P:  return PixelFormat::YUV420P;
+        case AV_PIX_FMT_BGR24:    return PixelFormat::BGR24;
+        case AV_PIX_FMT_RGB24:    return PixelFormat::RGB24;
+        case AV_PIX_FMT_NV12:     return PixelFormat::NV12;
+        case AV_PIX_FMT_UYVY422:  return PixelFormat::UYVY422;
+        case AV_PIX_FMT_NV21:     return PixelFormat::NV21;
+        case AV_PIX_FMT_YUVJ420P: return PixelFormat::YUVJ420P;
+        case AV_PIX_FMT_YUV422P:  return PixelFormat::YUV422P;
+        case AV_PIX_FMT_YUV444P:  return PixelFormat::YUV444P;
+        case AV_PIX_FMT_P010LE:   return PixelFormat::P010;
+        case AV_PIX_FMT_YUV420P10LE: return PixelFormat::YUV420P10;
+        default:                  return PixelFormat::UNKNOWN;
+    }
+}
+
+int PixelFormatToAVPixelFormat(PixelFormat fmt) {
+    switch (fmt) {
+        case PixelFormat::YUV420P: return AV_PIX_FMT_YUV420P;
+        case PixelFormat::BGR24:   return AV_PIX_FMT_BGR24;
+        case PixelFormat::RGB24:   return AV_PIX_FMT_RGB24;
+        case PixelFormat::NV12:    return AV_PIX_FMT_NV12;
+        case PixelFormat::UYVY422: return AV_PIX_FMT_UYVY422;
+        case PixelFormat::NV21:    return AV_PIX_FMT_NV21;
+        case PixelFormat::YUVJ420P: return AV_PIX_FMT_YUVJ420P;
+        case PixelFormat::YUV422P: return AV_PIX_FMT_YUV422P;
+        case PixelFormat::YUV444P: return AV_PIX_FMT_YUV444P;
+        case PixelFormat::P010:    return AV_PIX_FMT_P010LE;
+        case PixelFormat::YUV420P10: return AV_PIX_FMT_YUV420P10LE;
+        default:                   return AV_PIX_FMT_NONE;
+    }
+}
 
-std::string pixelFormatToString(PixelFormat fmt) {
+std::string PixelFormatToString(PixelFormat fmt) {
     switch (fmt) {
         case PixelFormat::YUV420P: return "YUV420P";
         case PixelFormat::BGR24:   return "BGR24";
         case PixelFormat::RGB24:   return "RGB24";
         case PixelFormat::NV12:    return "NV12";
         case PixelFormat::UYVY422: return "UYVY422";
+        case PixelFormat::NV21:    return "NV21";
+        case PixelFormat::YUVJ420P: return "YUVJ420P";
+        case PixelFormat::YUV422P: return "YUV422P";
+        case PixelFormat::YUV444P: return "YUV444P";
+        case PixelFormat::P010:    return "P010";
+        case PixelFormat::YUV420P10: return "YUV420P10";
         default:                   return "UNKNOWN";
     }
 }
@@ -57,10 +78,114 @@ std::string SampleFormatToString(SampleFormat fmt) {
         case SampleFormat::FLT: return "FLT";
         case SampleFormat::S32: return "S32";
         case SampleFormat::U8:  return "U8";
+        case SampleFormat::S16P: return "S16P";
+        case SampleFormat::FLTP: return "FLTP";
+        case SampleFormat::S32P: return "S32P";
+        case SampleFormat::U8P:  return "U8P";
         default:                return "UNKNOWN";
     }
 }
 
+// ------------------------------
+// 采样格式转换工具
+// ------------------------------
+SampleFormat AVSampleFormatToSampleFormat(int av_fmt) {
+    switch (av_fmt) {
+        case AV_SAMPLE_FMT_S16:  return SampleFormat::S16;
+        case AV_SAMPLE_FMT_FLT:  return SampleFormat::FLT;
+        case AV_SAMPLE_FMT_S32:  return SampleFormat::S32;
+        case AV_SAMPLE_FMT_U8:   return SampleFormat::U8;
+        case AV_SAMPLE_FMT_S16P: return SampleFormat::S16P;
+        case AV_SAMPLE_FMT_FLTP: return SampleFormat::FLTP;
+        case AV_SAMPLE_FMT_S32P: return SampleFormat::S32P;
+        case AV_SAMPLE_FMT_U8P:  return SampleFormat::U8P;
+        default:                 return SampleFormat::UNKNOWN;
+    }
+}
+
+int SampleFormatToAVSampleFormat(SampleFormat fmt) {
+    switch (fmt) {
+        case SampleFormat::S16:  return AV_SAMPLE_FMT_S16;
+        case SampleFormat::FLT:  return AV_SAMPLE_FMT_FLT;
+        case SampleFormat::S32:  return AV_SAMPLE_FMT_S32;
+        case SampleFormat::U8:   return AV_SAMPLE_FMT_U8;
+        case SampleFormat::S16P: return AV_SAMPLE_FMT_S16P;
+        case SampleFormat::FLTP: return AV_SAMPLE_FMT_FLTP;
+        case SampleFormat::S32P: return AV_SAMPLE_FMT_S32P;
+        case SampleFormat::U8P:  return AV_SAMPLE_FMT_U8P;
+        default:                 return AV_SAMPLE_FMT_NONE;
+    }
+}
+
+int SampleFormatBytes(SampleFormat fmt) {
+    switch (fmt) {
+        case SampleFormat::U8:
+        case SampleFormat::U8P:  return 1;
+        case SampleFormat::S16:
+        case SampleFormat::S16P: return 2;
+        case SampleFormat::S32:
+        case SampleFormat::S32P:
+        case SampleFormat::FLT:
+        case SampleFormat::FLTP: return 4;
+        default:                 return 0;
+    }
+}
+
+bool SampleFormatIsPlanar(SampleFormat fmt) {
+    return fmt == SampleFormat::S16P || fmt == SampleFormat::FLTP ||
+           fmt == SampleFormat::S32P || fmt == SampleFormat::U8P;
+}
+
+VideoFrame::~VideoFrame() {
+    freeBuffer();
+    if (av_frame_) {
+        av_frame_free(&av_frame_);
+    }
+}
+
+bool VideoFrame::refAVFrame(const AVFrame* av_frame) {
+    if (!av_frame || !av_frame->buf[0]) {
+        // 非引用计数帧无法零拷贝（av_frame_ref 会退化为整帧拷贝）
+        return false;
+    }
+    freeBuffer();
+    
+    if (!av_frame_) {
+        av_frame_ = av_frame_alloc();
+        if (!av_frame_) {
+            return false;
+        }
+    }
+    if (av_frame_ref(av_frame_, av_frame) < 0) {
+        return false;
+    }
+    has_av_ref_ = true;
+    
+    // 直接暴露解码器的数据平面（不复制像素）
+    const int num_planes = av_pix_fmt_count_planes(static_cast<AVPixelFormat>(av_frame_->format));
+    for (int i = 0; i < num_planes; ++i) {
+        data_.push_back(av_frame_->data[i]);
+        linesize_.push_back(av_frame_->linesize[i]);
+    }
+    width_ = av_frame_->width;
+    height_ = av_frame_->height;
+    pix_fmt_ = AVPixelFormatToPixelFormat(av_frame_->format);
+    setShallowCopy(true);
+    return true;
+}
+
+void VideoFrame::unrefAVFrame() {
+    if (!has_av_ref_) {
+        return;
+    }
+    // 零拷贝帧的数据平面属于 AVBufferRef，unref 后指针失效
+    av_frame_unref(av_frame_);
+    has_av_ref_ = false;
+    data_.clear();
+    linesize_.clear();
+    setShallowCopy(false);
+}
+
 bool VideoFrame::allocateBuffers() {
     freeBuffer();
     
@@ -129,6 +254,10 @@ bool VideoFrame::allocateBuffers() {
 }
 
 void VideoFrame::freeBuffer() {
+    if (has_av_ref_) {
+        unrefAVFrame();
+        return;
+    }
     if (!isShallowCopy()) {
         for(uint8_t* ptr : data_) {
             delete [] ptr;
@@ -138,165 +267,103 @@ void VideoFrame::freeBuffer() {
     linesize_.clear();
 }
 
+AudioFrame::~AudioFrame() {
+    freeBuffer();
+    if (av_frame_) {
+        av_frame_free(&av_frame_);
+    }
+}
+
+const uint8_t* AudioFrame::planeData(int plane) const {
+    if (plane < 0 || plane >= planeCount()) {
+        return nullptr;
+    }
+    return planes_.empty() ? data_ : planes_[plane];
+}
+
 bool AudioFrame::allocateBuffers() {
     freeBuffer();
     
-    int bytes_per_sample = 0;
-    switch (sample_format_) {
-        case SampleFormat::S16: bytes_per_sample = 2; break;
-        case SampleFormat::S32: bytes_per_sample = 4; break;
-        case SampleFormat::FLT: bytes_per_sample = 4; break;
-        case SampleFormat::U8:  bytes_per_sample = 1; break;
-        default: return false;
+    const int bytes_per_sample = SampleFormatBytes(sample_format_);
+    if (bytes_per_sample == 0 || nb_samples_ <= 0 || channels_ <= 0) {
+        return false;
     }
     
-    data_size_ = nb_samples_ * channels_ * bytes_per_sample;
-    data_ = new (std::nothrow) uint8_t[data_size_]();
-    return data_ != nullptr;
+    // 平面格式也分配一块连续内存，各平面依次排列
+    const int total_size = nb_samples_ * channels_ * bytes_per_sample;
+    data_ = new (std::nothrow) uint8_t[total_size]();
+    if (!data_) {
+        return false;
+    }
+    if (SampleFormatIsPlanar(sample_format_)) {
+        data_size_ = nb_samples_ * bytes_per_sample;
+        for (int ch = 0; ch < channels_; ++ch) {
+            planes_.push_back(data_ + ch * data_size_);
+        }
+    } else {
+        data_size_ = total_size;
+    }
+    return true;
 }
 
 void AudioFrame::freeBuffer() {
+    if (has_av_ref_) {
+        unrefAVFrame();
+        return;
+    }
     if (!isShallowCopy() && data_) {
         delete[] data_;
-        data_ = nullptr;
-        data_size_ = 0;
     }
+    data_ = nullptr;
+    data_size_ = 0;
+    planes_.clear();
 }
 
+bool AudioFrame::refAVFrame(const AVFrame* av_frame) {
+    if (!av_frame || !av_frame->buf[0]) {
+        return false;
+    }
+    const SampleFormat fmt = AVSampleFormatToSampleFormat(av_frame->format);
+    if (fmt == SampleFormat::UNKNOWN) {
+        return false;
+    }
+    freeBuffer();
+    
+    if (!av_frame_) {
+        av_frame_ = av_frame_alloc();
+        if (!av_frame_) {
+            return false;
+        }
+    }
+    if (av_frame_ref(av_frame_, av_frame) < 0) {
+        return false;
+    }
+    has_av_ref_ = true;
+    
+    // 直接暴露解码器的采样数据（不复制）；平面数可能超过 AV_NUM_DATA_POINTERS，要用 extended_data
+    sample_format_ = fmt;
+    sample_rate_ = av_frame_->sample_rate;
+    channels_ = av_frame_->ch_layout.nb_channels;
+    nb_samples_ = av_frame_->nb_samples;
+    data_ = av_frame_->extended_data[0];
+    data_size_ = nb_samples_ * SampleFormatBytes(fmt) * (SampleFormatIsPlanar(fmt) ? 1 : channels_);
+    if (SampleFormatIsPlanar(fmt)) {
+        for (int ch = 0; ch < channels_; ++ch) {
+            planes_.push_back(av_frame_->extended_data[ch]);
+        }
+    }
+    setShallowCopy(true);
+    return true;
+}
 
-
-//std::shared_ptr<MediaFrame> MediaFrame::createFromAVFrame(AVFrame* av_frame) {
-//    if (!av_frame) {
-//        throw std::invalid_argument("createFromAVFrame failed: av_frame is null");
-//    }
-//    return std::shared_ptr<MediaFrame>(new MediaFrame(av_frame));
-//}
-//
-//std::shared_ptr<MediaFrame> MediaFrame::createEmpty(int width, int height, PixelFormat fmt) {
-//    if (width <= 0 || height <= 0) {
-//        throw std::invalid_argument("MediaFrame createEmpty failed: width or height <= 0");
-//    }
-//
-//    if (fmt == PixelFormat::UNKNOWN) {
-//        throw std::invalid_argument("createEmpty failed: unknown pixel format");
-//    }
-//
-//    return std::shared_ptr<MediaFrame>(new MediaFrame(width,height,fmt));
-//
-//}
-//
-//MediaFrame::MediaFrame(AVFrame* av_frame):av_frame_(av_frame) {
-//    if (!av_frame_) {
-//        throw std::invalid_argument("MediaFrame constructor failed: av_frame is null");
-//    }
-//    // 提取基础属性
-//    width_ = av_frame_->width;
-//    height_ = av_frame_->height;
-//    format_ = avPixelFormatToCustom(av_frame_->format);
-//    pts_ = av_frame->pts; // 初始化为 AVFrame 的 PTS
-//
-//    // 初始化数据指针
-//    initDataPointers();
-//}
-//
-//MediaFrame::MediaFrame(int width, int height, PixelFormat fmt):width_(width),height_(height),format_(fmt) {
-//    av_frame_ = av_frame_alloc();
-//    if(!av_frame_) {
-//        throw std::bad_alloc();
-//    }
-//
-//    av_frame_->width = width_;
-//    av_frame_->height = height_;
-//    av_frame_->format = customPixelFormatToAV(fmt);
-//
-//    int ret = av_frame_get_buffer(av_frame_,32);
-//    if (ret < 0) {
-//        av_frame_free(&av_frame_);
-//        throw std::runtime_error("av_frame_get_buffer failed: " + std::string(av_err2str(ret)));
-//    }
-//
-//    // 初始化数据指针
-//    initDataPointers();
-//}
-//
-//MediaFrame::~MediaFrame() {
-//    releaseResources();
-//}
-//
-//MediaFrame::MediaFrame(MediaFrame&& other) noexcept :
-//width_(other.width_),
-//height_(other.height_),
-//format_(other.format_),
-//pts_(other.pts_),
-//pts_ms_(other.pts_ms_),
-//time_base_num_(other.time_base_num_),
-//time_base_den_(other.time_base_den_),
-//data_(std::move(other.data_)),
-//linesize_(std::move(other.linesize_)),
-//av_frame_(other.av_frame_) {
-//    other.av_frame_ = nullptr;
-//}
-//
-//MediaFrame& MediaFrame::operator=(MediaFrame&& other) noexcept {
-//    if (this != &other) {
-//        // 销毁原始数据
-//        releaseResources();
-//
-//        // 赋值新的数据
-//        width_ = other.width_;
-//        height_ = other.height_;
-//        format_ = other.format_;
-//        pts_ = other.pts_;
-//        pts_ms_ = other.pts_ms_;
-//        time_base_num_ = other.time_base_num_;
-//        time_base_den_ = other.time_base_den_;
-//        data_ = std::move(other.data_);
-//        linesize_ = std::move(other.linesize_);
-//        av_frame_ = other.av_frame_;
-//
-//        other.av_frame_ = nullptr;
-//    }
-//    return *this;
-//}
-//
-//
-//void MediaFrame::initDataPointers() {
-//    if (!av_frame_) return;
-//
-//    // 初始化数据指针和行字节数（最多4个平面，覆盖绝大多数格式）
-//    int num_planes = av_pix_fmt_count_planes((AVPixelFormat)av_frame_->format);
-//    data_.resize(num_planes);
-//    linesize_.resize(num_planes);
-//    for (int i = 0; i < num_planes; ++i) {
-//        data_[i] = av_frame_->data[i];
-//        linesize_[i] = av_frame_->linesize[i];
-//    }
-//}
-//
-//void MediaFrame::releaseResources() {
-//    if (av_frame_) {
-//        av_frame_free(&av_frame_); // 调用FFmpeg的释放函数（安全释放）
-//        av_frame_ = nullptr;
-//    }
-//}
-//
-//void MediaFrame::setTimeBase(int num, int den) {
-//    if (den <= 0) {
-//        throw std::invalid_argument("setTimeBase failed: denominator must be positive");
-//    }
-//    time_base_num_ = num;
-//    time_base_den_ = den;
-//
-//    // 如果已设置PTS，同步更新毫秒值
-//    if (pts_ != -1) {
-//        setPts(pts_);
-//    }
-//}
-//
-//void MediaFrame::setPts(int64_t pts) {
-//    pts_ = pts;
-//    // 转换PTS为毫秒（使用FFmpeg的时间基准转换函数）
-//    AVRational src_tb = {time_base_num_, time_base_den_}; // 源时间基准（流的time_base）
-//    AVRational dst_tb = {1, 1000};                        // 目标时间基准（1/1000秒 = 毫秒）
-//    pts_ms_ = av_rescale_q(pts_, src_tb, dst_tb);
-//}
+void AudioFrame::unrefAVFrame() {
+    if (!has_av_ref_) {
+        return;
+    }
+    av_frame_unref(av_frame_);
+    has_av_ref_ = false;
+    data_ = nullptr;
+    data_size_ = 0;
+    planes_.clear();
+    setShallowCopy(false);
+}
@@ -12,6 +12,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <sstream>
 
 struct AVFrame;
 
@@ -29,7 +30,13 @@ enum class PixelFormat {
     BGR24,     // 适合渲染/UI的BGR格式（24位）
     RGB24,     // 适合AI模型的RGB格式（24位）
     NV12,
-    UYVY422    // 可能用于摄像头输入的YUV422格式
+    UYVY422,   // 可能用于摄像头输入的YUV422格式
+    NV21,      // Android 摄像头常见的 YUV420 半平面格式（VU 交错）
+    YUVJ420P,  // 全范围（0-255）YUV420P，MJPEG/JPEG 来源的视频
+    YUV422P,
+    YUV444P,
+    P010,      // 10 位半平面 YUV420（小端，有效位在高 10 位），硬件解码 10 位 HEVC 的输出
+    YUV420P10  // 10 位平面 YUV420（小端，有效位在低 10 位），软件解码 10 位 HEVC 的输出
 };
 
 // 采样格式（音频）
@@ -38,7 +45,11 @@ enum class SampleFormat {
     S16,        // 16位有符号整数
     FLT,        // 32位浮点数
     S32,        // 32位有符号整数
-    U8          // 8位无符号整数
+    U8,         // 8位无符号整数
+    S16P,       // 以下为平面格式（每个声道一个平面），AAC/Opus 等解码器的常见输出
+    FLTP,
+    S32P,
+    U8P
 };
 
 /**
@@ -55,6 +66,40 @@ std::string PixelFormatToString(PixelFormat fmt);
  */
 std::string SampleFormatToString(SampleFormat fmt);
 
+/**
+ * FFmpeg 像素格式（AVPixelFormat）转自定义像素格式
+ * @param av_fmt AVPixelFormat 枚举值
+ * @return 自定义像素格式，不支持时返回 UNKNOWN
+ */
+PixelFormat AVPixelFormatToPixelFormat(int av_fmt);
+
+/**
+ * 自定义像素格式转 FFmpeg 像素格式
+ * @param fmt 自定义像素格式
+ * @return AVPixelFormat 枚举值，不支持时返回 AV_PIX_FMT_NONE
+ */
+int PixelFormatToAVPixelFormat(PixelFormat fmt);
+
+/**
+ * FFmpeg 采样格式（AVSampleFormat）转自定义采样格式
+ * @param av_fmt AVSampleFormat 枚举值
+ * @return 自定义采样格式，不支持时返回 UNKNOWN
+ */
+SampleFormat AVSampleFormatToSampleFormat(int av_fmt);
+
+/**
+ * 自定义采样格式转 FFmpeg 采样格式
+ * @param fmt 自定义采样格式
+ * @return AVSampleFormat 枚举值，不支持时返回 AV_SAMPLE_FMT_NONE
+ */
+int SampleFormatToAVSampleFormat(SampleFormat fmt);
+
+// 每个采样的字节数，UNKNOWN 返回 0
+int SampleFormatBytes(SampleFormat fmt);
+
+// 是否为平面格式
+bool SampleFormatIsPlanar(SampleFormat fmt);
+
 class MediaFrame {
 public:
     using Ptr = std::shared_ptr<MediaFrame>;
@@ -105,40 +150,62 @@ class VideoFrame : public MediaFrame {
 public:
     using Ptr = std::shared_ptr<VideoFrame>;
     /**
-     * 从FFmpeg的AVFrame创建MediaFrame（核心工厂方法）
-     * @param av_frame FFmpeg解码得到的AVFrame（所有权将被接管）
-     * @return 共享指针包装的MediaFrame实例
-     * @note 调用者无需手动释放av_frame，由MediaFrame内部管理
+     * 创建空的视频帧（不分配缓冲区）
+     * @note 深拷贝时调用 allocateBuffers() 分配自有缓冲区，
+     *       零拷贝时调用 refAVFrame() 引用解码器输出的缓冲区
      */
     static Ptr create(int width, int height, PixelFormat fmt) {
-        return std::make_shared<VideoFrame>(width,height,fmt);
+        return Ptr(new VideoFrame(width,height,fmt));
     }
     
+    ~VideoFrame() override;
+    
     int width() const { return  width_;}
     int height() const { return height_;}
     PixelFormat pixelFormat() const {return pix_fmt_;}
     const std::vector<uint8_t*>& data() const {return data_;}
     const std::vector<int>& linesize() const {return linesize_;}
     
+    // 零拷贝模式下持有的 AVFrame（可直接交给 FrameConverter），否则为 nullptr
+    const AVFrame* avFrame() const { return has_av_ref_ ? av_frame_ : nullptr;}
+    
+    /**
+     * 运动量：码流运动矢量的平均位移（像素/帧，按块面积加权，整帧平均）
+     * @return 帧内编码帧（I 帧）或帧上没有运动矢量副数据（解码器不支持导出、硬件解码、全帧内编码的 P 帧）返回 -1
+     */
+    float motionScore() const { return motion_score_;}
+    void setMotionScore(float score) { motion_score_ = score;}
+    
     // 属性设置
     void setWidth(int width) { width_ = width;}
     void setHeight(int height) { height_ = height;}
     void setPixelFormat(PixelFormat fmt) {pix_fmt_ = fmt;}
-    void setData(const std::vector<uint8_t*>& data, const std::vecotr<int>& linesize) {
+    void setData(const std::vector<uint8_t*>& data, const std::vector<int>& linesize) {
         data_ = data;
         linesize_ = linesize;
     }
     
+    /**
+     * 零拷贝引用 AVFrame 的数据平面（av_frame_ref，只增加 AVBufferRef 引用计数，不复制像素）
+     * @param av_frame 解码得到的 AVFrame（必须是引用计数帧，调用后仍归调用者所有）
+     * @return 成功返回true
+     * @note 之前持有的缓冲区会先释放；帧析构或归还帧池时自动 unref
+     */
+    bool refAVFrame(const AVFrame* av_frame);
+    
+    // 释放对 AVFrame 缓冲区的引用（归还帧池时调用，深拷贝缓冲区保留以便复用）
+    void unrefAVFrame();
+    
     // 分配视频缓冲区（深拷贝时用）
     bool allocateBuffers();
     
-    // 释放缓冲区（深拷贝自有数据）
+    // 释放缓冲区（深拷贝自有数据 / 零拷贝引用）
     void freeBuffer();
     
     std::string debugInfo() const override {
         std::stringstream ss;
         ss << "VideoFrame: "
-        << "stream=" << stream_index() << ", "
+        << "stream=" << streamIndex() << ", "
         << "w=" << width_ << ", h=" << height_ << ", "
         << "fmt=" << PixelFormatToString(pix_fmt_) << ", "
         << "pts=" << pts() << ", dts=" << dts() << ", "
@@ -153,6 +220,9 @@ private:
     PixelFormat pix_fmt_ = PixelFormat::UNKNOWN;
     std::vector<uint8_t*>data_;  //数据平面指针
     std::vector<int>linesize_;  //每行字节数
+    AVFrame* av_frame_ = nullptr; //零拷贝时引用的 AVFrame（结构体随帧复用，只 unref 不释放）
+    bool has_av_ref_ = false;     //av_frame_ 当前是否持有缓冲区引用
+    float motion_score_ = -1.0f;  //运动量（-1 表示未知）
 };
 
 
@@ -161,16 +231,24 @@ public:
     using Ptr = std::shared_ptr<AudioFrame>;
     
     static Ptr create(int sample_rate, int channels, SampleFormat fmt, int nb_samples) {
-        return std::make_shared<AudioFrame>(sample_rate,channels,fmt,nb_samples);
+        return Ptr(new AudioFrame(sample_rate,channels,fmt,nb_samples));
     };
     
+    ~AudioFrame() override;
+    
     //属性访问
     int sampleRate() const { return sample_rate_;}
     int channels() const { return channels_;}
     SampleFormat sampleFormat() const { return sample_format_;}
     int nbSamples() const { return nb_samples_;}
+    // 第一个平面的数据（交错格式即全部数据）
     const uint8_t* data() const { return data_;}
+    // 每个平面的字节数（交错格式即全部数据大小）
     const int dataSize() const { return data_size_;}
+    // 平面个数：平面格式等于声道数，交错格式为 1
+    int planeCount() const { return SampleFormatIsPlanar(sample_format_) ? channels_ : 1;}
+    // 第 plane 个平面的数据，越界返回 nullptr
+    const uint8_t* planeData(int plane) const;
     
     // 设置对应值
     void setSampleRate(int rate) { sample_rate_ = rate;}
@@ -189,6 +267,19 @@ public:
     // 释放缓冲区（深拷贝自有数据）
     void freeBuffer();
     
+    /**
+     * 零拷贝引用解码器输出的 AVFrame（av_frame_ref，不复制采样数据）
+     * @param av_frame 解码得到的音频帧（必须是引用计数帧）
+     * @return 成功返回true；采样格式不支持或非引用计数帧返回false
+     */
+    bool refAVFrame(const AVFrame* av_frame);
+    
+    // 释放对 AVFrame 的引用（归还帧池时调用）
+    void unrefAVFrame();
+    
+    // 引用的 AVFrame（未引用时返回 nullptr）
+    const AVFrame* avFrame() const { return has_av_ref_ ? av_frame_ : nullptr;}
+    
     // 调试信息
     std::string debugInfo() const override {
         std::stringstream ss;
@@ -211,6 +302,12 @@ private:
     int nb_samples_ = 0;        // 每帧采样数
     uint8_t* data_ = nullptr;    // 音频数据大小（线性缓冲）
     int data_size_ = 0;          // 数据大小（字节）
+    std::vector<uint8_t*> planes_;  // 各平面起始地址（平面格式时有效）
     
+    AVFrame* av_frame_ = nullptr;   // 零拷贝时持有的 AVFrame 引用（复用，避免反复分配）
+    bool has_av_ref_ = false;
 };
+
+using MediaFramePtr = MediaFrame::Ptr;
+
 #endif /* MEDIA_FRAME_H */
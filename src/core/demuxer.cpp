@@ -0,0 +1,405 @@
+//
+//  demuxer.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include "demuxer.h"
+#include "../common/log/log.h"
+
+Demuxer::Demuxer(PlayerContext& ctx) : ctx_(ctx) {
+}
+
+Demuxer::~Demuxer() {
+    close();
+}
+
+bool Demuxer::open(const std::string& file_path) {
+    close();
+    if (file_path.empty()) {
+        error_msg_ = "文件路径为空！！！";
+        return false;
+    }
+    if (mmap_io_enabled_) {
+        io_ = std::make_unique<MediaIO>();
+        if (!io_->openFile(file_path)) {
+            // mmap 不可用时回退到 avformat 自带的文件读取
+            LOG_WARN("mmap 读取不可用，使用默认文件读取：" + io_->getErrorMsg());
+            io_.reset();
+        }
+    }
+    // 旁路索引有效时指定容器格式，跳过格式探测
+    bool use_index = seek_index_enabled_ && seek_index_.load(file_path);
+    const AVInputFormat* input_format = use_index ? av_find_input_format(seek_index_.formatName()) : nullptr;
+    if (!openInput(file_path.c_str(), input_format)) {
+        seek_index_.reset();
+        return false;
+    }
+    use_index = use_index && seek_index_.applyTo(ctx_.format_ctx);
+    if (!use_index) {
+        seek_index_.reset();
+        // 获取流信息（必须调用，否则无法找到视频流）
+        int ret = avformat_find_stream_info(ctx_.format_ctx, nullptr);
+        if (ret < 0) {
+            error_msg_ = "获取流信息失效：" + std::string(av_err2str(ret));
+            close();
+            return false;
+        }
+        if (seek_index_enabled_) {
+            // 生成旁路索引供下次打开使用；写盘失败只影响下次的打开速度
+            const int video_index = findStream(AVMEDIA_TYPE_VIDEO);
+            if (video_index >= 0) {
+                seek_index_.build(ctx_.format_ctx, video_index, file_path);
+            }
+        }
+    }
+    
+    discardAllStreams();
+    file_path_ = file_path;
+    ctx_.is_valid = true;
+    return true;
+}
+
+bool Demuxer::openBuffer(const uint8_t* data, size_t size) {
+    close();
+    io_ = std::make_unique<MediaIO>();
+    if (!io_->openBuffer(data, size)) {
+        error_msg_ = io_->getErrorMsg();
+        io_.reset();
+        return false;
+    }
+    // 没有文件名，完全依靠内容探测格式
+    if (!openInput(nullptr, nullptr)) {
+        return false;
+    }
+    int ret = avformat_find_stream_info(ctx_.format_ctx, nullptr);
+    if (ret < 0) {
+        error_msg_ = "获取流信息失效：" + std::string(av_err2str(ret));
+        close();
+        return false;
+    }
+    discardAllStreams();
+    ctx_.is_valid = true;
+    return true;
+}
+
+bool Demuxer::openInput(const char* url, const AVInputFormat* input_format) {
+    if (io_) {
+        // 自定义 IO：AVFormatContext 需要预先分配，avformat_close_input 不会释放 pb
+        ctx_.format_ctx = avformat_alloc_context();
+        if (!ctx_.format_ctx) {
+            error_msg_ = "AVFormatContext 内存分配失败";
+            io_.reset();
+            return false;
+        }
+        ctx_.format_ctx->pb = io_->avioContext();
+        ctx_.format_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+    // 失败时 avformat_open_input 会释放 format_ctx 并置空
+    int ret = avformat_open_input(&ctx_.format_ctx, url, input_format, nullptr);
+    if (ret != 0) {
+        error_msg_ = "打开文件失败："+std::string(av_err2str(ret));
+        io_.reset();
+        return false;
+    }
+    return true;
+}
+
+void Demuxer::discardAllStreams() {
+    // 默认丢弃所有流，只有被订阅的流才会被读出
+    for (unsigned int i = 0; i < ctx_.format_ctx->nb_streams; i++) {
+        ctx_.format_ctx->streams[i]->discard = AVDISCARD_ALL;
+    }
+}
+
+void Demuxer::close() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_.clear();
+    }
+    if (ctx_.format_ctx) {
+        avformat_close_input(&ctx_.format_ctx);
+        ctx_.format_ctx = nullptr;
+    }
+    // 自定义 IO 在 AVFormatContext 关闭之后释放
+    io_.reset();
+    seek_index_.reset();
+    file_path_.clear();
+}
+
+int Demuxer::findStream(AVMediaType type) const {
+    if (!ctx_.format_ctx) {
+        return -1;
+    }
+    int index = av_find_best_stream(ctx_.format_ctx, type, -1, -1, nullptr, 0);
+    return index < 0 ? -1 : index;
+}
+
+PacketQueue* Demuxer::subscribe(int stream_index, size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ctx_.format_ctx || stream_index < 0 || stream_index >= static_cast<int>(ctx_.format_ctx->nb_streams)) {
+        error_msg_ = "订阅失败：流索引无效（" + std::to_string(stream_index) + "）";
+        return nullptr;
+    }
+    auto& queue = queues_[stream_index];
+    if (!queue) {
+        queue = std::make_unique<PacketQueue>(capacity);
+    } else {
+        // 重新订阅：之前 unsubscribe()/stop() 中止过的队列恢复可用，并丢掉残留的数据包
+        queue->reset();
+    }
+    ctx_.format_ctx->streams[stream_index]->discard = AVDISCARD_DEFAULT;
+    return queue.get();
+}
+
+void Demuxer::unsubscribe(int stream_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(stream_index);
+    if (it == queues_.end()) {
+        return;
+    }
+    // 只中止不删除：消费者可能还持有队列指针
+    it->second->abort();
+    if (ctx_.format_ctx) {
+        ctx_.format_ctx->streams[stream_index]->discard = AVDISCARD_ALL;
+    }
+}
+
+bool Demuxer::start() {
+    // 视频、音频解码线程可能同时调用：检查和启动必须是一个原子操作
+    std::lock_guard<std::mutex> start_lock(start_mutex_);
+    if (!ctx_.format_ctx) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_msg_ = "启动解复用线程失败：文件未打开";
+        return false;
+    }
+    if (running_) {
+        return true;
+    }
+    // 线程可能已经自行退出（如数据包分配失败），先回收再重新启动
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    {
+        // stop() 中止了所有队列：已订阅流的队列恢复可用，否则重启后消费者会立即读到结束
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& item : queues_) {
+            if (ctx_.format_ctx->streams[item.first]->discard != AVDISCARD_ALL) {
+                item.second->reset();
+            }
+        }
+    }
+    running_ = true;
+    thread_ = std::thread(&Demuxer::demuxLoop, this);
+    return true;
+}
+
+void Demuxer::stop() {
+    std::lock_guard<std::mutex> start_lock(start_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(seek_mutex_);
+        running_ = false;
+    }
+    seek_cv_.notify_all();
+    {
+        // 唤醒阻塞在 push 上的解复用线程和阻塞在 pop 上的解码线程
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& item : queues_) {
+            item.second->abort();
+        }
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool Demuxer::seek(int stream_index, int64_t timestamp, int flags) {
+    if (!ctx_.format_ctx) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_msg_ = "跳转失败：文件未打开";
+        return false;
+    }
+    if (!running_) {
+        // 线程未启动：直接在调用线程跳转
+        return doSeek(stream_index, timestamp, flags) >= 0;
+    }
+    
+    std::unique_lock<std::mutex> lock(seek_mutex_);
+    seek_requested_ = true;
+    seek_stream_ = stream_index;
+    seek_ts_ = timestamp;
+    seek_flags_ = flags;
+    // 持锁清空队列：唤醒可能阻塞在 push 上的解复用线程，
+    // 同时保证解复用线程执行跳转之前清空已经完成，不会误删跳转后的新数据包
+    clearQueues();
+    seek_cv_.notify_all();
+    seek_cv_.wait(lock, [this] { return !seek_requested_ || !running_; });
+    return !seek_requested_ && seek_result_ >= 0;
+}
+
+int64_t Demuxer::keyframeBefore(int stream_index, int64_t timestamp) const {
+    if (!ctx_.format_ctx || stream_index < 0 || stream_index >= static_cast<int>(ctx_.format_ctx->nb_streams)) {
+        return AV_NOPTS_VALUE;
+    }
+    if (seek_index_.isLoaded() && stream_index == seek_index_.streamIndex()) {
+        const SeekIndex::KeyframeEntry* keyframe = seek_index_.keyframeBefore(timestamp);
+        return keyframe ? keyframe->dts : AV_NOPTS_VALUE;
+    }
+    const AVIndexEntry* entry = avformat_index_get_entry_from_timestamp(ctx_.format_ctx->streams[stream_index],
+                                                                        timestamp, AVSEEK_FLAG_BACKWARD);
+    return entry ? entry->timestamp : AV_NOPTS_VALUE;
+}
+
+std::vector<int64_t> Demuxer::keyframeTimestamps(int stream_index) const {
+    std::vector<int64_t> keyframes;
+    if (!ctx_.format_ctx || stream_index < 0 || stream_index >= static_cast<int>(ctx_.format_ctx->nb_streams)) {
+        return keyframes;
+    }
+    if (seek_index_.isLoaded() && stream_index == seek_index_.streamIndex()) {
+        const SeekIndex::KeyframeEntry* entries = seek_index_.keyframes();
+        for (size_t i = 0; i < seek_index_.keyframeCount(); ++i) {
+            keyframes.push_back(entries[i].dts);
+        }
+        return keyframes;
+    }
+    AVStream* stream = ctx_.format_ctx->streams[stream_index];
+    const int count = avformat_index_get_entries_count(stream);
+    for (int i = 0; i < count; ++i) {
+        const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME)) {
+            keyframes.push_back(entry->timestamp);
+        }
+    }
+    return keyframes;
+}
+
+int64_t Demuxer::readKeyframePts(int stream_index, int64_t keyframe_dts) {
+    if (running_ || !ctx_.format_ctx || stream_index < 0 || stream_index >= static_cast<int>(ctx_.format_ctx->nb_streams)) {
+        return AV_NOPTS_VALUE;
+    }
+    if (av_seek_frame(ctx_.format_ctx, stream_index, keyframe_dts, AVSEEK_FLAG_BACKWARD) < 0) {
+        return AV_NOPTS_VALUE;
+    }
+    // 临时放开该流，读到目标关键帧为止（seek 可能落在更早的关键帧上）
+    AVStream* stream = ctx_.format_ctx->streams[stream_index];
+    const AVDiscard discard = stream->discard;
+    stream->discard = AVDISCARD_DEFAULT;
+    int64_t pts = AV_NOPTS_VALUE;
+    PacketPtr packet(av_packet_alloc());
+    while (packet && av_read_frame(ctx_.format_ctx, packet.get()) >= 0) {
+        const bool is_target = packet->stream_index == stream_index;
+        const int64_t dts = packet->dts;
+        if (is_target && dts == keyframe_dts && (packet->flags & AV_PKT_FLAG_KEY)) {
+            pts = packet->pts;
+        }
+        av_packet_unref(packet.get());
+        if (pts != AV_NOPTS_VALUE || (is_target && dts != AV_NOPTS_VALUE && dts > keyframe_dts)) {
+            break;
+        }
+    }
+    stream->discard = discard;
+    return pts;
+}
+
+int Demuxer::doSeek(int stream_index, int64_t timestamp, int flags) {
+    int ret = av_seek_frame(ctx_.format_ctx, stream_index, timestamp, flags);
+    if (ret < 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_msg_ = "跳转失败：" + std::string(av_err2str(ret));
+        LOG_ERROR(error_msg_);
+    }
+    // 丢弃跳转前已经入队的数据包
+    clearQueues();
+    return ret;
+}
+
+void Demuxer::clearQueues() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : queues_) {
+        item.second->clear();
+    }
+}
+
+std::string Demuxer::getErrorMsg() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_msg_;
+}
+
+PacketQueue* Demuxer::findQueue(int stream_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(stream_index);
+    return it == queues_.end() ? nullptr : it->second.get();
+}
+
+void Demuxer::demuxLoop() {
+    while (running_) {
+        {
+            // 处理跳转请求；读到末尾后在这里等待跳转或停止
+            std::unique_lock<std::mutex> lock(seek_mutex_);
+            if (eof_ && !seek_requested_) {
+                seek_cv_.wait(lock, [this] { return !running_ || seek_requested_; });
+            }
+            if (!running_) {
+                break;
+            }
+            if (seek_requested_) {
+                seek_result_ = doSeek(seek_stream_, seek_ts_, seek_flags_);
+                seek_requested_ = false;
+                eof_ = false;
+                seek_cv_.notify_all();
+            }
+        }
+        
+        PacketPtr packet(av_packet_alloc());
+        if (!packet) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_msg_ = "AVPacket 内存分配失败";
+                LOG_ERROR(error_msg_);
+            }
+            std::lock_guard<std::mutex> lock(seek_mutex_);
+            running_ = false;
+            seek_cv_.notify_all();
+            break;
+        }
+        
+        int ret = av_read_frame(ctx_.format_ctx, packet.get());
+        if (ret == AVERROR(EAGAIN)) {
+            // 设备输入暂时没有数据
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (ret < 0) {
+            if (ret != AVERROR_EOF) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_msg_ = "读取数据包失败：" + std::string(av_err2str(ret));
+                LOG_ERROR(error_msg_);
+            }
+            // 读取完毕或者出错：向所有队列发送结束标记（空包），解码器据此 flush
+            std::vector<PacketQueue*> queues;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto& item : queues_) {
+                    queues.push_back(item.second.get());
+                }
+            }
+            for (PacketQueue* queue : queues) {
+                queue->push(nullptr);
+            }
+            std::lock_guard<std::mutex> lock(seek_mutex_);
+            eof_ = true;
+            continue;
+        }
+        
+        PacketQueue* queue = findQueue(packet->stream_index);
+        if (!queue) {
+            // 未订阅的流（AVDISCARD_ALL 下一般不会读到）
+            continue;
+        }
+        // 队列满时阻塞，形成背压；stop() 中止队列、seek() 清空队列都会使其返回
+        queue->push(std::move(packet));
+    }
+}
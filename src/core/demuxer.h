@@ -0,0 +1,161 @@
+//
+//  demuxer.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef DEMUXER_H
+#define DEMUXER_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#include "player.h"
+#include "../decoder/codec_utils.h"
+#include "../decoder/seek_index.h"
+#include "../decoder/media_io.h"
+
+/**
+ * 解复用器：独立线程读取文件，把数据包分发到各个流的有界队列
+ * 拥有 PlayerContext 中的 AVFormatContext；未订阅的流设置 AVDISCARD_ALL，不会被读出
+ * 用法：open() -> subscribe() 各个需要的流 -> start()，解码器在自己的线程里从队列取包
+ */
+class Demuxer {
+public:
+    static constexpr size_t kDefaultQueueCapacity = 64;
+    
+    explicit Demuxer(PlayerContext& ctx);
+    ~Demuxer();
+    
+    Demuxer(const Demuxer&) = delete;
+    Demuxer& operator=(const Demuxer&) = delete;
+    
+    // 打开文件并读取流信息，所有流默认不订阅（AVDISCARD_ALL）
+    bool open(const std::string& file_path);
+    
+    // 当前打开的文件路径（未打开或从内存缓冲区打开时为空）
+    const std::string& filePath() const { return file_path_; }
+    
+    /**
+     * 启用旁路索引（需在 open() 之前调用，默认关闭）
+     * 启用后首次打开生成 <文件>.idx，之后打开时跳过格式探测和 avformat_find_stream_info，
+     * 关键帧查找走 mmap 的索引表
+     */
+    void setSeekIndexEnabled(bool enabled) { seek_index_enabled_ = enabled; }
+    
+    // 本地文件使用 mmap 读取（需在 open() 之前调用，默认关闭；不支持的平台自动回退）
+    void setMmapIOEnabled(bool enabled) { mmap_io_enabled_ = enabled; }
+    
+    /**
+     * 从内存缓冲区打开（不写临时文件）
+     * @param data 完整的媒体文件数据，调用者持有，必须在 close() 之前保持有效
+     * @param size 数据大小
+     * @return 成功返回true
+     * @note 内存输入不支持旁路索引
+     */
+    bool openBuffer(const uint8_t* data, size_t size);
+    
+    // 停止线程并关闭文件
+    void close();
+    
+    /**
+     * 查找指定类型的最佳流
+     * @return 流索引，找不到返回 -1
+     */
+    int findStream(AVMediaType type) const;
+    
+    /**
+     * 订阅流：为该流创建有界数据包队列（需在 start() 之前调用）
+     * @param stream_index 流索引
+     * @param capacity 队列容量（数据包个数），队列满时解复用线程阻塞
+     * @return 该流的数据包队列，生命周期由 Demuxer 管理；失败返回 nullptr
+     */
+    PacketQueue* subscribe(int stream_index, size_t capacity = kDefaultQueueCapacity);
+    
+    // 取消订阅（恢复 AVDISCARD_ALL，并中止该流的队列；再次 subscribe() 时队列被清空并恢复可用）
+    void unsubscribe(int stream_index);
+    
+    // 启动解复用线程（重复调用无副作用）；stop() 之后再次启动会恢复已订阅流的队列
+    bool start();
+    
+    // 停止解复用线程，中止所有队列
+    void stop();
+    
+    /**
+     * 跳转（线程安全，阻塞到跳转完成）
+     * @param stream_index 时间戳所属的流
+     * @param timestamp 目标时间戳（该流的 time_base）
+     * @param flags av_seek_frame 标志，默认 AVSEEK_FLAG_BACKWARD（落在目标之前最近的关键帧）
+     * @return 成功返回true
+     * @note 所有队列中跳转前的数据包会被清空，订阅者需要自行 flush 解码器；
+     *       读到文件末尾后线程不会退出，仍然可以跳转
+     */
+    bool seek(int stream_index, int64_t timestamp, int flags = AVSEEK_FLAG_BACKWARD);
+    
+    /**
+     * 查找 timestamp 之前（含）最近的关键帧（基于容器索引，不读文件）
+     * @return 关键帧的 dts（容器索引时间戳，有 B 帧时早于其 pts），容器没有索引时返回 AV_NOPTS_VALUE
+     */
+    int64_t keyframeBefore(int stream_index, int64_t timestamp) const;
+    
+    // 容器索引中该流所有关键帧的 dts（升序），没有索引时为空
+    std::vector<int64_t> keyframeTimestamps(int stream_index) const;
+    
+    /**
+     * 读出关键帧数据包的真实 pts（有 B 帧时 pts = dts + 合成时间偏移，索引里只有 dts）
+     * @param stream_index 流索引
+     * @param keyframe_dts keyframeTimestamps() 返回的关键帧 dts
+     * @return 关键帧 pts，失败返回 AV_NOPTS_VALUE
+     * @note 会移动读取位置，只能在解复用线程启动之前调用；调用后需要重新 seek
+     */
+    int64_t readKeyframePts(int stream_index, int64_t keyframe_dts);
+    
+    bool isRunning() const { return running_;}
+    std::string getErrorMsg();
+    
+private:
+    void demuxLoop();
+    // 打开输入（有自定义 IO 时挂到 AVFormatContext::pb 上）
+    bool openInput(const char* url, const AVInputFormat* input_format);
+    void discardAllStreams();
+    PacketQueue* findQueue(int stream_index);
+    int doSeek(int stream_index, int64_t timestamp, int flags);
+    void clearQueues();
+    
+    PlayerContext& ctx_;
+    std::unordered_map<int, std::unique_ptr<PacketQueue>> queues_; // 流索引 -> 数据包队列
+    std::mutex mutex_;              // 保护 queues_ 和 error_msg_
+    std::mutex start_mutex_;        // 串行化 start() / stop()，保护 thread_
+    std::thread thread_;            // 解复用线程
+    std::atomic<bool> running_{false};
+    std::string error_msg_;
+    std::string file_path_;
+    
+    // 跳转请求（调用线程提交，解复用线程执行）
+    std::mutex seek_mutex_;
+    std::condition_variable seek_cv_;
+    bool seek_requested_ = false;
+    int seek_stream_ = -1;
+    int64_t seek_ts_ = 0;
+    int seek_flags_ = 0;
+    int seek_result_ = 0;
+    bool eof_ = false;              // 已读到文件末尾，等待跳转或停止
+    
+    bool seek_index_enabled_ = false;
+    SeekIndex seek_index_;          // 旁路索引（仅在 open() 时加载成功才有效）
+    
+    bool mmap_io_enabled_ = false;
+    std::unique_ptr<MediaIO> io_;   // 自定义 IO（mmap / 内存缓冲区），为空时使用 avformat 自带的文件读取
+};
+
+#endif /* DEMUXER_H */
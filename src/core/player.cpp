@@ -7,6 +7,7 @@
 
 #include <stdio.h>
 #include "player.h"
+#include "demuxer.h"
 #include "../common/log/log.h"
 
 
@@ -17,19 +18,27 @@ Player::~Player() {
     close();
 }
 
-void Player::openFile(const std::string file_path) {
+bool Player::openFile(const std::string file_path) {
     if (file_path.empty()) {
         error_msg_ = "file path is empty!!!";
         
-        return;
+        return false;
     }
+    close();
+    contex_.demuxer = std::make_shared<Demuxer>(contex_);
+    if (!contex_.demuxer->open(file_path)) {
+        error_msg_ = contex_.demuxer->getErrorMsg();
+        LOG_ERROR(error_msg_);
+        return false;
+    }
+    return true;
 }
 
 void Player::close() {
-    if (contex_.is_valid) {
-        if (contex_.format_ctx) {
-            avformat_free_context(contex_.format_ctx);
-        }
+    // AVFormatContext 由 demuxer 持有，关闭 demuxer 时一并释放
+    if (contex_.demuxer) {
+        contex_.demuxer->close();
+        contex_.demuxer.reset();
     }
 }
 
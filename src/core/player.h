@@ -10,15 +10,20 @@
 
 #include <stdio.h>
 #include <string>
+#include <memory>
 
 extern "C" {
 #include <libavformat/avformat.h>
 }
 
+class Demuxer;
+
 struct PlayerContext {
-    // 格式上下文（存储视频文件整体信息：路径，流数量，时长等）
+    // 格式上下文（存储视频文件整体信息：路径，流数量，时长等），由 demuxer 打开和释放
     AVFormatContext *format_ctx = nullptr;
     bool is_valid; // 标志 true 表示有效，false 表示空
+    // 解复用器（独立线程读包，按流分发给音视频解码器）
+    std::shared_ptr<Demuxer> demuxer;
     
     PlayerContext() {
         is_valid = true;
@@ -29,7 +34,7 @@ class Player {
 public:
     Player();
     ~Player();
-    void openFile(const std::string filePath);
+    bool openFile(const std::string filePath);
     void close();
     
 private:
@@ -7,3 +7,259 @@
 
 #include <stdio.h>
 #include "audio_decoder.h"
+#include "../core/demuxer.h"
+#include "../common/log/log.h"
+
+AudioDecoder::AudioDecoder(PlayerContext& ctx) : ctx_(ctx), frame_queue_(kDefaultFrameQueueCapacity),
+decoded_frame_(av_frame_alloc(),[](AVFrame *frame){
+    av_frame_free(&frame);
+}) {
+    // start() 之前 getFrame() 直接返回 nullptr，不会阻塞
+    frame_queue_.abort();
+    if (!decoded_frame_) {
+        error_msg_ = "AVFrame 内存分配失败";
+    }
+}
+
+AudioDecoder::~AudioDecoder() {
+    close();
+}
+
+bool AudioDecoder::openAudioDecoder(const std::string& file_path) {
+    if (!decoded_frame_) {
+        setError("AVFrame 内存分配失败");
+        return false;
+    }
+    // 文件由 demuxer 打开（已打开时直接复用）
+    if (!ctx_.demuxer) {
+        ctx_.demuxer = std::make_shared<Demuxer>(ctx_);
+    }
+    if (ctx_.format_ctx && !file_path.empty() && file_path != ctx_.demuxer->filePath()) {
+        setError("打开失败：上下文已打开其他文件（" + ctx_.demuxer->filePath() + "），请先关闭 demuxer");
+        return false;
+    }
+    if (!ctx_.format_ctx && !ctx_.demuxer->open(file_path)) {
+        setError(ctx_.demuxer->getErrorMsg());
+        return false;
+    }
+    
+    audio_stream_index_ = ctx_.demuxer->findStream(AVMEDIA_TYPE_AUDIO);
+    if (audio_stream_index_ == -1) {
+        setError("没有音频流");
+        close();
+        return false;
+    }
+    
+    AVCodecParameters* codec_par = ctx_.format_ctx->streams[audio_stream_index_]->codecpar;
+    codec_ = avcodec_find_decoder(codec_par->codec_id);
+    if (!codec_) {
+        setError("找不到对应的解码器（codec_id）:" + std::to_string(codec_par->codec_id));
+        close();
+        return false;
+    }
+    codec_ctx_ = avcodec_alloc_context3(codec_);
+    if (!codec_ctx_) {
+        setError("分配解码器上下文失败");
+        close();
+        return false;
+    }
+    int ret = avcodec_parameters_to_context(codec_ctx_, codec_par);
+    if (ret < 0) {
+        setError("复制流参数到解码器上下文失败：" + std::string(av_err2str(ret)));
+        close();
+        return false;
+    }
+    codec_ctx_->pkt_timebase = ctx_.format_ctx->streams[audio_stream_index_]->time_base;
+    // 音频解码很轻，单线程即可，避免和视频解码抢核
+    codec_ctx_->thread_count = 1;
+    ret = avcodec_open2(codec_ctx_, codec_, nullptr);
+    if (ret < 0) {
+        setError("打开音频解码器失败：" + std::string(av_err2str(ret)));
+        close();
+        return false;
+    }
+    
+    // 最后订阅：打开失败时不会留下无人消费的队列
+    packet_queue_ = ctx_.demuxer->subscribe(audio_stream_index_);
+    if (!packet_queue_) {
+        setError(ctx_.demuxer->getErrorMsg());
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AudioDecoder::start(size_t capacity, QueuePolicy policy) {
+    if (!codec_ctx_ || !packet_queue_) {
+        setError("启动解码线程失败：解码器未打开");
+        return false;
+    }
+    if (running_) {
+        return true;
+    }
+    // 上次 stop() 中止了帧队列：按本次参数恢复可用
+    frame_queue_.configure(capacity, policy);
+    frame_queue_.reset();
+    running_ = true;
+    thread_ = std::thread(&AudioDecoder::decodeLoop, this);
+    if (!ctx_.demuxer->start()) {
+        setError(ctx_.demuxer->getErrorMsg());
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void AudioDecoder::stop() {
+    running_ = false;
+    frame_queue_.abort();
+    // 解码线程可能阻塞在取包上，中止该流的包队列（demuxer 停止时也会中止）
+    if (packet_queue_) {
+        packet_queue_->abort();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (packet_queue_) {
+        // 恢复包队列，之后还可以重新 start()
+        packet_queue_->reset();
+    }
+    // 队列保持中止状态（直到下次 start()），未取走的帧归还帧池
+    for (AudioFrame::Ptr& frame : frame_queue_.takeAll()) {
+        if (frame) {
+            frame_pool_.release(std::move(frame));
+        }
+    }
+}
+
+void AudioDecoder::close() {
+    stop();
+    if (packet_queue_ && ctx_.demuxer) {
+        ctx_.demuxer->unsubscribe(audio_stream_index_);
+    }
+    packet_queue_ = nullptr;
+    if (codec_ctx_) {
+        avcodec_free_context(&codec_ctx_);
+        codec_ctx_ = nullptr;
+    }
+    audio_stream_index_ = -1;
+    codec_ = nullptr;
+}
+
+AudioFrame::Ptr AudioDecoder::getFrame() {
+    AudioFrame::Ptr frame;
+    if (!frame_queue_.pop(frame)) {
+        // 队列被中止（未启动或已停止）
+        return nullptr;
+    }
+    return frame;
+}
+
+void AudioDecoder::decodeLoop() {
+    while (running_) {
+        PacketPtr packet;
+        if (!packet_queue_->pop(packet)) {
+            // 队列被中止（demuxer 或解码器停止）
+            break;
+        }
+        // 空包是 demuxer 的结束标记：送入 nullptr 进入 flush 模式，取出解码器缓存的帧
+        int ret = avcodec_send_packet(codec_ctx_, packet.get());
+        if (ret < 0 && ret != AVERROR_EOF) {
+            // 损坏的数据包：跳过，继续解码后面的包
+            const std::string msg = "发送音频数据包失败：" + std::string(av_err2str(ret));
+            setError(msg);
+            LOG_WARN(msg);
+            continue;
+        }
+        
+        while (running_) {
+            ret = avcodec_receive_frame(codec_ctx_, decoded_frame_.get());
+            if (ret == AVERROR(EAGAIN)) {
+                break;
+            }
+            if (ret == AVERROR_EOF) {
+                // 通知消费者结束；flush 后 demuxer 跳转回来还可以继续解码
+                frame_queue_.push(nullptr);
+                avcodec_flush_buffers(codec_ctx_);
+                break;
+            }
+            if (ret < 0) {
+                const std::string msg = "音频解码失败：" + std::string(av_err2str(ret));
+                setError(msg);
+                LOG_ERROR(msg);
+                break;
+            }
+            AudioFrame::Ptr frame = wrapDecodedFrame(decoded_frame_.get());
+            av_frame_unref(decoded_frame_.get());
+            if (frame && !frame_queue_.push(frame)) {
+                // 队列已中止：帧直接归还
+                frame_pool_.release(std::move(frame));
+                break;
+            }
+        }
+    }
+}
+
+AudioFrame::Ptr AudioDecoder::wrapDecodedFrame(AVFrame* frame) {
+    SampleFormat fmt = AVSampleFormatToSampleFormat(frame->format);
+    if (fmt == SampleFormat::UNKNOWN) {
+        const std::string msg = "不支持的解码输出采样格式：" + std::to_string(frame->format);
+        setError(msg);
+        LOG_ERROR(msg);
+        return nullptr;
+    }
+    AudioFrame::Ptr audio_frame = frame_pool_.acquire(frame->sample_rate, frame->ch_layout.nb_channels, fmt);
+    if (!audio_frame->refAVFrame(frame)) {
+        setError("引用解码帧缓冲区失败");
+        LOG_ERROR("引用解码帧缓冲区失败");
+        frame_pool_.release(std::move(audio_frame));
+        return nullptr;
+    }
+    audio_frame->setPts(frame->best_effort_timestamp);
+    audio_frame->setDts(frame->pkt_dts);
+    audio_frame->setDuration(static_cast<int>(frame->duration));
+    audio_frame->setStreamIndex(audio_stream_index_);
+    return audio_frame;
+}
+
+void AudioDecoder::getAudioFormat(int& sample_rate, int& channels, SampleFormat& fmt) {
+    if (!codec_ctx_) {
+        sample_rate = 0;
+        channels = 0;
+        fmt = SampleFormat::UNKNOWN;
+        return;
+    }
+    sample_rate = codec_ctx_->sample_rate;
+    channels = codec_ctx_->ch_layout.nb_channels;
+    fmt = AVSampleFormatToSampleFormat(codec_ctx_->sample_fmt);
+}
+
+void AudioDecoder::getTimeBase(int& num, int& den) {
+    if (!ctx_.format_ctx || audio_stream_index_ < 0) {
+        num = 0;
+        den = 1;
+        return;
+    }
+    AVRational time_base = ctx_.format_ctx->streams[audio_stream_index_]->time_base;
+    num = time_base.num;
+    den = time_base.den;
+}
+
+std::string AudioDecoder::getAudioCodecName() {
+    if (audio_stream_index_ < 0) {
+        setError("获取音频编码格式失败：未找到音频流");
+        return "";
+    }
+    AVCodecParameters* codec_par = ctx_.format_ctx->streams[audio_stream_index_]->codecpar;
+    return avcodec_get_name(codec_par->codec_id);
+}
+
+std::string AudioDecoder::getErrorMsg() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_msg_;
+}
+
+void AudioDecoder::setError(const std::string& msg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_msg_ = msg;
+}
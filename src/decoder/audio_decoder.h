@@ -9,18 +9,98 @@
 #define AUDIO_DECODER_H
 
 #include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
 
-struct AudioFrame {
-    uint8_t* data;
-    int linesize;
-    int sample_rate;
-    int channels;
-    int format;
-    int nb_samples;
-};
-
-using AudioFramePtr = std::shared_ptr<AudioFrame>
+#include "../common/media_frame.h"
+#include "../util/frame/frame_pool.h"
+#include "../util/queue/bounded_queue.h"
+#include "../core/player.h"
+#include "codec_utils.h"
 
+/**
+ * 音频解码器：与视频解码器共用同一个 PlayerContext（同一个 demuxer，不重复打开文件）
+ * 在独立线程中解码，输出帧池中的 AudioFrame（零拷贝引用解码器缓冲区）
+ * 用法：openAudioDecoder() -> start() -> 循环 getFrame() 直到返回 nullptr -> close()
+ * @note demuxer 对每个流都有背压：音频帧队列满且无人消费时，会连带阻塞视频流的读包，
+ *       不需要逐帧消费时可以用 QueuePolicy::DROP_OLDEST 启动
+ */
+class AudioDecoder {
+public:
+    static constexpr size_t kDefaultFrameQueueCapacity = 32;
+    
+    AudioDecoder(PlayerContext& ctx);
+    ~AudioDecoder();
+    
+    AudioDecoder(const AudioDecoder&) = delete;
+    AudioDecoder& operator=(const AudioDecoder&) = delete;
+    
+    /**
+     * 打开音频解码器
+     * @param file_path 文件路径；ctx 中的 demuxer 已打开同一文件时直接复用（与视频解码器共用），
+     *                  已打开其他文件时返回false（需先 ctx.demuxer->close()），为空时复用已打开的输入
+     * @return 成功返回true
+     * @note 需要在 demuxer 启动之前打开（即视频解码器第一次 getFrame() 之前），否则之前读过的音频包会丢失
+     */
+    bool openAudioDecoder(const std::string& file_path);
+    
+    /**
+     * 启动解码线程（同时启动 demuxer，重复调用无副作用）
+     * @param capacity 解码输出帧队列容量
+     * @param policy 帧队列满时的策略
+     * @return 成功返回true
+     */
+    bool start(size_t capacity = kDefaultFrameQueueCapacity, QueuePolicy policy = QueuePolicy::BLOCK);
+    
+    // 停止解码线程（队列中未取走的帧归还帧池）；可以在其他线程阻塞于 getFrame() 时调用，该调用返回 nullptr
+    void stop();
+    void close();
+    
+    /**
+     * 取下一帧解码后的音频（阻塞）
+     * @return 帧池中的音频帧，结束、停止或失败返回 nullptr
+     * @note 用完后通过 framePool().release() 或 MediaFrameGuard 归还
+     */
+    AudioFrame::Ptr getFrame();
+    AudioFramePool& framePool() { return frame_pool_; }
+    
+    // 解码输出的音频参数（打开后有效）
+    void getAudioFormat(int& sample_rate, int& channels, SampleFormat& fmt);
+    // 音频流时间基（pts 单位）
+    void getTimeBase(int& num, int& den);
+    bool isRunning() const { return running_; }
+    std::string getErrorMsg();
+    std::string getAudioCodecName();
+    
+private:
+    void decodeLoop();
+    // 把解码出的 AVFrame 包装成帧池中的 AudioFrame（不复制采样数据）
+    AudioFrame::Ptr wrapDecodedFrame(AVFrame* frame);
+    void setError(const std::string& msg);
+    
+    PlayerContext& ctx_;
+    AVCodecContext* codec_ctx_ = nullptr;
+    const AVCodec* codec_ = nullptr;
+    int audio_stream_index_ = -1;
+    // 音频流的数据包队列（由 demuxer 填充，解码线程消费）
+    PacketQueue* packet_queue_ = nullptr;
+    // 解码输出帧队列（nullptr 表示结束）；与解码器同生命周期，
+    // 停止时只中止不销毁，其他线程阻塞在 getFrame() 上也不会访问已释放的队列
+    BoundedQueue<AudioFrame::Ptr> frame_queue_;
+    std::unique_ptr<AVFrame,void(*)(AVFrame *)> decoded_frame_;
+    AudioFramePool frame_pool_;
+    
+    std::thread thread_;            // 解码线程
+    std::atomic<bool> running_{false};
+    std::mutex mutex_;              // 保护 error_msg_
+    std::string error_msg_;
+};
 
 #endif /* AUDIO_DECODER_H */
@@ -8,5 +8,25 @@
 #ifndef codec_utils_h
 #define codec_utils_h
 
+#include <memory>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+#include "../util/queue/bounded_queue.h"
+
+// AVPacket 智能指针删除器
+struct AVPacketDeleter {
+    void operator()(AVPacket* pkt) const {
+        av_packet_free(&pkt);
+    }
+};
+
+// 数据包智能指针：nullptr 表示流结束（解码器需要 flush）
+using PacketPtr = std::unique_ptr<AVPacket, AVPacketDeleter>;
+
+// 解复用线程 -> 解码线程：按流划分的压缩数据包队列
+using PacketQueue = BoundedQueue<PacketPtr>;
 
 #endif /* codec_utils_h */
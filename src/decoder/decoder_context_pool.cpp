@@ -0,0 +1,140 @@
+//
+//  decoder_context_pool.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <functional>
+#include "decoder_context_pool.h"
+
+// FNV-1a
+static uint64_t hashBytes(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool DecoderContextPool::Key::operator==(const Key& other) const {
+    return codec_id == other.codec_id && width == other.width && height == other.height &&
+           format == other.format && profile == other.profile && extradata_hash == other.extradata_hash &&
+           thread_count == other.thread_count && hw_accel == other.hw_accel && lowres == other.lowres;
+}
+
+size_t DecoderContextPool::KeyHash::operator()(const Key& key) const {
+    size_t hash = std::hash<uint64_t>()(key.extradata_hash);
+    auto combine = [&hash](int value) {
+        hash ^= std::hash<int>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    combine(key.codec_id);
+    combine(key.width);
+    combine(key.height);
+    combine(key.format);
+    combine(key.profile);
+    combine(key.thread_count);
+    combine(key.hw_accel ? 1 : 0);
+    combine(key.lowres);
+    return hash;
+}
+
+DecoderContextPool::DecoderContextPool(size_t max_idle_per_key) : max_idle_per_key_(max_idle_per_key) {
+}
+
+DecoderContextPool::~DecoderContextPool() {
+    clear();
+}
+
+DecoderContextPool::Key DecoderContextPool::makeKey(const AVCodecParameters* codec_par, int thread_count,
+                                                    bool hw_accel, int lowres) {
+    Key key;
+    key.codec_id = codec_par->codec_id;
+    key.width = codec_par->width;
+    key.height = codec_par->height;
+    key.format = codec_par->format;
+    key.profile = codec_par->profile;
+    key.extradata_hash = codec_par->extradata ? hashBytes(codec_par->extradata, codec_par->extradata_size) : 0;
+    key.thread_count = thread_count;
+    key.hw_accel = hw_accel;
+    key.lowres = lowres;
+    return key;
+}
+
+AVCodecContext* DecoderContextPool::acquire(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(key);
+    if (it == idle_.end() || it->second.empty()) {
+        miss_count_++;
+        return nullptr;
+    }
+    AVCodecContext* codec_ctx = it->second.back();
+    it->second.pop_back();
+    hit_count_++;
+    return codec_ctx;
+}
+
+void DecoderContextPool::release(const Key& key, AVCodecContext* codec_ctx) {
+    if (!codec_ctx) {
+        return;
+    }
+    if (!avcodec_is_open(codec_ctx)) {
+        freeContext(codec_ctx);
+        return;
+    }
+    // 清空参考帧和内部队列，同时退出 flush（EOF）状态，下一个文件可以直接送包
+    avcodec_flush_buffers(codec_ctx);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& contexts = idle_[key];
+        if (contexts.size() < max_idle_per_key_) {
+            contexts.push_back(codec_ctx);
+            return;
+        }
+    }
+    freeContext(codec_ctx);
+}
+
+void DecoderContextPool::clear() {
+    std::unordered_map<Key, std::vector<AVCodecContext*>, KeyHash> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle.swap(idle_);
+    }
+    for (auto& item : idle) {
+        for (AVCodecContext* codec_ctx : item.second) {
+            freeContext(codec_ctx);
+        }
+    }
+}
+
+size_t DecoderContextPool::hitCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hit_count_;
+}
+
+size_t DecoderContextPool::missCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return miss_count_;
+}
+
+size_t DecoderContextPool::idleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& item : idle_) {
+        count += item.second.size();
+    }
+    return count;
+}
+
+void DecoderContextPool::freeContext(AVCodecContext* codec_ctx) {
+    if (!codec_ctx) {
+        return;
+    }
+    if (codec_ctx->hw_device_ctx) {
+        av_buffer_unref(&codec_ctx->hw_device_ctx);
+    }
+    avcodec_free_context(&codec_ctx);
+}
@@ -0,0 +1,95 @@
+//
+//  decoder_context_pool.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef DECODER_CONTEXT_POOL_H
+#define DECODER_CONTEXT_POOL_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/**
+ * 已打开的解码器上下文池（批量处理大量同编码、同分辨率短视频时复用）
+ * 每个文件重新创建 AVCodecContext 要重建线程池、探测硬件设备，耗时毫秒级；
+ * 复用时只需 avcodec_flush_buffers + 更新与文件相关的参数，耗时微秒级
+ * 线程安全，可以被多个 VideoDecoder 共享
+ */
+class DecoderContextPool {
+public:
+    // 复用条件：这些参数都相同的上下文才能互换（打开后不能再修改的选项也在其中）
+    struct Key {
+        int codec_id = 0;
+        int width = 0;
+        int height = 0;
+        int format = -1;
+        int profile = 0;
+        uint64_t extradata_hash = 0;    // SPS/PPS 等只在打开时解析，必须一致
+        int thread_count = 0;
+        bool hw_accel = false;
+        int lowres = 0;
+        
+        bool operator==(const Key& other) const;
+    };
+    
+    /**
+     * @param max_idle_per_key 每个 Key 最多缓存的空闲上下文个数（超出的直接释放）
+     */
+    explicit DecoderContextPool(size_t max_idle_per_key = 4);
+    ~DecoderContextPool();
+    
+    DecoderContextPool(const DecoderContextPool&) = delete;
+    DecoderContextPool& operator=(const DecoderContextPool&) = delete;
+    
+    /**
+     * 生成复用 Key
+     * @param codec_par 视频流参数
+     * @param thread_count 解码线程数（已换算为实际值）
+     * @param hw_accel 是否尝试硬件解码
+     * @param lowres 解码器 lowres 值
+     */
+    static Key makeKey(const AVCodecParameters* codec_par, int thread_count, bool hw_accel, int lowres);
+    
+    /**
+     * 取出一个可复用的已打开上下文
+     * @return 命中返回上下文（已 flush），未命中返回 nullptr（调用者自行创建后用 release 放回）
+     */
+    AVCodecContext* acquire(const Key& key);
+    
+    /**
+     * 归还上下文：flush 后缓存，超出上限时释放
+     * @note 只能归还 avcodec_open2 成功的上下文
+     */
+    void release(const Key& key, AVCodecContext* codec_ctx);
+    
+    // 释放所有缓存的上下文
+    void clear();
+    
+    size_t hitCount() const;
+    size_t missCount() const;
+    size_t idleCount() const;
+    
+    // 释放上下文（含硬件设备引用）
+    static void freeContext(AVCodecContext* codec_ctx);
+    
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, std::vector<AVCodecContext*>, KeyHash> idle_;
+    size_t max_idle_per_key_;
+    size_t hit_count_ = 0;
+    size_t miss_count_ = 0;
+};
+
+#endif /* DECODER_CONTEXT_POOL_H */
@@ -0,0 +1,172 @@
+//
+//  media_io.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cstring>
+#include <algorithm>
+#include "media_io.h"
+#include "../common/platform.h"
+
+extern "C" {
+#include <libavutil/mem.h>
+#include <libavutil/error.h>
+}
+
+#if !PLATFORM_WIN
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// AVIOContext 内部缓冲区大小（大于该值的读取 avio 会直接读到调用者缓冲区）
+static const int kIOBufferSize = 64 * 1024;
+// 预读窗口：读位置前方保持 4MB 已提示预读
+static const size_t kReadaheadSize = 4 * 1024 * 1024;
+
+MediaIO::~MediaIO() {
+    close();
+}
+
+bool MediaIO::openFile(const std::string& file_path) {
+    close();
+#if PLATFORM_WIN
+    error_msg_ = "当前平台不支持 mmap";
+    return false;
+#else
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error_msg_ = "打开文件失败：" + file_path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        error_msg_ = "文件为空或无法获取大小：" + file_path;
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // 映射建立后可以关闭文件描述符
+    if (mapped == MAP_FAILED) {
+        error_msg_ = "mmap 失败：" + file_path;
+        return false;
+    }
+    // 解复用基本是顺序读（MP4 先读 moov 再顺序读 mdat），让内核加大预读、及时回收读过的页
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    mapped_ = mapped;
+    data_ = static_cast<const uint8_t*>(mapped);
+    size_ = size;
+    pos_ = 0;
+    advised_end_ = 0;
+    return createAVIOContext();
+#endif
+}
+
+bool MediaIO::openBuffer(const uint8_t* data, size_t size) {
+    close();
+    if (!data || size == 0) {
+        error_msg_ = "内存缓冲区为空";
+        return false;
+    }
+    data_ = data;
+    size_ = size;
+    pos_ = 0;
+    return createAVIOContext();
+}
+
+void MediaIO::close() {
+    if (avio_ctx_) {
+        // 缓冲区可能已被 avio 内部重新分配，必须释放 avio_ctx_->buffer 而不是最初分配的指针
+        av_freep(&avio_ctx_->buffer);
+        avio_context_free(&avio_ctx_);
+    }
+#if !PLATFORM_WIN
+    if (mapped_) {
+        munmap(mapped_, size_);
+    }
+#endif
+    mapped_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    pos_ = 0;
+    advised_end_ = 0;
+}
+
+bool MediaIO::createAVIOContext() {
+    uint8_t* buffer = static_cast<uint8_t*>(av_malloc(kIOBufferSize));
+    if (!buffer) {
+        error_msg_ = "AVIO 缓冲区内存分配失败";
+        close();
+        return false;
+    }
+    avio_ctx_ = avio_alloc_context(buffer, kIOBufferSize, 0, this, &MediaIO::readPacket, nullptr, &MediaIO::seek);
+    if (!avio_ctx_) {
+        av_free(buffer);
+        error_msg_ = "AVIOContext 创建失败";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MediaIO::adviseReadahead() {
+#if !PLATFORM_WIN
+    if (!mapped_ || pos_ + kReadaheadSize / 2 < advised_end_) {
+        return;
+    }
+    // madvise 要求起始地址按页对齐
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = pos_ & ~(page_size - 1);
+    const size_t end = std::min(pos_ + kReadaheadSize, size_);
+    if (end > start) {
+        madvise(static_cast<uint8_t*>(mapped_) + start, end - start, MADV_WILLNEED);
+    }
+    advised_end_ = end;
+#endif
+}
+
+int MediaIO::readPacket(void* opaque, uint8_t* buf, int buf_size) {
+    MediaIO* io = static_cast<MediaIO*>(opaque);
+    if (io->pos_ >= io->size_) {
+        return AVERROR_EOF;
+    }
+    io->adviseReadahead();
+    const size_t count = std::min(static_cast<size_t>(buf_size), io->size_ - io->pos_);
+    std::memcpy(buf, io->data_ + io->pos_, count);
+    io->pos_ += count;
+    return static_cast<int>(count);
+}
+
+int64_t MediaIO::seek(void* opaque, int64_t offset, int whence) {
+    MediaIO* io = static_cast<MediaIO*>(opaque);
+    int64_t target = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return static_cast<int64_t>(io->size_);
+        case SEEK_SET:
+            target = offset;
+            break;
+        case SEEK_CUR:
+            target = static_cast<int64_t>(io->pos_) + offset;
+            break;
+        case SEEK_END:
+            target = static_cast<int64_t>(io->size_) + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+    if (target < 0 || target > static_cast<int64_t>(io->size_)) {
+        return AVERROR(EINVAL);
+    }
+    if (static_cast<size_t>(target) < io->pos_ || static_cast<size_t>(target) > io->advised_end_) {
+        // 跳出了已预读的窗口，下一次读取重新发出预读提示
+        io->advised_end_ = 0;
+    }
+    io->pos_ = static_cast<size_t>(target);
+    return target;
+}
@@ -0,0 +1,72 @@
+//
+//  media_io.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef MEDIA_IO_H
+#define MEDIA_IO_H
+
+#include <string>
+#include <cstdint>
+
+extern "C" {
+#include <libavformat/avio.h>
+}
+
+/**
+ * 自定义 AVIOContext 数据源：本地文件走 mmap，或直接读调用者持有的内存缓冲区
+ * - mmap：整个文件只映射一次，顺序读提示（MADV_SEQUENTIAL）+ 读位置前方预读（MADV_WILLNEED），
+ *   每次读包不再经过 stdio 的 read 系统调用和额外拷贝
+ * - 内存缓冲区：上游服务已在内存中的 MP4 数据无需先写临时文件
+ * 用法：openFile()/openBuffer() -> avioContext() 交给 AVFormatContext::pb（AVFMT_FLAG_CUSTOM_IO）
+ */
+class MediaIO {
+public:
+    MediaIO() = default;
+    ~MediaIO();
+    
+    MediaIO(const MediaIO&) = delete;
+    MediaIO& operator=(const MediaIO&) = delete;
+    
+    /**
+     * mmap 打开本地文件
+     * @return 成功返回true；不支持 mmap 的平台返回false，调用者回退到 avformat 自带的文件读取
+     */
+    bool openFile(const std::string& file_path);
+    
+    /**
+     * 使用调用者持有的内存缓冲区（不拷贝）
+     * @param data 完整的媒体文件数据，必须在 close() 之前保持有效
+     * @param size 数据大小
+     * @return 成功返回true
+     */
+    bool openBuffer(const uint8_t* data, size_t size);
+    
+    // 释放 AVIOContext 和 mmap
+    void close();
+    
+    // 交给 AVFormatContext::pb 使用，生命周期由 MediaIO 管理
+    AVIOContext* avioContext() const { return avio_ctx_; }
+    size_t size() const { return size_; }
+    std::string getErrorMsg() const { return error_msg_; }
+    
+private:
+    bool createAVIOContext();
+    // 在读位置前方发出预读提示（仅 mmap）
+    void adviseReadahead();
+    
+    static int readPacket(void* opaque, uint8_t* buf, int buf_size);
+    static int64_t seek(void* opaque, int64_t offset, int whence);
+    
+    const uint8_t* data_ = nullptr;     // 数据起始地址（mmap 区域或调用者的缓冲区）
+    size_t size_ = 0;
+    size_t pos_ = 0;                    // 当前读位置
+    void* mapped_ = nullptr;            // mmap 区域（内存缓冲区模式为空）
+    size_t advised_end_ = 0;            // 已发出预读提示的区域末尾
+    AVIOContext* avio_ctx_ = nullptr;
+    std::string error_msg_;
+};
+
+#endif /* MEDIA_IO_H */
@@ -0,0 +1,169 @@
+//
+//  parallel_video_decoder.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "parallel_video_decoder.h"
+#include "../core/demuxer.h"
+#include "../common/log/log.h"
+
+// 每段输出队列的容量（帧数）：限制领先的段占用的内存
+static const size_t kSegmentQueueCapacity = 8;
+
+ParallelVideoDecoder::ParallelVideoDecoder(int num_workers, int segments_per_worker)
+: num_workers_(num_workers > 0 ? num_workers : static_cast<int>(std::thread::hardware_concurrency())),
+  segments_per_worker_(std::max(1, segments_per_worker)) {
+    num_workers_ = std::max(1, num_workers_);
+}
+
+bool ParallelVideoDecoder::open(const std::string& file_path) {
+    segments_.clear();
+    file_path_ = file_path;
+    
+    // 只读索引，不启动解复用线程
+    PlayerContext ctx;
+    Demuxer demuxer(ctx);
+    demuxer.setSeekIndexEnabled(seek_index_enabled_);
+    if (!demuxer.open(file_path)) {
+        setError(demuxer.getErrorMsg());
+        return false;
+    }
+    const int stream_index = demuxer.findStream(AVMEDIA_TYPE_VIDEO);
+    if (stream_index < 0) {
+        setError("没有视频流");
+        return false;
+    }
+    
+    std::vector<int64_t> keyframes = demuxer.keyframeTimestamps(stream_index);
+    if (keyframes.size() < 2) {
+        // 没有索引或只有一个 GOP：整个文件作为一段
+        segments_.push_back({AV_NOPTS_VALUE, AV_NOPTS_VALUE, AV_NOPTS_VALUE});
+        return true;
+    }
+    
+    // 相邻的 GOP 合并成段，段数约为 num_workers * segments_per_worker
+    const size_t target_segments = std::min(keyframes.size(), static_cast<size_t>(num_workers_) * segments_per_worker_);
+    const size_t gops_per_segment = (keyframes.size() + target_segments - 1) / target_segments;
+    // 第一段从文件开头解码，避免丢掉第一个关键帧之前的帧
+    segments_.push_back({AV_NOPTS_VALUE, AV_NOPTS_VALUE, AV_NOPTS_VALUE});
+    for (size_t i = gops_per_segment; i < keyframes.size(); i += gops_per_segment) {
+        // 段边界必须是关键帧的 pts：用 dts 做边界时，上一段会丢掉 pts 落在 [dts, pts) 之间的帧
+        const int64_t start_pts = demuxer.readKeyframePts(stream_index, keyframes[i]);
+        if (start_pts == AV_NOPTS_VALUE) {
+            // 读不到这个关键帧：不在这里切分，并入上一段
+            continue;
+        }
+        segments_.back().end_pts = start_pts;
+        segments_.push_back({keyframes[i], start_pts, AV_NOPTS_VALUE});
+    }
+    return true;
+}
+
+bool ParallelVideoDecoder::decodeAll(const FrameCallback& callback) {
+    if (segments_.empty() || !callback) {
+        setError("并行解码失败：文件未打开或回调为空");
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_msg_.clear();
+    }
+    
+    std::vector<std::unique_ptr<FrameQueue>> queues;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        queues.push_back(std::make_unique<FrameQueue>(kSegmentQueueCapacity));
+    }
+    
+    // 工作线程按顺序领取段：最早未完成的段一定已被领取，消费者只等它，不会死锁
+    std::atomic<size_t> next_segment{0};
+    std::vector<std::thread> workers;
+    const int worker_count = std::min<int>(num_workers_, static_cast<int>(segments_.size()));
+    for (int w = 0; w < worker_count; ++w) {
+        workers.emplace_back([this, &next_segment, &queues] {
+            size_t index;
+            while ((index = next_segment.fetch_add(1)) < segments_.size()) {
+                decodeSegment(segments_[index], *queues[index]);
+            }
+        });
+    }
+    
+    // 按段顺序拼接：段内帧已经是 pts 顺序
+    bool stopped = false;
+    for (size_t i = 0; i < queues.size() && !stopped; ++i) {
+        VideoFrame::Ptr frame;
+        while (queues[i]->pop(frame) && frame) {
+            if (!callback(frame)) {
+                stopped = true;
+                break;
+            }
+            frame.reset();
+        }
+    }
+    
+    // 提前停止：中止所有队列，让阻塞的工作线程退出
+    for (auto& queue : queues) {
+        queue->abort();
+    }
+    // 工作线程还可能领取新段，直接让计数越界
+    next_segment = segments_.size();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_msg_.empty();
+}
+
+void ParallelVideoDecoder::decodeSegment(const Segment& segment, FrameQueue& queue) {
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    // 并行度来自段，单段内单线程软解（避免线程数乘法和硬件会话争抢）
+    decoder.setThreadCount(1);
+    decoder.setHwAccelEnabled(false);
+    decoder.setSeekIndexEnabled(seek_index_enabled_);
+    decoder.setMmapIOEnabled(true);
+    if (!decoder.openVideoDecoder(file_path_)) {
+        setError("段解码器打开失败：" + decoder.getErrorMsg());
+        queue.push(nullptr);
+        return;
+    }
+    if (segment.seek_dts != AV_NOPTS_VALUE && !decoder.seekTo(segment.seek_dts)) {
+        setError("段跳转失败：" + decoder.getErrorMsg());
+        queue.push(nullptr);
+        return;
+    }
+    
+    VideoFrame::Ptr frame;
+    while ((frame = decoder.getFrame())) {
+        const int64_t pts = frame->pts();
+        // 段起点之前的帧（开放 GOP 的前导 B 帧）属于上一段
+        if (segment.start_pts != AV_NOPTS_VALUE && pts != AV_NOPTS_VALUE && pts < segment.start_pts) {
+            continue;
+        }
+        // 解码输出是显示顺序，第一帧越过段终点后就可以结束
+        if (segment.end_pts != AV_NOPTS_VALUE && pts != AV_NOPTS_VALUE && pts >= segment.end_pts) {
+            break;
+        }
+        // 帧离开解码器后不再归还它的帧池（解码器先于帧销毁），引用计数归零时释放缓冲区
+        if (!queue.push(std::move(frame))) {
+            return;
+        }
+    }
+    queue.push(nullptr);
+}
+
+void ParallelVideoDecoder::setError(const std::string& msg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_msg_ = msg;
+    LOG_ERROR(msg);
+}
+
+std::string ParallelVideoDecoder::getErrorMsg() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_msg_;
+}
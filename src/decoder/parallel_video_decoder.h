@@ -0,0 +1,77 @@
+//
+//  parallel_video_decoder.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef PARALLEL_VIDEO_DECODER_H
+#define PARALLEL_VIDEO_DECODER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "video_decoder.h"
+
+/**
+ * GOP 并行解码器：离线分析单个长文件时，按关键帧把时间线切成多段，
+ * 每段使用独立的 AVFormatContext + AVCodecContext 在各自的线程上解码，再按 pts 顺序拼回
+ * 单个解码器的帧级线程（FF_THREAD_FRAME）超过 8 线程左右就很难再扩展，段级并行可以吃满多核
+ * @note 依赖容器索引（MP4 的 stss）；没有索引的文件退化为单段顺序解码
+ */
+class ParallelVideoDecoder {
+public:
+    using FrameCallback = VideoDecoder::FrameCallback;
+    
+    /**
+     * @param num_workers 并行解码的段数上限（0 表示 CPU 核心数）
+     * @param segments_per_worker 每个工作线程平均分到的段数（越大负载越均衡，重复打开文件的开销越大）
+     */
+    explicit ParallelVideoDecoder(int num_workers = 0, int segments_per_worker = 4);
+    
+    /**
+     * 启用旁路索引（需在 open() 之前调用，默认关闭）
+     * 启用后会在输入文件旁写 <文件>.idx，之后每个段解码器打开同一文件时都跳过探测
+     */
+    void setSeekIndexEnabled(bool enabled) { seek_index_enabled_ = enabled; }
+    
+    // 读取关键帧索引并切分时间线
+    bool open(const std::string& file_path);
+    
+    /**
+     * 并行解码整个文件，按 pts 顺序回调每一帧
+     * @param callback 返回 false 时停止解码
+     * @return 成功返回true
+     * @note 回调中的帧不属于任何帧池，回调返回后即释放
+     */
+    bool decodeAll(const FrameCallback& callback);
+    
+    size_t segmentCount() const { return segments_.size(); }
+    std::string getErrorMsg();
+    
+private:
+    // 一个解码段：从 seek_dts 处的关键帧开始解码，输出 pts 落在 [start_pts, end_pts) 的帧
+    // 边界取关键帧的真实 pts（索引里只有 dts，有 B 帧时二者不同）；AV_NOPTS_VALUE 表示文件开头/末尾
+    struct Segment {
+        int64_t seek_dts;
+        int64_t start_pts;
+        int64_t end_pts;
+    };
+    
+    using FrameQueue = BoundedQueue<VideoFrame::Ptr>;
+    
+    // 在工作线程中解码一段，帧按顺序放入该段的队列，结束时放入空指针
+    void decodeSegment(const Segment& segment, FrameQueue& queue);
+    void setError(const std::string& msg);
+    
+    std::string file_path_;
+    int num_workers_ = 0;
+    int segments_per_worker_ = 4;
+    bool seek_index_enabled_ = false;
+    std::vector<Segment> segments_;
+    std::mutex mutex_;          // 保护 error_msg_
+    std::string error_msg_;
+};
+
+#endif /* PARALLEL_VIDEO_DECODER_H */
@@ -0,0 +1,413 @@
+//
+//  seek_index.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include "seek_index.h"
+#include "../common/platform.h"
+#include "../common/log/log.h"
+
+#if !PLATFORM_WIN
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char kSeekIndexMagic[8] = {'M','P','4','A','I','I','D','X'};
+static const uint32_t kSeekIndexVersion = 4;
+
+// 索引文件头（本机字节序，版本号不匹配即重建）
+// 布局：Header | StreamRecord[nb_streams] | 各流 extradata（每段补齐到 8 字节） | KeyframeEntry[keyframe_count]
+struct SeekIndex::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t file_size;         // 视频文件大小（失效校验）
+    int64_t file_mtime_ns;      // 视频文件修改时间（失效校验）
+    char format_name[32];       // 容器格式短名
+    int32_t stream_index;       // 关键帧表所属的视频流
+    uint32_t nb_streams;
+    uint64_t extradata_bytes;   // extradata 区总长度（8 的倍数）
+    uint64_t keyframe_count;
+};
+
+// 单个流的参数：avformat_find_stream_info 探包得到、容器头里可能没有的部分
+struct SeekIndex::StreamRecord {
+    int32_t codec_type;
+    int32_t codec_id;
+    int32_t format;             // 视频为像素格式，音频为采样格式
+    int32_t width;
+    int32_t height;
+    int32_t profile;
+    int32_t level;
+    int32_t time_base_num;
+    int32_t time_base_den;
+    int32_t frame_rate_num;
+    int32_t frame_rate_den;
+    int32_t r_frame_rate_num;
+    int32_t r_frame_rate_den;
+    int32_t sar_num;
+    int32_t sar_den;
+    int32_t video_delay;        // 重排序延迟（has_b_frames），决定解码器输出前缓存的帧数
+    int32_t field_order;
+    int32_t sample_rate;
+    int32_t channels;
+    int32_t channel_order;      // AVChannelOrder
+    int32_t frame_size;         // 每帧采样数（AAC 为 1024）
+    int32_t initial_padding;
+    uint32_t extradata_offset;  // 在 extradata 区中的偏移
+    uint32_t extradata_size;
+    uint64_t channel_mask;      // channel_order 为 AV_CHANNEL_ORDER_NATIVE 时有效
+    int64_t start_time;
+    int64_t duration;
+    int64_t bit_rate;
+};
+
+static size_t alignTo8(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+// 获取文件大小和修改时间（纳秒）
+static bool statFile(const std::string& path, uint64_t& size, int64_t& mtime_ns) {
+#if PLATFORM_WIN
+    return false;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+#if PLATFORM_MAC
+    mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    return true;
+#endif
+}
+
+SeekIndex::~SeekIndex() {
+    reset();
+}
+
+std::string SeekIndex::sidecarPath(const std::string& file_path) {
+    return file_path + ".idx";
+}
+
+void SeekIndex::reset() {
+#if !PLATFORM_WIN
+    if (mapped_) {
+        munmap(mapped_, mapped_size_);
+    }
+#endif
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+    header_ = nullptr;
+    streams_ = nullptr;
+    extradata_ = nullptr;
+    keyframes_ = nullptr;
+}
+
+bool SeekIndex::load(const std::string& file_path) {
+    reset();
+#if PLATFORM_WIN
+    return false;
+#else
+    uint64_t file_size = 0;
+    int64_t file_mtime_ns = 0;
+    if (!statFile(file_path, file_size, file_mtime_ns)) {
+        return false;
+    }
+    
+    const std::string index_path = sidecarPath(file_path);
+    int fd = ::open(index_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // 映射建立后可以关闭文件描述符
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    mapped_ = mapped;
+    mapped_size_ = size;
+    
+    const Header* header = static_cast<const Header*>(mapped);
+    // 各段长度来自文件内容，先逐段对照剩余大小再相乘相加，损坏或伪造的索引不能让计算回绕后通过校验
+    size_t remaining = size - sizeof(Header);
+    bool valid = std::memcmp(header->magic, kSeekIndexMagic, sizeof(kSeekIndexMagic)) == 0 &&
+                 header->version == kSeekIndexVersion &&
+                 header->header_size == sizeof(Header) &&
+                 header->file_size == file_size &&
+                 header->file_mtime_ns == file_mtime_ns &&
+                 header->stream_index >= 0 &&
+                 static_cast<uint32_t>(header->stream_index) < header->nb_streams &&
+                 header->nb_streams <= remaining / sizeof(StreamRecord);
+    if (valid) {
+        remaining -= header->nb_streams * sizeof(StreamRecord);
+        valid = header->extradata_bytes <= remaining && header->extradata_bytes % 8 == 0;
+    }
+    if (valid) {
+        remaining -= static_cast<size_t>(header->extradata_bytes);
+        valid = header->keyframe_count <= remaining / sizeof(KeyframeEntry) &&
+                remaining == header->keyframe_count * sizeof(KeyframeEntry);
+    }
+    const uint8_t* base = static_cast<const uint8_t*>(mapped);
+    const StreamRecord* streams = reinterpret_cast<const StreamRecord*>(base + sizeof(Header));
+    for (uint32_t i = 0; valid && i < header->nb_streams; ++i) {
+        valid = streams[i].extradata_offset <= header->extradata_bytes &&
+                streams[i].extradata_size <= header->extradata_bytes - streams[i].extradata_offset;
+    }
+    if (!valid) {
+        // 视频文件已变化或索引损坏：作废，由调用者重建
+        reset();
+        return false;
+    }
+    const size_t records_bytes = header->nb_streams * sizeof(StreamRecord);
+    header_ = header;
+    streams_ = streams;
+    extradata_ = base + sizeof(Header) + records_bytes;
+    keyframes_ = reinterpret_cast<const KeyframeEntry*>(extradata_ + header->extradata_bytes);
+    return true;
+#endif
+}
+
+bool SeekIndex::build(const AVFormatContext* format_ctx, int stream_index, const std::string& file_path) {
+#if PLATFORM_WIN
+    return false;
+#else
+    if (!format_ctx || stream_index < 0 || stream_index >= static_cast<int>(format_ctx->nb_streams)) {
+        return false;
+    }
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    if (!statFile(file_path, header.file_size, header.file_mtime_ns)) {
+        return false;
+    }
+    
+    std::memcpy(header.magic, kSeekIndexMagic, sizeof(kSeekIndexMagic));
+    header.version = kSeekIndexVersion;
+    header.header_size = sizeof(Header);
+    // "mov,mp4,m4a,3gp,3g2,mj2" 只取第一个短名，av_find_input_format 才能识别
+    const char* name = format_ctx->iformat ? format_ctx->iformat->name : "";
+    const size_t name_len = std::min(std::strcspn(name, ","), sizeof(header.format_name) - 1);
+    std::memcpy(header.format_name, name, name_len);
+    header.stream_index = stream_index;
+    header.nb_streams = format_ctx->nb_streams;
+    
+    // 每个流一条参数记录：音频流同样依赖探包（采样率、声道布局、帧长），只记视频流会让音频解码器拿到不完整的参数
+    std::vector<StreamRecord> records(format_ctx->nb_streams);
+    std::vector<uint8_t> extradata;
+    for (unsigned int i = 0; i < format_ctx->nb_streams; ++i) {
+        const AVStream* stream = format_ctx->streams[i];
+        const AVCodecParameters* codec_par = stream->codecpar;
+        StreamRecord& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+        record.codec_type = codec_par->codec_type;
+        record.codec_id = codec_par->codec_id;
+        record.format = codec_par->format;
+        record.width = codec_par->width;
+        record.height = codec_par->height;
+        record.profile = codec_par->profile;
+        record.level = codec_par->level;
+        record.time_base_num = stream->time_base.num;
+        record.time_base_den = stream->time_base.den;
+        record.frame_rate_num = stream->avg_frame_rate.num;
+        record.frame_rate_den = stream->avg_frame_rate.den;
+        record.r_frame_rate_num = stream->r_frame_rate.num;
+        record.r_frame_rate_den = stream->r_frame_rate.den;
+        record.sar_num = codec_par->sample_aspect_ratio.num;
+        record.sar_den = codec_par->sample_aspect_ratio.den;
+        record.video_delay = codec_par->video_delay;
+        record.field_order = codec_par->field_order;
+        record.sample_rate = codec_par->sample_rate;
+        record.channels = codec_par->ch_layout.nb_channels;
+        record.channel_order = codec_par->ch_layout.order;
+        record.channel_mask = codec_par->ch_layout.order == AV_CHANNEL_ORDER_NATIVE ? codec_par->ch_layout.u.mask : 0;
+        record.frame_size = codec_par->frame_size;
+        record.initial_padding = codec_par->initial_padding;
+        record.start_time = stream->start_time;
+        record.duration = stream->duration;
+        record.bit_rate = codec_par->bit_rate;
+        if (codec_par->extradata && codec_par->extradata_size > 0) {
+            record.extradata_offset = static_cast<uint32_t>(extradata.size());
+            record.extradata_size = static_cast<uint32_t>(codec_par->extradata_size);
+            extradata.insert(extradata.end(), codec_par->extradata, codec_par->extradata + codec_par->extradata_size);
+            extradata.resize(alignTo8(extradata.size()), 0);
+        }
+    }
+    header.extradata_bytes = extradata.size();
+    
+    // 关键帧表：来自容器索引（MP4 的 stss），不额外读文件
+    std::vector<KeyframeEntry> entries;
+    AVStream* stream = format_ctx->streams[stream_index];
+    const int count = avformat_index_get_entries_count(stream);
+    for (int i = 0; i < count; ++i) {
+        const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME)) {
+            entries.push_back({entry->timestamp});
+        }
+    }
+    header.keyframe_count = entries.size();
+    
+    // 先写临时文件再 rename，避免并发打开时读到半个索引
+    const std::string index_path = sidecarPath(file_path);
+    const std::string tmp_path = index_path + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        LOG_WARN("旁路索引写入失败（无法创建文件）：" + tmp_path);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !records.empty()) {
+        ok = fwrite(records.data(), sizeof(StreamRecord), records.size(), file) == records.size();
+    }
+    if (ok && !extradata.empty()) {
+        ok = fwrite(extradata.data(), extradata.size(), 1, file) == 1;
+    }
+    if (ok && !entries.empty()) {
+        ok = fwrite(entries.data(), sizeof(KeyframeEntry), entries.size(), file) == entries.size();
+    }
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmp_path.c_str(), index_path.c_str()) != 0) {
+        LOG_WARN("旁路索引写入失败：" + index_path);
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool SeekIndex::restoreStream(AVStream* stream, const StreamRecord& record, const uint8_t* extradata) {
+    AVCodecParameters* codec_par = stream->codecpar;
+    codec_par->codec_type = static_cast<AVMediaType>(record.codec_type);
+    codec_par->codec_id = static_cast<AVCodecID>(record.codec_id);
+    if (codec_par->format < 0) {
+        codec_par->format = record.format;
+    }
+    if (codec_par->profile < 0) {
+        codec_par->profile = record.profile;
+    }
+    if (codec_par->level < 0) {
+        codec_par->level = record.level;
+    }
+    if (codec_par->bit_rate <= 0) {
+        codec_par->bit_rate = record.bit_rate;
+    }
+    if (!codec_par->extradata && record.extradata_size > 0) {
+        codec_par->extradata = static_cast<uint8_t*>(av_mallocz(record.extradata_size + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!codec_par->extradata) {
+            return false;
+        }
+        std::memcpy(codec_par->extradata, extradata + record.extradata_offset, record.extradata_size);
+        codec_par->extradata_size = static_cast<int>(record.extradata_size);
+    }
+    if (codec_par->codec_type == AVMEDIA_TYPE_VIDEO) {
+        if (codec_par->width <= 0 || codec_par->height <= 0) {
+            codec_par->width = record.width;
+            codec_par->height = record.height;
+        }
+        // 重排序延迟：探包时由解码器得出，不恢复的话解码器按 0 延迟起步，与正常打开的输出节奏不一致
+        if (codec_par->video_delay <= 0) {
+            codec_par->video_delay = record.video_delay;
+        }
+        if (codec_par->field_order == AV_FIELD_UNKNOWN) {
+            codec_par->field_order = static_cast<AVFieldOrder>(record.field_order);
+        }
+        if (codec_par->sample_aspect_ratio.num == 0 && record.sar_den != 0) {
+            codec_par->sample_aspect_ratio = AVRational{record.sar_num, record.sar_den};
+        }
+        if (stream->avg_frame_rate.num == 0 && record.frame_rate_den != 0) {
+            stream->avg_frame_rate = AVRational{record.frame_rate_num, record.frame_rate_den};
+        }
+        if (stream->r_frame_rate.num == 0 && record.r_frame_rate_den != 0) {
+            stream->r_frame_rate = AVRational{record.r_frame_rate_num, record.r_frame_rate_den};
+        }
+    } else if (codec_par->codec_type == AVMEDIA_TYPE_AUDIO) {
+        if (codec_par->sample_rate <= 0) {
+            codec_par->sample_rate = record.sample_rate;
+        }
+        if (codec_par->ch_layout.nb_channels <= 0 && record.channels > 0) {
+            av_channel_layout_uninit(&codec_par->ch_layout);
+            if (record.channel_order == AV_CHANNEL_ORDER_NATIVE && record.channel_mask != 0) {
+                av_channel_layout_from_mask(&codec_par->ch_layout, record.channel_mask);
+            } else {
+                av_channel_layout_default(&codec_par->ch_layout, record.channels);
+            }
+        }
+        if (codec_par->frame_size <= 0) {
+            codec_par->frame_size = record.frame_size;
+        }
+        if (codec_par->initial_padding <= 0) {
+            codec_par->initial_padding = record.initial_padding;
+        }
+    }
+    if (stream->start_time == AV_NOPTS_VALUE) {
+        stream->start_time = record.start_time;
+    }
+    if (stream->duration == AV_NOPTS_VALUE) {
+        stream->duration = record.duration;
+    }
+    return true;
+}
+
+bool SeekIndex::applyTo(AVFormatContext* format_ctx) const {
+    if (!header_ || !format_ctx || format_ctx->nb_streams != header_->nb_streams) {
+        return false;
+    }
+    // 先全部校验再修改：任何一个流对不上都整体放弃，由调用者照常探测
+    for (unsigned int i = 0; i < format_ctx->nb_streams; ++i) {
+        const AVCodecParameters* codec_par = format_ctx->streams[i]->codecpar;
+        const StreamRecord& record = streams_[i];
+        if ((codec_par->codec_type != AVMEDIA_TYPE_UNKNOWN && codec_par->codec_type != record.codec_type) ||
+            (codec_par->codec_id != AV_CODEC_ID_NONE && codec_par->codec_id != record.codec_id)) {
+            return false;
+        }
+    }
+    if (streams_[header_->stream_index].codec_type != AVMEDIA_TYPE_VIDEO) {
+        return false;
+    }
+    for (unsigned int i = 0; i < format_ctx->nb_streams; ++i) {
+        if (!restoreStream(format_ctx->streams[i], streams_[i], extradata_)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int SeekIndex::streamIndex() const {
+    return header_ ? header_->stream_index : -1;
+}
+
+const char* SeekIndex::formatName() const {
+    return header_ ? header_->format_name : "";
+}
+
+size_t SeekIndex::keyframeCount() const {
+    return header_ ? static_cast<size_t>(header_->keyframe_count) : 0;
+}
+
+const SeekIndex::KeyframeEntry* SeekIndex::keyframeBefore(int64_t timestamp) const {
+    const size_t count = keyframeCount();
+    if (count == 0) {
+        return nullptr;
+    }
+    // 关键帧表按 dts 升序：找第一个大于 timestamp 的，再退一个
+    const KeyframeEntry* end = keyframes_ + count;
+    const KeyframeEntry* it = std::upper_bound(keyframes_, end, timestamp,
+                                               [](int64_t ts, const KeyframeEntry& entry) { return ts < entry.dts; });
+    return it == keyframes_ ? nullptr : it - 1;
+}
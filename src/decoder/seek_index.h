@@ -0,0 +1,89 @@
+//
+//  seek_index.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SEEK_INDEX_H
+#define SEEK_INDEX_H
+
+#include <string>
+#include <cstdint>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+/**
+ * 旁路索引文件（<视频文件>.idx）：首次打开时生成，之后打开时 mmap 读取
+ * 记录所有流的参数（音频流的采样率、声道布局、帧长等同样要靠探包得到）和视频流的关键帧表（dts；
+ * 跳转由 av_seek_frame 按时间戳完成，不需要字节偏移），再次打开时跳过格式探测和 avformat_find_stream_info，
+ * 关键帧查找直接走 mmap 的表；视频文件大小或修改时间变化时自动失效重建
+ * @note MP4 的 moov 仍由 libavformat 解析（读包需要 sample 表），索引省掉的是探测和解码探包的开销
+ */
+class SeekIndex {
+public:
+    // 关键帧表项
+    struct KeyframeEntry {
+        int64_t dts;    // 解码时间戳（容器索引的 AVIndexEntry::timestamp，视频流 time_base；有 B 帧时不等于 pts）
+    };
+    
+    SeekIndex() = default;
+    ~SeekIndex();
+    
+    SeekIndex(const SeekIndex&) = delete;
+    SeekIndex& operator=(const SeekIndex&) = delete;
+    
+    // 旁路索引文件路径
+    static std::string sidecarPath(const std::string& file_path);
+    
+    /**
+     * mmap 加载旁路索引并校验（文件大小 + 修改时间）
+     * @return 索引存在且有效返回true
+     */
+    bool load(const std::string& file_path);
+    
+    /**
+     * 从已完成探测的 AVFormatContext 生成旁路索引并写盘（先写临时文件再 rename）
+     * @param stream_index 记录关键帧表的视频流（其余流只记录参数）
+     * @return 成功返回true；写盘失败（如只读目录）不影响播放
+     */
+    bool build(const AVFormatContext* format_ctx, int stream_index, const std::string& file_path);
+    
+    /**
+     * 把索引中各个流的参数填入刚打开（未探测）的 AVFormatContext
+     * @return 流数量、各流类型和编码格式都匹配返回true；返回false时调用者需要照常 avformat_find_stream_info
+     */
+    bool applyTo(AVFormatContext* format_ctx) const;
+    
+    // 释放 mmap
+    void reset();
+    
+    bool isLoaded() const { return header_ != nullptr; }
+    int streamIndex() const;
+    // 索引记录的容器格式短名（如 "mov"），用于跳过格式探测
+    const char* formatName() const;
+    
+    const KeyframeEntry* keyframes() const { return keyframes_; }
+    size_t keyframeCount() const;
+    
+    // dts 在 timestamp 之前（含）最近的关键帧，没有返回 nullptr
+    const KeyframeEntry* keyframeBefore(int64_t timestamp) const;
+    
+private:
+    struct Header;
+    struct StreamRecord;
+    
+    // 只补齐容器头里没有的参数（这些原本要靠 avformat_find_stream_info 解码探包得到）
+    static bool restoreStream(AVStream* stream, const StreamRecord& record, const uint8_t* extradata);
+    
+    const Header* header_ = nullptr;            // 指向 mmap 区域
+    const StreamRecord* streams_ = nullptr;     // 指向 mmap 区域（header_->nb_streams 个）
+    const uint8_t* extradata_ = nullptr;        // 指向 mmap 区域（各流 extradata 依次存放）
+    const KeyframeEntry* keyframes_ = nullptr;  // 指向 mmap 区域
+    void* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+};
+
+#endif /* SEEK_INDEX_H */
@@ -8,52 +8,89 @@
 
 #include "video_decoder.h"
 #include <thread>
+#include <cstring>
+#include <algorithm>
 #include <opencv2/opencv.hpp>
+#include "../core/demuxer.h"
 #include "../common/log/log.h"
+#include "../util/frame/display_rotation.h"
+
+extern "C" {
+#include <libavutil/motion_vector.h>
+}
+
+// FFmpeg 中支持 AV_CODEC_FLAG2_EXPORT_MVS 的软件解码器（H.264 和 mpegvideo 系列；HEVC/VP9/AV1 不支持）
+static bool codecExportsMotionVectors(AVCodecID codec_id) {
+    switch (codec_id) {
+        case AV_CODEC_ID_H264:
+        case AV_CODEC_ID_MPEG1VIDEO:
+        case AV_CODEC_ID_MPEG2VIDEO:
+        case AV_CODEC_ID_MPEG4:
+        case AV_CODEC_ID_H263:
+        case AV_CODEC_ID_H263P:
+        case AV_CODEC_ID_FLV1:
+        case AV_CODEC_ID_MSMPEG4V1:
+        case AV_CODEC_ID_MSMPEG4V2:
+        case AV_CODEC_ID_MSMPEG4V3:
+        case AV_CODEC_ID_WMV1:
+        case AV_CODEC_ID_WMV2:
+            return true;
+        default:
+            return false;
+    }
+}
 
 VideoDecoder::~VideoDecoder() {
     close();  // 确保 close() 中释放 mid_frame_
 }
 
-VideoDecoder::VideoDecoder(PlayerContext& ctx) : packet_(av_packet_alloc(),[](AVPacket *pkt){
-    av_packet_free(&pkt);
-}),ctx_(ctx){
-    if (!packet_) {
-        error_msg_ = "AVPacket 内存分配失败";
+VideoDecoder::VideoDecoder(PlayerContext& ctx) : ctx_(ctx), decoded_frame_(av_frame_alloc(),[](AVFrame *frame){
+    av_frame_free(&frame);
+}), sw_frame_(av_frame_alloc(),[](AVFrame *frame){
+    av_frame_free(&frame);
+}){
+    if (!decoded_frame_ || !sw_frame_) {
+        error_msg_ = "AVFrame 内存分配失败";
     }
 }
 
-bool VideoDecoder::openVideoDecoder(const std::string& file_path) {
-    if (!packet_) {
-        error_msg_ = "AVPacket 内存分配失败";
-        return false;
+bool VideoDecoder::openVideoDecoder(const uint8_t* data, size_t size) {
+    if (!ctx_.demuxer) {
+        ctx_.demuxer = std::make_shared<Demuxer>(ctx_);
     }
-    // 打开文件路径
-    if(file_path.empty()){
-        error_msg_ = "文件路径为空！！！";
+    if (!ctx_.demuxer->openBuffer(data, size)) {
+        error_msg_ = ctx_.demuxer->getErrorMsg();
         return false;
     }
-    int ret = avformat_open_input(&ctx_.format_ctx, file_path.c_str(), nullptr, nullptr);
-    if (ret != 0) {
-        error_msg_ = "打开文件失败："+std::string(av_err2str(ret));
+    // 文件已由 demuxer 打开，后续流程与按路径打开相同
+    return openVideoDecoder(std::string());
+}
+
+bool VideoDecoder::openVideoDecoder(const std::string& file_path) {
+    if (!decoded_frame_ || !sw_frame_) {
+        error_msg_ = "AVFrame 内存分配失败";
         return false;
     }
-    // 获取流信息（必须调用，否则无法找到视频流）
-    ret = avformat_find_stream_info(ctx_.format_ctx, nullptr);
-    if (ret < 0) {
-        error_msg_ = "获取流信息失效：" + std::string(av_err2str(ret));
-        close();
+    adaptive_skip_stats_ = AdaptiveSkipStats();
+    packets_since_switch_ = 0;
+    // 文件由 demuxer 打开（已打开时直接复用，音视频解码器共享同一个 AVFormatContext）
+    if (!ctx_.demuxer) {
+        ctx_.demuxer = std::make_shared<Demuxer>(ctx_);
+        ctx_.demuxer->setSeekIndexEnabled(seek_index_enabled_);
+        ctx_.demuxer->setMmapIOEnabled(mmap_io_enabled_);
+    }
+    if (ctx_.format_ctx && !file_path.empty() && file_path != ctx_.demuxer->filePath()) {
+        // 共享的 demuxer 已打开其他文件：不能悄悄解码旧文件
+        error_msg_ = "打开失败：上下文已打开其他文件（" + ctx_.demuxer->filePath() + "），请先关闭 demuxer";
         return false;
     }
-    
-    // 查找视频流索引（遍历所有流，找到类型为 AVMEDIA_TYPE_VIDEO 的流）
-    for (unsigned int i = 0; i < ctx_.format_ctx->nb_streams; i++) {
-        if (ctx_.format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-            video_stream_index_ = i;
-            break;
-        }
+    if (!ctx_.format_ctx && !ctx_.demuxer->open(file_path)) {
+        error_msg_ = ctx_.demuxer->getErrorMsg();
+        return false;
     }
     
+    // 查找视频流索引
+    video_stream_index_ = ctx_.demuxer->findStream(AVMEDIA_TYPE_VIDEO);
     if (video_stream_index_ == -1) {
         // 没找到视频流
         error_msg_ = "没有视频流";
@@ -61,6 +98,26 @@ bool VideoDecoder::openVideoDecoder(const std::string& file_path) {
         return false;
     }
     
+    // 订阅视频流：demuxer 线程只把视频包送进这个队列
+    packet_queue_ = ctx_.demuxer->subscribe(video_stream_index_);
+    if (!packet_queue_) {
+        error_msg_ = ctx_.demuxer->getErrorMsg();
+        close();
+        return false;
+    }
+    
+    // 显示矩阵（手机拍摄的视频带 90/180/270 度旋转）
+    const AVStream* video_stream = ctx_.format_ctx->streams[video_stream_index_];
+    size_t matrix_size = 0;
+    const uint8_t* matrix = av_stream_get_side_data(video_stream, AV_PKT_DATA_DISPLAYMATRIX, &matrix_size);
+    if (matrix && matrix_size >= sizeof(display_matrix_)) {
+        memcpy(display_matrix_, matrix, sizeof(display_matrix_));
+        rotation_ = DisplayRotation::fromMatrix(display_matrix_);
+    } else {
+        memset(display_matrix_, 0, sizeof(display_matrix_));
+        rotation_ = 0;
+    }
+    
     // 根据视频流参数，查找对应的解码器
     AVCodecParameters* codec_par = ctx_.format_ctx->streams[video_stream_index_]->codecpar;
     codec_ = avcodec_find_decoder(codec_par->codec_id);
@@ -70,13 +127,31 @@ bool VideoDecoder::openVideoDecoder(const std::string& file_path) {
         return false;
     }
     
+    if (export_mvs_ && !codecExportsMotionVectors(codec_par->codec_id)) {
+        // 不中止打开：帧的 motionScore 保持未知（-1），运动门控会照常推理
+        LOG_WARN("解码器 " + std::string(codec_->name) + " 不支持导出运动矢量，运动量将一直未知");
+    }
+    
+    // 打开后不能修改的线程数和 lowres 都是复用 Key 的一部分，先算出来
+    const int thread_count = thread_count_ > 0 ? thread_count_ : static_cast<int>(std::thread::hardware_concurrency());
+    if (context_pool_) {
+        pool_key_ = DecoderContextPool::makeKey(codec_par, thread_count, hw_accel_enabled_,
+                                                analysisLowres(codec_par->width, codec_par->height));
+        codec_ctx_ = context_pool_->acquire(pool_key_);
+        if (codec_ctx_) {
+            // 命中：已打开的上下文只需更新与文件相关的参数
+            resetPooledContext(codec_par);
+            return true;
+        }
+    }
+    
     codec_ctx_ = avcodec_alloc_context3(codec_);
     if (!codec_ctx_) {
         error_msg_ = "分配解码器上下文失败";
         close();
         return false;
     }
-    ret = avcodec_parameters_to_context(codec_ctx_, codec_par);
+    int ret = avcodec_parameters_to_context(codec_ctx_, codec_par);
     if (ret < 0) {
         error_msg_ = "复制流参数到解码器上下文失败：" + std::string(av_err2str(ret));
         close();
@@ -86,33 +161,42 @@ bool VideoDecoder::openVideoDecoder(const std::string& file_path) {
     // 打开解码器前添加（需要FFmpeg编译时支持对应硬件加速）
     AVDictionary* codec_options = nullptr; // 用于存储解码器选项
     AVBufferRef* hw_device_ctx = nullptr; // 硬件设备上下文
+    if (hw_accel_enabled_) {
 #ifdef __APPLE__
-    ret = av_hwdevice_ctx_create(&hw_device_ctx, AV_HWDEVICE_TYPE_VIDEOTOOLBOX, nullptr, nullptr, 0);
-    if (ret < 0) {
-        error_msg_ = "创建VideoToolbox硬件设备上下文失败：" +std::string(av_err2str(ret));
-        // 不终止，继续尝试软件解码
-    } else {
-        // 将硬件设备上下文关联到解码器
-        codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx);
-        av_dict_set(&codec_options, "hwaccel", "videotoolbox", 0);
-    }
+        ret = av_hwdevice_ctx_create(&hw_device_ctx, AV_HWDEVICE_TYPE_VIDEOTOOLBOX, nullptr, nullptr, 0);
+        if (ret < 0) {
+            error_msg_ = "创建VideoToolbox硬件设备上下文失败：" +std::string(av_err2str(ret));
+            // 不终止，继续尝试软件解码
+        } else {
+            // 将硬件设备上下文关联到解码器
+            codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx);
+            av_dict_set(&codec_options, "hwaccel", "videotoolbox", 0);
+        }
 #elif _WIN32
-    // Windows类似逻辑（d3d11va）
-    ret = av_hwdevice_ctx_create(&hw_device_ctx, AV_HWDEVICE_TYPE_D3D11VA, nullptr, nullptr, 0);
-    if (ret >= 0) {
-        codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx);
-        av_dict_set(&options, "hwaccel", "d3d11va", 0);
-    }
+        // Windows类似逻辑（d3d11va）
+        ret = av_hwdevice_ctx_create(&hw_device_ctx, AV_HWDEVICE_TYPE_D3D11VA, nullptr, nullptr, 0);
+        if (ret >= 0) {
+            codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx);
+            av_dict_set(&codec_options, "hwaccel", "d3d11va", 0);
+        }
 #elif __linux__
-    // Linux VAAPI逻辑
-    ret = av_hwdevice_ctx_create(&hw_device_ctx, AV_HWDEVICE_TYPE_VAAPI, nullptr, nullptr, 0);
-    if (ret >= 0) {
-        codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx);
-        av_dict_set(&codec_options, "hwaccel", "vaapi", 0);
-    }
+        // Linux VAAPI逻辑
+        ret = av_hwdevice_ctx_create(&hw_device_ctx, AV_HWDEVICE_TYPE_VAAPI, nullptr, nullptr, 0);
+        if (ret >= 0) {
+            codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx);
+            av_dict_set(&codec_options, "hwaccel", "vaapi", 0);
+        }
 #endif
-    // 打开解码器前设置线程数（建议为 CPU 核心数，避免过度并行）
-    codec_ctx_->thread_count = std::thread::hardware_concurrency();
+    }
+    // 关键帧模式：解码器内部也跳过非关键帧
+    codec_ctx_->skip_frame = currentSkipFrame();
+    if (export_mvs_) {
+        codec_ctx_->flags2 |= AV_CODEC_FLAG2_EXPORT_MVS;
+    }
+    applyDecodeProfile();
+    
+    // 打开解码器前设置线程数（默认为 CPU 核心数，避免过度并行）
+    codec_ctx_->thread_count = thread_count;
     codec_ctx_->thread_type = FF_THREAD_FRAME; // 按帧并行（适合视频）
     
     // 打开解码器（最终准备就绪，可以开始解码）
@@ -143,13 +227,75 @@ bool VideoDecoder::openVideoDecoder(const std::string& file_path) {
     // 6. 验证硬件加速是否生效（更准确的判断方式）
     if (codec_ctx_->hwaccel || codec_ctx_->hw_device_ctx) {
         std::cout << "硬件加速解码已启用（类型：" << (codec_ctx_->hwaccel ? codec_ctx_->hwaccel->name : "videotoolbox") << "）" << std::endl;
+        if (export_mvs_) {
+            LOG_WARN("硬件解码不导出运动矢量，运动量将一直未知");
+        }
     } else {
         std::cout << "使用软件解码" << std::endl;
     }
     return true;
 }
 
+void VideoDecoder::applyDecodeProfile() {
+    if (decode_profile_ != DecodeProfile::ANALYSIS) {
+        return;
+    }
+    // 去块滤波约占 H.264 解码时间的 20~30%，分类结果对块效应不敏感
+    codec_ctx_->skip_loop_filter = AVDISCARD_ALL;
+    // 非参考帧跳过 IDCT（误差不会传播到其他帧）
+    codec_ctx_->skip_idct = AVDISCARD_NONREF;
+    // 允许不符合标准的加速技巧
+    codec_ctx_->flags2 |= AV_CODEC_FLAG2_FAST;
+    
+    codec_ctx_->lowres = analysisLowres(codec_ctx_->width, codec_ctx_->height);
+    LOG_INFO("分析档解码：skip_loop_filter=all, skip_idct=nonref, lowres=" + std::to_string(codec_ctx_->lowres));
+}
+
+int VideoDecoder::analysisLowres(int width, int height) const {
+    if (decode_profile_ != DecodeProfile::ANALYSIS || !codec_) {
+        return 0;
+    }
+    // lowres：解码器直接输出 1/2^n 分辨率，短边不低于 analysis_min_side_
+    int lowres = 0;
+    const int min_side = std::min(width, height);
+    while (lowres < codec_->max_lowres && (min_side >> (lowres + 1)) >= analysis_min_side_) {
+        ++lowres;
+    }
+    return lowres;
+}
+
+void VideoDecoder::resetPooledContext(const AVCodecParameters* codec_par) {
+    // 与文件相关、解码过程中才使用的参数（打开时才解析的参数已由复用 Key 保证一致）
+    codec_ctx_->pkt_timebase = ctx_.format_ctx->streams[video_stream_index_]->time_base;
+    codec_ctx_->sample_aspect_ratio = codec_par->sample_aspect_ratio;
+    codec_ctx_->color_range = codec_par->color_range;
+    codec_ctx_->color_primaries = codec_par->color_primaries;
+    codec_ctx_->color_trc = codec_par->color_trc;
+    codec_ctx_->colorspace = codec_par->color_space;
+    codec_ctx_->chroma_sample_location = codec_par->chroma_location;
+    codec_ctx_->field_order = codec_par->field_order;
+    
+    // 上一个使用者的解码选项恢复默认，再按当前设置重新应用
+    codec_ctx_->skip_frame = currentSkipFrame();
+    codec_ctx_->skip_loop_filter = AVDISCARD_DEFAULT;
+    codec_ctx_->skip_idct = AVDISCARD_DEFAULT;
+    codec_ctx_->flags2 &= ~(AV_CODEC_FLAG2_FAST | AV_CODEC_FLAG2_EXPORT_MVS);
+    if (export_mvs_) {
+        codec_ctx_->flags2 |= AV_CODEC_FLAG2_EXPORT_MVS;
+    }
+    applyDecodeProfile();
+}
+
 void VideoDecoder::close() {
+    if (packet_queue_ && ctx_.demuxer) {
+        ctx_.demuxer->unsubscribe(video_stream_index_);
+    }
+    packet_queue_ = nullptr;
+    if (codec_ctx_ && context_pool_ && avcodec_is_open(codec_ctx_)) {
+        // 放回池中供下一个文件复用（池负责 flush）
+        context_pool_->release(pool_key_, codec_ctx_);
+        codec_ctx_ = nullptr;
+    }
     if (codec_ctx_) {
         if (codec_ctx_->hw_device_ctx) {
             av_buffer_unref(&codec_ctx_->hw_device_ctx);
@@ -161,65 +307,348 @@ void VideoDecoder::close() {
 
     video_stream_index_ = -1;
     codec_ = nullptr;
+    rotation_ = 0;
     error_msg_.clear();    
 }
 
-MediaFramePtr VideoDecoder::getFrame() {
-    if (!ctx_.is_valid || !ctx_.format_ctx || !codec_ctx_ || video_stream_index_ < 0 || !packet_) {
+VideoFrame::Ptr VideoDecoder::getFrame() {
+    if (!ctx_.is_valid || !ctx_.format_ctx || !codec_ctx_ || video_stream_index_ < 0 || !packet_queue_ || !decoded_frame_) {
         error_msg_ = "解码器初始化参数无效";
         return nullptr;
     }
-    AVFrame* frame = av_frame_alloc();
+    // 首次取帧时启动解复用线程（已启动则无副作用）
+    if (!ctx_.demuxer->start()) {
+        error_msg_ = ctx_.demuxer->getErrorMsg();
+        return nullptr;
+    }
+    AVFrame* frame = decoded_frame_.get();
     
     while(true) {
-        // 读取一个数据包（压缩数据）
-        int ret = av_read_frame(ctx_.format_ctx, packet_.get());
-        if (ret < 0) {
-            // 读取完毕或者出错：尝试 flush 解码器中剩余的帧
-            avcodec_send_packet(codec_ctx_, nullptr);
-        }else {
-            // 只处理视频流的数据包
-            if (packet_->stream_index != video_stream_index_) {
-                av_packet_unref(packet_.get());
-                continue;
-            }
-            
-            // 将数据包发送到解码器
-            int send_ret = avcodec_send_packet(codec_ctx_, packet_.get());
-            if (send_ret < 0) {
-                error_msg_ = "发送数据包到解码器失败";
-                LOG_ERROR(error_msg_);
-                av_packet_unref(packet_.get());
-                return nullptr;
-            }
-            av_packet_unref(packet_.get());
-        }
-        ret = avcodec_receive_frame(codec_ctx_, frame);
-        MediaFramePtr media_frame;
+        // 先取解码器里已就绪的帧（一个包可能解出多帧）
+        int ret = avcodec_receive_frame(codec_ctx_, frame);
         if (ret == 0) {
-            try {
-                media_frame = MediaFrame::createFromAVFrame(frame);
-                return media_frame;
-            } catch (const std::exception& e) {
-                av_frame_free(&frame);
-                return nullptr;
-            }
-            
-        } else if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-            // EAGAIN: 需要更多数据；EOF: 解码器已无数据
-            if (ret == AVERROR_EOF) {
-                av_frame_free(&frame);
-                return nullptr;
-            }
-            continue;
-        }else {
+            VideoFrame::Ptr video_frame = wrapDecodedFrame(frame);
+            av_frame_unref(frame);
+            adaptive_skip_stats_.frames[adaptive_skip_stats_.level]++;
+            return video_frame;
+        } else if (ret == AVERROR_EOF) {
+            // 解码器已无数据
+            return nullptr;
+        } else if (ret != AVERROR(EAGAIN)) {
             // 其他错误
             error_msg_ = "解码失败，错误码: " + std::to_string(ret);
             LOG_ERROR(error_msg_);
-            av_frame_free(&frame);
             return nullptr;
         }
+        
+        // EAGAIN: 需要更多数据，从视频流队列取一个数据包（压缩数据）
+        PacketPtr packet;
+        if (!packet_queue_->pop(packet)) {
+            // 队列被中止（demuxer 停止）
+            error_msg_ = "数据包队列已中止";
+            return nullptr;
+        }
+        // 关键帧模式：非关键帧的包不送进解码器（省掉解析和解码的全部开销）
+        if (packet && decode_mode_ == DecodeMode::KEYFRAME_ONLY && !(packet->flags & AV_PKT_FLAG_KEY)) {
+            continue;
+        }
+        // 采样时：目标之前不被参考的帧（容器标记为 disposable）不需要解码
+        if (packet && skip_before_pts_ != AV_NOPTS_VALUE && (packet->flags & AV_PKT_FLAG_DISPOSABLE) &&
+            packet->pts != AV_NOPTS_VALUE && packet->pts < skip_before_pts_) {
+            continue;
+        }
+        if (packet && adaptive_skip_) {
+            updateAdaptiveSkip();
+        }
+        if (packet) {
+            adaptive_skip_stats_.packets[adaptive_skip_stats_.level]++;
+        }
+        // 空包是流结束标记：flush 解码器中剩余的帧
+        int send_ret = avcodec_send_packet(codec_ctx_, packet.get());
+        if (send_ret < 0 && send_ret != AVERROR_EOF) {
+            error_msg_ = "发送数据包到解码器失败";
+            LOG_ERROR(error_msg_);
+            return nullptr;
+        }
+        if (packet && packet->dts != AV_NOPTS_VALUE) {
+            last_sent_dts_ = packet->dts;
+        }
+    }
+}
+
+VideoFrame::Ptr VideoDecoder::wrapDecodedFrame(AVFrame* frame) {
+    AVFrame* src = frame;
+    // 硬件帧的数据在显存中，必须先下载到内存（这是唯一无法避免的拷贝）
+    if (frame->hw_frames_ctx) {
+        av_frame_unref(sw_frame_.get());
+        int ret = av_hwframe_transfer_data(sw_frame_.get(), frame, 0);
+        if (ret < 0) {
+            error_msg_ = saveError(ret, "硬件帧下载失败：");
+            LOG_ERROR(error_msg_);
+            return nullptr;
+        }
+        av_frame_copy_props(sw_frame_.get(), frame);
+        src = sw_frame_.get();
+    }
+    
+    applyDisplayMatrix(src);
+    
+    PixelFormat fmt = AVPixelFormatToPixelFormat(src->format);
+    if (fmt == PixelFormat::UNKNOWN) {
+        error_msg_ = "不支持的解码输出像素格式：" + std::to_string(src->format);
+        LOG_ERROR(error_msg_);
+        return nullptr;
+    }
+    
+    VideoFrame::Ptr video_frame = frame_pool_.acquire(src->width, src->height, fmt);
+    if (!video_frame->refAVFrame(src)) {
+        error_msg_ = "引用解码帧缓冲区失败";
+        LOG_ERROR(error_msg_);
+        frame_pool_.release(std::move(video_frame));
+        return nullptr;
+    }
+    av_frame_unref(sw_frame_.get());
+    
+    video_frame->setPts(src->best_effort_timestamp);
+    video_frame->setDts(src->pkt_dts);
+    video_frame->setDuration(static_cast<int>(src->duration));
+    video_frame->setStreamIndex(video_stream_index_);
+    if (export_mvs_) {
+        video_frame->setMotionScore(computeMotionScore(src));
+    }
+    return video_frame;
+}
+
+void VideoDecoder::applyDisplayMatrix(AVFrame* frame) {
+    if (!apply_display_matrix_) {
+        av_frame_remove_side_data(frame, AV_FRAME_DATA_DISPLAYMATRIX);
+        return;
+    }
+    if (rotation_ == 0 || av_frame_get_side_data(frame, AV_FRAME_DATA_DISPLAYMATRIX)) {
+        return;
+    }
+    // 副数据随 av_frame_ref 一起被 VideoFrame 引用，下游直接从 AVFrame 读取
+    AVFrameSideData* side_data = av_frame_new_side_data(frame, AV_FRAME_DATA_DISPLAYMATRIX, sizeof(display_matrix_));
+    if (side_data) {
+        memcpy(side_data->data, display_matrix_, sizeof(display_matrix_));
+    }
+}
+
+float VideoDecoder::computeMotionScore(const AVFrame* frame) {
+    if (frame->pict_type == AV_PICTURE_TYPE_I || frame->width <= 0 || frame->height <= 0) {
+        return -1.0f;
+    }
+    const AVFrameSideData* side_data = av_frame_get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
+    if (!side_data) {
+        // 没有运动矢量副数据不代表静止：解码器不支持导出、硬件解码、全帧内编码的 P 帧都会这样，运动量未知
+        return -1.0f;
+    }
+    const AVMotionVector* mvs = reinterpret_cast<const AVMotionVector*>(side_data->data);
+    const size_t count = side_data->size / sizeof(AVMotionVector);
+    double weighted = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const AVMotionVector& mv = mvs[i];
+        const int scale = mv.motion_scale > 0 ? mv.motion_scale : 1;
+        // L1 位移（像素），按块面积加权；B 帧的前后向矢量各算一次
+        const double displacement = (std::abs(mv.motion_x) + std::abs(mv.motion_y)) / static_cast<double>(scale);
+        weighted += displacement * mv.w * mv.h;
+    }
+    return static_cast<float>(weighted / (static_cast<double>(frame->width) * frame->height));
+}
+
+bool VideoDecoder::setExportMotionVectors(bool enabled) {
+    if (enabled) {
+        const bool hw_active = codec_ctx_ ? (codec_ctx_->hwaccel || codec_ctx_->hw_device_ctx) : hw_accel_enabled_;
+        if (hw_active) {
+            error_msg_ = "无法导出运动矢量：硬件解码不导出，请先 setHwAccelEnabled(false)";
+            LOG_WARN(error_msg_);
+            export_mvs_ = false;
+            return false;
+        }
+        if (codec_ && !codecExportsMotionVectors(codec_->id)) {
+            error_msg_ = "无法导出运动矢量：解码器 " + std::string(codec_->name) + " 不支持";
+            LOG_WARN(error_msg_);
+            export_mvs_ = false;
+            return false;
+        }
+    }
+    export_mvs_ = enabled;
+    if (codec_ctx_) {
+        // flags2 的 EXPORT_MVS 在输出帧时检查，打开后修改立即生效
+        if (enabled) {
+            codec_ctx_->flags2 |= AV_CODEC_FLAG2_EXPORT_MVS;
+        } else {
+            codec_ctx_->flags2 &= ~AV_CODEC_FLAG2_EXPORT_MVS;
+        }
+    }
+    return true;
+}
+
+void VideoDecoder::setAdaptiveSkipEnabled(bool enabled, const AdaptiveSkipConfig& config) {
+    adaptive_skip_ = enabled;
+    adaptive_skip_config_ = config;
+    if (!enabled) {
+        adaptive_skip_stats_.level = 0;
+    }
+    packets_since_switch_ = 0;
+    if (codec_ctx_) {
+        codec_ctx_->skip_frame = currentSkipFrame();
+    }
+}
+
+AdaptiveSkipStats VideoDecoder::adaptiveSkipStats() const {
+    AdaptiveSkipStats stats = adaptive_skip_stats_;
+    for (int i = 0; i < 3; ++i) {
+        stats.skipped[i] = std::max<int64_t>(0, stats.packets[i] - stats.frames[i]);
+    }
+    return stats;
+}
+
+AVDiscard VideoDecoder::currentSkipFrame() const {
+    static const AVDiscard kLevels[3] = {AVDISCARD_DEFAULT, AVDISCARD_NONREF, AVDISCARD_BIDIR};
+    if (decode_mode_ == DecodeMode::KEYFRAME_ONLY) {
+        return AVDISCARD_NONKEY;
+    }
+    return kLevels[adaptive_skip_stats_.level];
+}
+
+void VideoDecoder::updateAdaptiveSkip() {
+    packets_since_switch_++;
+    const size_t capacity = packet_queue_->capacity();
+    if (decode_mode_ == DecodeMode::KEYFRAME_ONLY || capacity == 0 ||
+        packets_since_switch_ < adaptive_skip_config_.min_dwell_packets) {
+        return;
+    }
+    const float backlog = static_cast<float>(packet_queue_->size()) / capacity;
+    int level = adaptive_skip_stats_.level;
+    if (backlog >= adaptive_skip_config_.high_watermark && level < 2) {
+        level++;
+        adaptive_skip_stats_.escalations++;
+    } else if (backlog <= adaptive_skip_config_.low_watermark && level > 0) {
+        level--;
+        adaptive_skip_stats_.relaxations++;
+    } else {
+        return;
+    }
+    adaptive_skip_stats_.level = level;
+    packets_since_switch_ = 0;
+    // skip_frame 在解码时读取，修改后下一个包立即生效
+    codec_ctx_->skip_frame = currentSkipFrame();
+}
+
+void VideoDecoder::setDecodeMode(DecodeMode mode) {
+    decode_mode_ = mode;
+    if (codec_ctx_) {
+        // skip_frame 在解码时读取，打开后修改立即生效
+        codec_ctx_->skip_frame = currentSkipFrame();
+    }
+}
+
+bool VideoDecoder::seekTo(int64_t pts) {
+    if (!ctx_.demuxer || !codec_ctx_ || video_stream_index_ < 0) {
+        error_msg_ = "跳转失败：解码器未打开";
+        return false;
+    }
+    if (!ctx_.demuxer->seek(video_stream_index_, pts, AVSEEK_FLAG_BACKWARD)) {
+        error_msg_ = ctx_.demuxer->getErrorMsg();
+        return false;
+    }
+    // 丢弃解码器内部缓存的跳转前的帧
+    avcodec_flush_buffers(codec_ctx_);
+    last_sent_dts_ = AV_NOPTS_VALUE;
+    return true;
+}
+
+bool VideoDecoder::sampleTimestamps(const std::vector<int64_t>& pts_list, const FrameCallback& callback) {
+    if (!codec_ctx_ || !callback) {
+        error_msg_ = "采样失败：解码器未打开或回调为空";
+        return false;
+    }
+    std::vector<int64_t> targets(pts_list);
+    std::sort(targets.begin(), targets.end());
+    
+    bool started = false;
+    size_t i = 0;
+    while (i < targets.size()) {
+        const int64_t target = targets[i];
+        // 目标之前最近的关键帧还没送进解码器：直接 seek，跳过中间整段 GOP
+        // 索引给出的是关键帧的 dts，解码位置也用已送入数据包的 dts 衡量，两边在同一时间域比较
+        const int64_t keyframe_dts = ctx_.demuxer->keyframeBefore(video_stream_index_, target);
+        const bool need_seek = !started ||
+            (keyframe_dts != AV_NOPTS_VALUE && (last_sent_dts_ == AV_NOPTS_VALUE || keyframe_dts > last_sent_dts_));
+        if (need_seek && !seekTo(target)) {
+            return false;
+        }
+        started = true;
+        
+        // 从关键帧向前解码到目标
+        skip_before_pts_ = target;
+        VideoFrame::Ptr frame;
+        while ((frame = getFrame())) {
+            if (frame->pts() != AV_NOPTS_VALUE && frame->pts() >= target) {
+                break;
+            }
+            frame_pool_.release(std::move(frame));
+        }
+        skip_before_pts_ = AV_NOPTS_VALUE;
+        if (!frame) {
+            // 文件结束，剩余的目标无法满足
+            return true;
+        }
+        
+        // 同一帧可能满足多个相邻目标（采样率高于视频帧率时），每帧只回调一次
+        while (i < targets.size() && targets[i] <= frame->pts()) {
+            ++i;
+        }
+        const bool keep_going = callback(frame);
+        frame_pool_.release(std::move(frame));
+        if (!keep_going) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool VideoDecoder::sampleAt(double fps, const FrameCallback& callback) {
+    if (fps <= 0) {
+        error_msg_ = "采样失败：采样帧率必须大于0";
+        return false;
+    }
+    if (!ctx_.format_ctx || video_stream_index_ < 0) {
+        error_msg_ = "采样失败：解码器未打开";
+        return false;
+    }
+    AVStream* stream = ctx_.format_ctx->streams[video_stream_index_];
+    const int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    int64_t duration = stream->duration;
+    if (duration == AV_NOPTS_VALUE || duration <= 0) {
+        // 流没有时长时用容器时长（AV_TIME_BASE 单位）换算
+        if (ctx_.format_ctx->duration == AV_NOPTS_VALUE) {
+            error_msg_ = "采样失败：无法获取视频时长";
+            return false;
+        }
+        duration = av_rescale_q(ctx_.format_ctx->duration, AV_TIME_BASE_Q, stream->time_base);
+    }
+    
+    // 采样间隔换算成流的 time_base
+    const AVRational interval = av_d2q(1.0 / fps, 1 << 24);
+    const int64_t step = std::max<int64_t>(1, av_rescale_q(1, interval, stream->time_base));
+    std::vector<int64_t> targets;
+    targets.reserve(static_cast<size_t>(duration / step) + 1);
+    for (int64_t pts = start; pts < start + duration; pts += step) {
+        targets.push_back(pts);
+    }
+    return sampleTimestamps(targets, callback);
+}
+
+void VideoDecoder::getTimeBase(int& num, int& den) {
+    if (!ctx_.format_ctx || video_stream_index_ < 0) {
+        error_msg_ = "获取时间基失败：未找到视频流";
+        return;
     }
+    AVRational time_base = ctx_.format_ctx->streams[video_stream_index_]->time_base;
+    num = time_base.num;
+    den = time_base.den;
 }
 
 void VideoDecoder::getVideoSize(int &width, int &height) {
@@ -10,6 +10,8 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <vector>
+#include <functional>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -22,14 +24,164 @@ extern "C" {
 #include "../common/media_frame.h"
 #include "../util/frame/frame_pool.h"
 #include "../core/player.h"
+#include "codec_utils.h"
+#include "decoder_context_pool.h"
+
+// 解码模式
+enum class DecodeMode {
+    ALL_FRAMES,     // 解码所有帧（默认）
+    KEYFRAME_ONLY   // 只解码关键帧（skip_frame = AVDISCARD_NONKEY），适合每个 GOP 只需要一个标签的离线分析
+};
+
+// 解码质量档位
+enum class DecodeProfile {
+    DEFAULT,    // 标准解码（逐像素精确）
+    ANALYSIS    // 分析档：跳过去块滤波、非参考帧跳过 IDCT、FLAG2_FAST、支持时用 lowres 低分辨率解码
+                // 画面最终都会缩到模型输入尺寸（如224x224），分类不需要逐像素精确
+};
+
+// 过载自适应丢帧参数（积压比例 = 视频数据包队列长度 / 队列容量）
+struct AdaptiveSkipConfig {
+    float high_watermark = 0.75f;   // 积压高于该比例升一档
+    float low_watermark = 0.25f;    // 积压低于该比例降一档
+    int min_dwell_packets = 16;     // 两次换档之间至少送入的数据包数（防止来回抖动）
+};
+
+// 过载丢帧统计，下标为档位：0 = AVDISCARD_DEFAULT，1 = AVDISCARD_NONREF，2 = AVDISCARD_BIDIR
+struct AdaptiveSkipStats {
+    int level = 0;                      // 当前档位
+    int64_t packets[3] = {0, 0, 0};     // 各档位下送入解码器的数据包数
+    int64_t frames[3] = {0, 0, 0};      // 各档位下解码输出的帧数
+    int64_t skipped[3] = {0, 0, 0};     // 各档位下解码器跳过的帧数（数据包数 - 输出帧数，帧线程的输出延迟在换档处有少量误差）
+    int escalations = 0;                // 升档次数
+    int relaxations = 0;                // 降档次数
+};
 
 class VideoDecoder {
 public:
+    // 采样回调：返回 false 停止采样；回调返回后帧会被归还帧池（需要保留请自行拷贝）
+    using FrameCallback = std::function<bool(const VideoFrame::Ptr& frame)>;
+    
     VideoDecoder(PlayerContext& ctx);
     ~VideoDecoder();
+    /**
+     * 打开视频解码器
+     * @param file_path 文件路径；ctx 中的 demuxer 已打开同一文件时直接复用（与音频解码器共用），
+     *                  已打开其他文件时返回false（需先 ctx.demuxer->close()），为空时复用已打开的输入
+     * @return 成功返回true
+     * @note 解码器订阅 demuxer 的视频流队列，首次 getFrame() 时自动启动解复用线程
+     */
     bool openVideoDecoder(const std::string& file_path);
+    /**
+     * 从内存缓冲区打开视频解码器（上游已在内存中的 MP4 数据无需先落盘）
+     * @param data 完整的媒体文件数据，调用者持有，必须在 close() 之前保持有效
+     * @param size 数据大小
+     * @return 成功返回true
+     */
+    bool openVideoDecoder(const uint8_t* data, size_t size);
     void close();
-    MediaFramePtr getFrame();
+    /**
+     * 解码下一帧（零拷贝：返回的帧直接引用解码器输出的缓冲区）
+     * @return 帧池中的视频帧，结束或失败返回 nullptr
+     * @note 用完后通过 framePool().release() 或 MediaFrameGuard 归还，归还时释放缓冲区引用
+     */
+    VideoFrame::Ptr getFrame();
+    MediaFramePool& framePool() { return frame_pool_; }
+    /**
+     * 设置解码模式（打开前后都可以设置）
+     * @note KEYFRAME_ONLY 下非关键帧的数据包在送入解码器前直接丢弃，P/B 帧完全不解码；
+     *       从 KEYFRAME_ONLY 切回 ALL_FRAMES 后，要到下一个关键帧画面才完整
+     */
+    void setDecodeMode(DecodeMode mode);
+    DecodeMode decodeMode() const { return decode_mode_; }
+    
+    // 解码线程数（打开前设置；0 表示 CPU 核心数）
+    void setThreadCount(int count) { thread_count_ = count; }
+    // 是否尝试硬件解码（打开前设置，默认开启）
+    void setHwAccelEnabled(bool enabled) { hw_accel_enabled_ = enabled; }
+    
+    // 启用旁路索引（需在 openVideoDecoder 之前调用；仅对由解码器自己打开的文件生效）
+    void setSeekIndexEnabled(bool enabled) { seek_index_enabled_ = enabled; }
+    // 本地文件使用 mmap 读取（需在 openVideoDecoder 之前调用，默认关闭）
+    void setMmapIOEnabled(bool enabled) { mmap_io_enabled_ = enabled; }
+    
+    /**
+     * 导出码流运动矢量（AV_CODEC_FLAG2_EXPORT_MVS），getFrame() 输出的帧带 motionScore()
+     * @return 启用了硬件解码，或（已打开时）解码器不支持导出时返回 false 且不启用
+     * @note 运动矢量来自码流解析，几乎没有额外开销；只有 H.264 和 MPEG-1/2/4 系列的软件解码器支持，
+     *       没有导出运动矢量的帧 motionScore() 为 -1（未知），不会被当作静止
+     */
+    bool setExportMotionVectors(bool enabled);
+    
+    /**
+     * 过载自适应丢帧：分析跟不上实时输入时，按视频数据包队列的积压程度逐级提高 skip_frame
+     * （AVDISCARD_DEFAULT -> AVDISCARD_NONREF -> AVDISCARD_BIDIR），积压消化后逐级恢复
+     * @param enabled 是否启用（打开前后都可以设置，默认关闭）
+     * @param config 换档水位和最短停留
+     * @note 在解码前丢帧，被丢的帧完全不解码；只适合直播/摄像头等实时输入，
+     *       本地文件的解复用线程总是跑在前面、队列常满，启用后会一直丢帧；KEYFRAME_ONLY 模式下不生效
+     */
+    void setAdaptiveSkipEnabled(bool enabled, const AdaptiveSkipConfig& config = AdaptiveSkipConfig());
+    AdaptiveSkipStats adaptiveSkipStats() const;
+    
+    /**
+     * 设置解码器上下文池（需在 openVideoDecoder 之前调用，默认不使用）
+     * @param pool 上下文池，由调用者持有，生命周期需长于解码器；nullptr 表示不使用
+     * @note 打开时优先从池中取参数相同的已打开上下文，close() 时放回池中
+     */
+    void setContextPool(DecoderContextPool* pool) { context_pool_ = pool; }
+    
+    /**
+     * 设置解码档位（打开前设置）
+     * @param profile 解码档位
+     * @param min_side ANALYSIS 档 lowres 缩小后短边不低于该值（一般为模型输入尺寸）
+     * @note lowres 只有部分解码器支持（MPEG-2/4、MJPEG 等，H.264/HEVC 不支持），
+     *       开启后 getFrame() 输出的宽高小于 getVideoSize()
+     */
+    void setDecodeProfile(DecodeProfile profile, int min_side = 224) {
+        decode_profile_ = profile;
+        analysis_min_side_ = min_side;
+    }
+    DecodeProfile decodeProfile() const { return decode_profile_; }
+    
+    /**
+     * 跳转到 pts 之前最近的关键帧，并清空解码器缓存
+     * @param pts 目标时间戳（视频流 time_base）
+     * @return 成功返回true
+     */
+    bool seekTo(int64_t pts);
+    
+    /**
+     * 按时间戳采样：对每个目标时间戳返回第一帧 pts >= 目标的画面
+     * @param pts_list 目标时间戳列表（视频流 time_base，内部会排序）
+     * @param callback 每采到一帧调用一次
+     * @return 成功返回true（到达文件末尾时剩余目标被忽略）
+     * @note 目标之前最近的关键帧在当前解码位置之后时直接 seek，中间整段 GOP 不读不解；
+     *       否则从当前位置向前解码，目标之前可丢弃（disposable）的帧不送入解码器
+     */
+    bool sampleTimestamps(const std::vector<int64_t>& pts_list, const FrameCallback& callback);
+    
+    /**
+     * 固定帧率采样（如 fps=1 表示每秒分析一帧）
+     * @param fps 采样帧率（> 0）
+     * @param callback 每采到一帧调用一次
+     * @return 成功返回true
+     */
+    bool sampleAt(double fps, const FrameCallback& callback);
+    
+    /**
+     * 显示矩阵中的旋转角度（顺时针 0/90/180/270，手机竖拍的视频一般为 90），打开后有效
+     * @note 解码输出仍是编码方向的画面；开启 setApplyDisplayMatrix 时流的显示矩阵会附到每一帧的副数据上，
+     *       FrameConverter / ImagePreprocessor 据此在缩放的同一遍中输出正确朝向
+     */
+    int getRotation() const { return rotation_; }
+    /**
+     * 是否把显示矩阵交给下游（默认开启）；关闭时去掉帧上的显示矩阵副数据，下游按编码方向输出
+     */
+    void setApplyDisplayMatrix(bool enabled) { apply_display_matrix_ = enabled; }
+    
+    // 视频流时间基（pts 单位）
+    void getTimeBase(int& num, int& den);
     void getVideoSize(int& width, int& height);
     std::string getErrorMsg();
     std::string getVideoCodecName();
@@ -42,14 +194,63 @@ private:
     int video_stream_index_ = -1;
     // 解码器(对应视频的解码器，如 H。264 解码器)
     const AVCodec *codec_ = nullptr;
+    // 解码模式（全部帧 / 只解关键帧）
+    DecodeMode decode_mode_ = DecodeMode::ALL_FRAMES;
+    // 解码线程数（0 表示 CPU 核心数）
+    int thread_count_ = 0;
+    // 是否尝试硬件解码
+    bool hw_accel_enabled_ = true;
+    bool seek_index_enabled_ = false;
+    bool mmap_io_enabled_ = false;
+    // 是否导出运动矢量
+    bool export_mvs_ = false;
+    // 解码器上下文池（不拥有）及当前上下文的复用 Key
+    DecoderContextPool* context_pool_ = nullptr;
+    DecoderContextPool::Key pool_key_;
+    // 过载自适应丢帧
+    bool adaptive_skip_ = false;
+    AdaptiveSkipConfig adaptive_skip_config_;
+    AdaptiveSkipStats adaptive_skip_stats_;
+    int packets_since_switch_ = 0;
+    // 解码档位
+    DecodeProfile decode_profile_ = DecodeProfile::DEFAULT;
+    int analysis_min_side_ = 224;
+    // 显示矩阵（来自流副数据）及其旋转角度
+    int32_t display_matrix_[9] = {0};
+    int rotation_ = 0;
+    bool apply_display_matrix_ = true;
+    // 最近送入解码器的数据包的 dts（与索引关键帧 dts 比较，判断是否需要跳过 GOP）
+    int64_t last_sent_dts_ = AV_NOPTS_VALUE;
+    // 早于该 pts 的可丢弃数据包不送入解码器（采样时使用）
+    int64_t skip_before_pts_ = AV_NOPTS_VALUE;
     // 错误信息（记录打开/解码过程中的错误，方便调试）
     std::string error_msg_;
-    // 数据包
-    std::unique_ptr<AVPacket,void(*)(AVPacket *)> packet_;
+    // 视频流的数据包队列（由 demuxer 填充，解码线程消费）
+    PacketQueue* packet_queue_ = nullptr;
+    // 解码输出帧（复用，内容转交给 VideoFrame 后 unref）
+    std::unique_ptr<AVFrame,void(*)(AVFrame *)> decoded_frame_;
+    // 硬件帧下载到内存用的中转帧
+    std::unique_ptr<AVFrame,void(*)(AVFrame *)> sw_frame_;
     
     MediaFramePool frame_pool_; //解码帧池
     
     const std::string saveError(int err_code, const std::string& prefix);
+    // 按解码档位设置解码器选项（avcodec_open2 之前调用）
+    void applyDecodeProfile();
+    // 分析档下的 lowres 值（其他档位为 0）
+    int analysisLowres(int width, int height) const;
+    // 从池中取出的上下文：更新与文件相关的参数并重新应用解码选项
+    void resetPooledContext(const AVCodecParameters* codec_par);
+    // 由运动矢量副数据计算运动量，帧内编码帧返回 -1
+    static float computeMotionScore(const AVFrame* frame);
+    // 当前应使用的 skip_frame（解码模式优先，其次是过载档位）
+    AVDiscard currentSkipFrame() const;
+    // 按队列积压调整过载档位（每送入一个数据包前调用）
+    void updateAdaptiveSkip();
+    // 把解码出的 AVFrame 包装成帧池中的 VideoFrame（不复制像素）
+    VideoFrame::Ptr wrapDecodedFrame(AVFrame* frame);
+    // 把流的显示矩阵附到帧副数据上（帧自带时保留），关闭时去掉
+    void applyDisplayMatrix(AVFrame* frame);
 };
 
 #endif /* DECODER_H_ */
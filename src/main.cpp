@@ -12,6 +12,8 @@
 // 用于控制台输出格式（可选，让结果更整齐）
 #include <iomanip>
 #include <thread>
+#include <map>
+#include <vector>
 
 #include "decoder/video_decoder.h"
 #include "util/frame/frame_pool.h"
@@ -20,7 +22,19 @@
 #include "common/data_structs.h"
 #include "render/render_factory.h"
 #include "util/frame/frame_converter.h"
+#include "ai/preprocess/image_preprocessor.h"
+#include "ai/preprocess/audio_preprocessor.h"
+#include "util/audio/sample_converter.h"
+#include "util/audio/resampler.h"
+#include "util/simd/cpu_features.h"
+#include <cmath>
 #include "common/media_frame.h"
+#include "ai/motion_gate.h"
+#include "util/frame/shot_detector.h"
+#include "ai/quality_gate.h"
+#include "util/thread/thread_pool.h"
+#include "ai/preprocess/batch_tensor_builder.h"
+#include "util/frame/save_image.h"
 
 using namespace std;
 
@@ -313,6 +327,772 @@ using namespace std;
 //    decoder.close();
 //}
 
+// ------------------------------
+// 解码档位对比：分析档 vs 默认档（解码帧率 + Top-1 一致率）
+// ------------------------------
+struct DecodeProfileStats {
+    int frames = 0;                          // 解码帧数
+    double decode_ms = 0;                    // 解码总耗时（不含转换和推理）
+    std::map<int64_t, std::string> labels;   // pts -> Top-1 类别
+};
+
+static DecodeProfileStats runDecodeProfile(const string& file_path, DecodeProfile profile,
+                                           AIInfer& infer_engine, int infer_interval) {
+    DecodeProfileStats stats;
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setDecodeProfile(profile);
+    decoder.setHwAccelEnabled(false); // 档位选项只对软件解码生效
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return stats;
+    }
+    
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    const int model_input_size = 224 * 224 * 3;
+    std::vector<float> model_input(model_input_size);
+    //AI模型归一化参数
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    
+    while (true) {
+        auto decode_start = std::chrono::high_resolution_clock::now();
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        auto decode_end = std::chrono::high_resolution_clock::now();
+        stats.decode_ms += std::chrono::duration<double,milli>(decode_end - decode_start).count();
+        if (!frame_guard.get()) {
+            break;
+        }
+        // 每 infer_interval 帧推理一次，两个档位抽到的是同样 pts 的帧
+        if (stats.frames++ % infer_interval != 0) {
+            continue;
+        }
+        if (!converter.convertCropResizeYuvToBgr(frame_guard->avFrame(), bgr_frame, 224, 224, ResizeMode::CROP) ||
+            !ImagePreprocessor::normalizeBGRFrame(bgr_frame, model_input.data(), mean, std)) {
+            continue;
+        }
+        AIResult ai_result = infer_engine.infer(model_input.data(), model_input_size);
+        stats.labels[frame_guard->pts()] = ai_result.class_name;
+    }
+    av_frame_free(&bgr_frame);
+    decoder.close();
+    return stats;
+}
+
+void benchDecodeProfile(const string& file_path) {
+    AIInfer infer_engine;
+    std::string model_path = "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/lib/models/mobilenetv2-12.onnx";
+    if (!infer_engine.init(model_path)) {
+        std::cerr << "AI模型初始化失败，退出测试" << std::endl;
+        return;
+    }
+    const int infer_interval = 10;
+    DecodeProfileStats base = runDecodeProfile(file_path, DecodeProfile::DEFAULT, infer_engine, infer_interval);
+    DecodeProfileStats fast = runDecodeProfile(file_path, DecodeProfile::ANALYSIS, infer_engine, infer_interval);
+    
+    int compared = 0, agreed = 0;
+    for (const auto& item : base.labels) {
+        auto it = fast.labels.find(item.first);
+        if (it == fast.labels.end()) {
+            continue;
+        }
+        compared++;
+        agreed += (it->second == item.second) ? 1 : 0;
+    }
+    
+    auto print_stats = [](const char* name, const DecodeProfileStats& stats) {
+        const double fps = stats.decode_ms > 0 ? stats.frames * 1000.0 / stats.decode_ms : 0;
+        std::cout << name << "：" << stats.frames << "帧，解码耗时=" << fixed << setprecision(2)
+        << stats.decode_ms << "ms，解码帧率=" << fps << "fps" << std::endl;
+    };
+    print_stats("默认档", base);
+    print_stats("分析档", fast);
+    std::cout << "Top-1 一致率：" << agreed << "/" << compared << " = " << fixed << setprecision(2)
+    << (compared > 0 ? agreed * 100.0 / compared : 0) << "%" << std::endl;
+    infer_engine.destroy();
+}
+
+struct BatchDecodeStats {
+    int clips = 0;              // 成功处理的文件数
+    int frames = 0;             // 解码帧数
+    double open_ms = 0;         // openVideoDecoder 总耗时
+    double total_ms = 0;        // 打开 + 解码 + 关闭总耗时
+};
+
+static BatchDecodeStats runBatchDecode(const vector<string>& clip_paths, DecoderContextPool* pool) {
+    BatchDecodeStats stats;
+    auto batch_start = std::chrono::high_resolution_clock::now();
+    for (const auto& clip_path : clip_paths) {
+        PlayerContext ctx;
+        VideoDecoder decoder(ctx);
+        decoder.setContextPool(pool);
+        auto open_start = std::chrono::high_resolution_clock::now();
+        bool opened = decoder.openVideoDecoder(clip_path);
+        auto open_end = std::chrono::high_resolution_clock::now();
+        stats.open_ms += std::chrono::duration<double,milli>(open_end - open_start).count();
+        if (!opened) {
+            std::cerr << "文件打开失败：" << clip_path << "，" << decoder.getErrorMsg() << std::endl;
+            continue;
+        }
+        while (true) {
+            MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+            if (!frame_guard.get()) {
+                break;
+            }
+            stats.frames++;
+        }
+        decoder.close();
+        stats.clips++;
+    }
+    auto batch_end = std::chrono::high_resolution_clock::now();
+    stats.total_ms = std::chrono::duration<double,milli>(batch_end - batch_start).count();
+    return stats;
+}
+
+// 批量短视频（1~3 秒、同编码同分辨率）：对比每个文件重建解码器和复用解码器上下文
+void benchBatchDecode(const vector<string>& clip_paths) {
+    BatchDecodeStats base = runBatchDecode(clip_paths, nullptr);
+    DecoderContextPool pool;
+    BatchDecodeStats pooled = runBatchDecode(clip_paths, &pool);
+    
+    auto print_stats = [](const char* name, const BatchDecodeStats& stats) {
+        const double open_us = stats.clips > 0 ? stats.open_ms * 1000.0 / stats.clips : 0;
+        std::cout << name << "：" << stats.clips << "个文件，" << stats.frames << "帧，平均打开耗时="
+        << fixed << setprecision(1) << open_us << "us，总耗时=" << setprecision(2) << stats.total_ms << "ms" << std::endl;
+    };
+    print_stats("每个文件重建解码器", base);
+    print_stats("复用解码器上下文", pooled);
+    std::cout << "上下文池命中=" << pool.hitCount() << "，未命中=" << pool.missCount() << std::endl;
+}
+
+// log-mel 前端开销：合成 60 秒 16kHz 音频，按 1024 点一帧流式输入，统计实时率（占单核的比例）
+void benchLogMel() {
+    LogMelConfig config;
+    LogMelExtractor extractor(config);
+    if (!extractor.isValid()) {
+        std::cerr << "log-mel 参数无效：" << extractor.getErrorMsg() << std::endl;
+        return;
+    }
+    const int seconds = 60;
+    std::vector<float> samples(config.sample_rate * seconds);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = 0.5f * std::sin(2.0f * 3.14159265f * 440.0f * i / config.sample_rate);
+    }
+    
+    const int tensor_frames = 96;   // 0.96 秒一个张量
+    const int tensor_hop = 48;      // 相邻张量重叠一半
+    std::vector<float> tensor(tensor_frames * config.num_mels);
+    int tensors = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t pos = 0; pos < samples.size(); pos += 1024) {
+        extractor.pushSamples(samples.data() + pos, std::min<size_t>(1024, samples.size() - pos));
+        while (extractor.readTensor(tensor.data(), tensor_frames, tensor_hop)) {
+            tensors++;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const double cost_ms = std::chrono::duration<double,milli>(end - start).count();
+    std::cout << "log-mel：" << seconds << "秒音频，" << tensors << "个张量，耗时=" << fixed << setprecision(2)
+    << cost_ms << "ms，占单核=" << setprecision(4) << cost_ms / (seconds * 1000.0) * 100 << "%" << std::endl;
+}
+
+// 音频格式转换 / 重采样吞吐（单线程，单位：每核每秒处理的输入采样数，多声道按每声道计）
+static void runAudioConvertBench(const char* name) {
+    const int channels = 2;
+    const int nb_samples = 48000 * 10;   // 10 秒 48kHz 立体声
+    std::vector<int16_t> s16(nb_samples * channels);
+    for (size_t i = 0; i < s16.size(); ++i) {
+        s16[i] = static_cast<int16_t>(16000.0 * std::sin(i * 0.001));
+    }
+    std::vector<float> left(nb_samples), right(nb_samples), mono(nb_samples);
+    std::vector<int16_t> s16_out(nb_samples * channels);
+    const uint8_t* s16_planes[1] = {reinterpret_cast<const uint8_t*>(s16.data())};
+    uint8_t* fltp_planes[2] = {reinterpret_cast<uint8_t*>(left.data()), reinterpret_cast<uint8_t*>(right.data())};
+    uint8_t* s16_out_planes[1] = {reinterpret_cast<uint8_t*>(s16_out.data())};
+    
+    auto measure = [&](const char* step, size_t samples, const std::function<void()>& fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        const double sec = std::chrono::duration<double>(end - start).count();
+        std::cout << name << " " << step << "：" << fixed << setprecision(1) << samples / sec / 1e6 << " M采样/秒/核" << std::endl;
+    };
+    measure("S16 交错 -> FLTP", static_cast<size_t>(nb_samples) * channels, [&] {
+        SampleConverter::convert(s16_planes, SampleFormat::S16, fltp_planes, SampleFormat::FLTP, channels, nb_samples);
+    });
+    measure("FLTP -> S16 交错", static_cast<size_t>(nb_samples) * channels, [&] {
+        SampleConverter::convert(fltp_planes, SampleFormat::FLTP, s16_out_planes, SampleFormat::S16, channels, nb_samples);
+    });
+    measure("S16 交错 -> 单声道 FLT", static_cast<size_t>(nb_samples) * channels, [&] {
+        SampleConverter::toMonoFloat(s16_planes, SampleFormat::S16, channels, nb_samples, mono.data());
+    });
+    for (int in_rate : {48000, 44100}) {
+        Resampler resampler(in_rate, 16000);
+        std::vector<float> output;
+        measure(in_rate == 48000 ? "重采样 48k -> 16k" : "重采样 44.1k -> 16k", mono.size(), [&] {
+            for (size_t pos = 0; pos < mono.size(); pos += 1024) {
+                resampler.process(mono.data() + pos, std::min<size_t>(1024, mono.size() - pos), output);
+            }
+        });
+    }
+}
+
+void benchAudioConvert() {
+    CpuInfo::setAVX2Disabled(true);
+    runAudioConvertBench("标量");
+    CpuInfo::setAVX2Disabled(false);
+    if (CpuInfo::hasAVX2()) {
+        runAudioConvertBench("AVX2");
+    }
+}
+
+// 运动矢量门控分析：静止画面复用上一次的推理结果
+void testMotionGate(const string& file_path) {
+    AIInfer infer_engine;
+    std::string model_path = "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/lib/models/mobilenetv2-12.onnx";
+    if (!infer_engine.init(model_path)) {
+        std::cerr << "AI模型初始化失败，退出测试" << std::endl;
+        return;
+    }
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setHwAccelEnabled(false); // 硬件解码不导出运动矢量
+    if (!decoder.setExportMotionVectors(true)) {
+        std::cerr << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    const int model_input_size = 224 * 224 * 3;
+    std::vector<float> model_input(model_input_size);
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    
+    MotionGate gate;
+    int frames = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (true) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        frames++;
+        AIResult ai_result = gate.lastResult();
+        if (gate.shouldInfer(*frame_guard.get()) &&
+            converter.convertCropResizeYuvToBgr(frame_guard->avFrame(), bgr_frame, 224, 224, ResizeMode::CROP) &&
+            ImagePreprocessor::normalizeBGRFrame(bgr_frame, model_input.data(), mean, std)) {
+            ai_result = infer_engine.infer(model_input.data(), model_input_size);
+            gate.update(ai_result);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "运动门控：" << frames << "帧，推理=" << gate.inferredCount() << "次，跳过=" << gate.skippedCount()
+    << "次，总耗时=" << fixed << setprecision(2) << std::chrono::duration<double,milli>(end - start).count() << "ms" << std::endl;
+    av_frame_free(&bgr_frame);
+    decoder.close();
+    infer_engine.destroy();
+}
+
+// 按镜头推理：每个镜头只在第 kSettleFrames 帧（避开切换瞬间的残影）推理一次，结果复用于整个镜头
+struct ShotResult {
+    ShotInfo shot;
+    AIResult result = {"", 0.0f, false};
+};
+
+void testShotDetection(const string& file_path) {
+    AIInfer infer_engine;
+    std::string model_path = "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/lib/models/mobilenetv2-12.onnx";
+    if (!infer_engine.init(model_path)) {
+        std::cerr << "AI模型初始化失败，退出测试" << std::endl;
+        return;
+    }
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setHwAccelEnabled(false); // 直方图直接读 YUV 平面，不走硬件帧
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    const int model_input_size = 224 * 224 * 3;
+    std::vector<float> model_input(model_input_size);
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    const int kSettleFrames = 3;
+    
+    ShotDetector detector;
+    std::vector<ShotResult> shot_results;
+    AIResult shot_result = {"", 0.0f, false};
+    int frames = 0;
+    int infer_count = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (true) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        frames++;
+        if (detector.push(*frame_guard.get())) {
+            shot_results.push_back({detector.shots().back(), shot_result});
+            shot_result = {"", 0.0f, false};
+        }
+        if (detector.currentShot().frame_count == kSettleFrames &&
+            converter.convertCropResizeYuvToBgr(frame_guard->avFrame(), bgr_frame, 224, 224, ResizeMode::CROP) &&
+            ImagePreprocessor::normalizeBGRFrame(bgr_frame, model_input.data(), mean, std)) {
+            shot_result = infer_engine.infer(model_input.data(), model_input_size);
+            infer_count++;
+        }
+    }
+    detector.finish();
+    if (!detector.shots().empty() && shot_results.size() < detector.shots().size()) {
+        shot_results.push_back({detector.shots().back(), shot_result});
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    for (const auto& item : shot_results) {
+        std::cout << "镜头" << item.shot.index << "：帧[" << item.shot.start_frame << ", "
+        << item.shot.start_frame + item.shot.frame_count << ")，pts[" << item.shot.start_pts << ", " << item.shot.end_pts << "]，"
+        << (item.result.is_valid ? item.result.class_name + "(" + std::to_string(item.result.confidence) + ")" : std::string("未推理"))
+        << std::endl;
+    }
+    std::cout << "镜头检测：" << frames << "帧，" << shot_results.size() << "个镜头，推理=" << infer_count
+    << "次，总耗时=" << fixed << setprecision(2) << std::chrono::duration<double,milli>(end - start).count() << "ms" << std::endl;
+    av_frame_free(&bgr_frame);
+    decoder.close();
+    infer_engine.destroy();
+}
+
+// 画质门控：过暗/过曝/空白/模糊的帧不转换、不归一化、不推理
+void testQualityGate(const string& file_path) {
+    AIInfer infer_engine;
+    std::string model_path = "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/lib/models/mobilenetv2-12.onnx";
+    if (!infer_engine.init(model_path)) {
+        std::cerr << "AI模型初始化失败，退出测试" << std::endl;
+        return;
+    }
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setHwAccelEnabled(false); // 直接读 Y 平面，不走硬件帧
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    const int model_input_size = 224 * 224 * 3;
+    std::vector<float> model_input(model_input_size);
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    
+    QualityGate gate;
+    int frames = 0;
+    double gate_ms = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (true) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        frames++;
+        auto gate_start = std::chrono::high_resolution_clock::now();
+        const bool pass = gate.shouldInfer(*frame_guard.get());
+        gate_ms += std::chrono::duration<double,milli>(std::chrono::high_resolution_clock::now() - gate_start).count();
+        if (pass &&
+            converter.convertCropResizeYuvToBgr(frame_guard->avFrame(), bgr_frame, 224, 224, ResizeMode::CROP) &&
+            ImagePreprocessor::normalizeBGRFrame(bgr_frame, model_input.data(), mean, std)) {
+            infer_engine.infer(model_input.data(), model_input_size);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "画质门控：" << frames << "帧，推理=" << gate.passedCount()
+    << "次，过暗=" << gate.rejectedCount(QualityReject::DARK)
+    << "，过曝=" << gate.rejectedCount(QualityReject::BRIGHT)
+    << "，空白=" << gate.rejectedCount(QualityReject::BLANK)
+    << "，模糊=" << gate.rejectedCount(QualityReject::BLURRED)
+    << "，门控耗时=" << fixed << setprecision(2) << gate_ms / std::max(1, frames) << "ms/帧"
+    << "，总耗时=" << std::chrono::duration<double,milli>(end - start).count() << "ms" << std::endl;
+    av_frame_free(&bgr_frame);
+    decoder.close();
+    infer_engine.destroy();
+}
+
+// 过载自适应丢帧：实时流（如 rtsp://）+ 模拟慢推理，观察档位变化和各档位跳过的帧数
+void testAdaptiveSkip(const string& live_url, int infer_ms = 50) {
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setAdaptiveSkipEnabled(true);
+    if (!decoder.openVideoDecoder(live_url)) {
+        std::cerr << "打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    int frames = 0;
+    while (frames < 1000) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        frames++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(infer_ms));
+        if (frames % 100 == 0) {
+            AdaptiveSkipStats stats = decoder.adaptiveSkipStats();
+            std::cout << "第" << frames << "帧：档位=" << stats.level
+            << "，跳过[默认/非参考/B帧]=" << stats.skipped[0] << "/" << stats.skipped[1] << "/" << stats.skipped[2]
+            << "，升档=" << stats.escalations << "，降档=" << stats.relaxations << std::endl;
+        }
+    }
+    decoder.close();
+}
+
+// 预处理对比：sws_scale 转 BGR + 标量归一化（两遍 + 中间帧） vs YUV 直出归一化张量（一遍）
+void benchPreprocess(const string& file_path, ResizeMode mode = ResizeMode::CROP) {
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setHwAccelEnabled(false);
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    const int model_input_size = 224 * 224 * 3;
+    std::vector<float> two_pass(model_input_size);
+    std::vector<float> fused(model_input_size);
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    
+    int frames = 0;
+    double two_pass_ms = 0.0, fused_ms = 0.0, max_diff = 0.0;
+    while (frames < 300) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        const AVFrame* yuv = frame_guard->avFrame();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        if (!converter.convertCropResizeYuvToBgr(yuv, bgr_frame, 224, 224, mode) ||
+            !ImagePreprocessor::normalizeBGRFrame(bgr_frame, two_pass.data(), mean, std)) {
+            continue;
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        if (!ImagePreprocessor::yuvToNormalizedTensor(yuv, fused.data(), 224, 224, mode, mean, std)) {
+            continue;
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        two_pass_ms += std::chrono::duration<double,milli>(t1 - t0).count();
+        fused_ms += std::chrono::duration<double,milli>(t2 - t1).count();
+        for (int i = 0; i < model_input_size; ++i) {
+            max_diff = std::max(max_diff, static_cast<double>(std::fabs(two_pass[i] - fused[i])));
+        }
+        frames++;
+    }
+    if (frames > 0) {
+        std::cout << "预处理（" << frames << "帧，AVX2=" << CpuInfo::hasAVX2() << "）：两遍="
+        << fixed << setprecision(3) << two_pass_ms / frames << "ms/帧，一遍="
+        << fused_ms / frames << "ms/帧，加速=" << setprecision(2) << two_pass_ms / std::max(fused_ms, 1e-9)
+        << "x，最大差异=" << setprecision(4) << max_diff << std::endl;
+    }
+    av_frame_free(&bgr_frame);
+    decoder.close();
+}
+
+// 转换服务：一个 FrameConverter 同时输出模型输入（224x224）和半尺寸渲染画面，两个线程并发调用
+void benchConverterService(const string& file_path) {
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    int width = 0, height = 0;
+    decoder.getVideoSize(width, height);
+    FrameConverter converter;
+    AVFrame* model_frame = av_frame_alloc();
+    AVFrame* render_frame = av_frame_alloc();
+    int frames = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (frames < 300) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        const AVFrame* yuv = frame_guard->avFrame();
+        std::thread render_thread([&]() {
+            converter.convertCropResizeYuvToBgr(yuv, render_frame, width / 2, height / 2, ResizeMode::KEEP_BLACK);
+        });
+        converter.convertCropResizeYuvToBgr(yuv, model_frame, 224, 224, ResizeMode::CROP);
+        render_thread.join();
+        frames++;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    SwsContextCache& cache = converter.contextCache();
+    std::cout << "转换服务：" << frames << "帧，上下文命中=" << cache.hitCount() << "，未命中=" << cache.missCount()
+    << "，淘汰=" << cache.evictionCount() << "，总耗时=" << fixed << setprecision(2)
+    << std::chrono::duration<double,milli>(end - start).count() << "ms" << std::endl;
+    av_frame_free(&model_frame);
+    av_frame_free(&render_frame);
+    decoder.close();
+}
+
+// 切片并行缩放：单路 4K 输入，对比单上下文和切片并行的单帧延迟（输出为半尺寸渲染画面）
+void benchSlicedScale(const string& file_path, int slice_count = 4) {
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    int width = 0, height = 0;
+    decoder.getVideoSize(width, height);
+    ThreadPool pool(slice_count - 1);
+    FrameConverter single;
+    FrameConverter sliced;
+    sliced.setSliceThreads(slice_count, &pool, 0);
+    AVFrame* single_frame = av_frame_alloc();
+    AVFrame* sliced_frame = av_frame_alloc();
+    int frames = 0;
+    double single_ms = 0.0, sliced_ms = 0.0;
+    bool identical = true;
+    while (frames < 100) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        if (!frame_guard.get()) {
+            break;
+        }
+        const AVFrame* yuv = frame_guard->avFrame();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        single.convertCropResizeYuvToBgr(yuv, single_frame, width / 2, height / 2, ResizeMode::STRETCH);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        sliced.convertCropResizeYuvToBgr(yuv, sliced_frame, width / 2, height / 2, ResizeMode::STRETCH);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        single_ms += std::chrono::duration<double,milli>(t1 - t0).count();
+        sliced_ms += std::chrono::duration<double,milli>(t2 - t1).count();
+        for (int y = 0; y < single_frame->height && identical; ++y) {
+            identical = memcmp(single_frame->data[0] + y * single_frame->linesize[0],
+                               sliced_frame->data[0] + y * sliced_frame->linesize[0], single_frame->width * 3) == 0;
+        }
+        frames++;
+    }
+    if (frames > 0) {
+        std::cout << "切片缩放（" << width << "x" << height << "，" << slice_count << "片）：单上下文="
+        << fixed << setprecision(2) << single_ms / frames << "ms/帧，切片=" << sliced_ms / frames
+        << "ms/帧，结果一致=" << (identical ? "是" : "否") << std::endl;
+    }
+    av_frame_free(&single_frame);
+    av_frame_free(&sliced_frame);
+    decoder.close();
+}
+
+// 多路批量推理：每轮从每路流各取一帧，打包成 [N,3,224,224] 一次推理
+void testBatchInfer(const vector<string>& file_paths) {
+    AIInfer infer_engine;
+    std::string model_path = "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/lib/models/mobilenetv2-12.onnx";
+    if (!infer_engine.init(model_path)) {
+        std::cerr << "AI模型初始化失败，退出测试" << std::endl;
+        return;
+    }
+    std::vector<std::unique_ptr<PlayerContext>> contexts;
+    std::vector<std::unique_ptr<VideoDecoder>> decoders;
+    for (const auto& path : file_paths) {
+        contexts.emplace_back(new PlayerContext());
+        decoders.emplace_back(new VideoDecoder(*contexts.back()));
+        if (!decoders.back()->openVideoDecoder(path)) {
+            std::cerr << "文件打开失败：" << path << "，" << decoders.back()->getErrorMsg() << std::endl;
+            return;
+        }
+    }
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    BatchTensorBuilder builder(static_cast<int>(decoders.size()), 224, 224, ResizeMode::CROP, mean, std);
+    
+    int rounds = 0;
+    double build_ms = 0.0, infer_ms = 0.0;
+    while (rounds < 100) {
+        std::vector<VideoFrame::Ptr> frames;
+        std::vector<const AVFrame*> av_frames;
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < decoders.size(); ++i) {
+            VideoFrame::Ptr frame = decoders[i]->getFrame();
+            if (frame && frame->avFrame()) {
+                av_frames.push_back(frame->avFrame());
+                frames.push_back(frame);
+                owners.push_back(i);
+            } else if (frame) {
+                decoders[i]->framePool().release(frame);
+            }
+        }
+        if (frames.empty()) {
+            break;
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+        builder.build(av_frames);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::vector<AIResult> results = infer_engine.inferBatch(builder.data(), builder.batchSize(), builder.height(), builder.width());
+        auto t2 = std::chrono::high_resolution_clock::now();
+        build_ms += std::chrono::duration<double,milli>(t1 - t0).count();
+        infer_ms += std::chrono::duration<double,milli>(t2 - t1).count();
+        for (size_t i = 0; i < frames.size(); ++i) {
+            decoders[owners[i]]->framePool().release(frames[i]);
+        }
+        rounds++;
+    }
+    if (rounds > 0) {
+        std::cout << "批量推理：" << decoders.size() << "路，" << rounds << "轮，构建=" << fixed << setprecision(2)
+        << build_ms / rounds << "ms/批，推理=" << infer_ms / rounds << "ms/批" << std::endl;
+    }
+    for (auto& decoder : decoders) {
+        decoder->close();
+    }
+    infer_engine.destroy();
+}
+
+// 多 ROI 裁剪缩放：模拟检测阶段输出的 box_count 个框（3x3 网格），
+// 对比"每个框新建转换器 + 中转帧"与 BatchTensorBuilder::buildFromRois 一次写入批量张量
+void benchMultiRoi(const string& file_path, int box_count = 8) {
+    PlayerContext player_ctx;
+    VideoDecoder decoder(player_ctx);
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    const std::vector<float> mean = {0.485f, 0.456f, 0.406f};
+    const std::vector<float> std = {0.229f, 0.224f, 0.225f};
+    BatchTensorBuilder builder(box_count, 224, 224, ResizeMode::KEEP_BLACK, mean, std);
+    std::vector<float> naive_tensor(builder.sampleSize() * box_count);
+    
+    int frames = 0;
+    double naive_ms = 0.0, batch_ms = 0.0;
+    while (frames < 200) {
+        MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+        VideoFrame::Ptr frame = frame_guard.get();
+        if (!frame || !frame->avFrame()) {
+            break;
+        }
+        const AVFrame* av_frame = frame->avFrame();
+        std::vector<RoiRect> rois;
+        for (int i = 0; i < box_count; ++i) {
+            RoiRect roi;
+            roi.width = av_frame->width / 4;
+            roi.height = av_frame->height / 3;
+            roi.x = (i % 3) * av_frame->width / 3 + (i * 7) % 16;
+            roi.y = ((i / 3) % 3) * av_frame->height / 3;
+            rois.push_back(roi);
+        }
+        
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < box_count; ++i) {
+            FrameConverter converter;
+            AVFrame* bgr_frame = av_frame_alloc();
+            if (converter.convertRoiToBgr(av_frame, rois[i], bgr_frame, 224, 224, ResizeMode::KEEP_BLACK)) {
+                ImagePreprocessor::normalizeBGRFrame(bgr_frame, naive_tensor.data() + i * builder.sampleSize(), mean, std);
+            }
+            av_frame_free(&bgr_frame);
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        builder.buildFromRois(av_frame, rois);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        naive_ms += std::chrono::duration<double,milli>(t1 - t0).count();
+        batch_ms += std::chrono::duration<double,milli>(t2 - t1).count();
+        frames++;
+    }
+    if (frames > 0) {
+        std::cout << "多ROI预处理（" << box_count << "框/帧）：逐框新建=" << fixed << setprecision(2)
+        << naive_ms / frames << "ms/帧，批量写入=" << batch_ms / frames << "ms/帧" << std::endl;
+    }
+    decoder.close();
+}
+
+// 缩放后端对比：同一段视频分别固定 swscale / SIMD / OpenCV，再用 AUTO 看自动选择的结果
+void benchScalerBackends(const string& file_path, int dst_w = 224, int dst_h = 224) {
+    PlayerContext player_ctx;
+    VideoDecoder decoder(player_ctx);
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    // 先解码一批帧，各后端处理相同的输入
+    std::vector<VideoFrame::Ptr> frames;
+    while (frames.size() < 100) {
+        VideoFrame::Ptr frame = decoder.getFrame();
+        if (!frame) {
+            break;
+        }
+        if (!frame->avFrame()) {
+            decoder.framePool().release(frame);
+            continue;
+        }
+        frames.push_back(frame);
+    }
+    const std::vector<std::pair<ScalerBackend, std::string>> backends = {
+        {ScalerBackend::SWSCALE, "swscale"}, {ScalerBackend::SIMD, "simd"},
+        {ScalerBackend::OPENCV, "opencv"}, {ScalerBackend::AUTO, "auto"}};
+    AVFrame* bgr_frame = av_frame_alloc();
+    for (const auto& backend : backends) {
+        FrameConverter converter;
+        converter.setScalerBackend(backend.first);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& frame : frames) {
+            converter.convertCropResizeYuvToBgr(frame->avFrame(), bgr_frame, dst_w, dst_h, ResizeMode::KEEP_BLACK);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        if (!frames.empty()) {
+            std::cout << "缩放后端 " << backend.second << "：" << fixed << setprecision(3)
+            << std::chrono::duration<double,milli>(end - start).count() / frames.size() << "ms/帧" << std::endl;
+        }
+        for (const auto& result : converter.autotuner().results()) {
+            std::cout << "  自动选择 " << result.src_w << "x" << result.src_h << " → " << result.dst_w << "x" << result.dst_h
+            << "：" << result.selected << std::endl;
+        }
+    }
+    av_frame_free(&bgr_frame);
+    for (auto& frame : frames) {
+        decoder.framePool().release(frame);
+    }
+    decoder.close();
+}
+
+// 旋转视频（手机竖拍）：按显示矩阵输出正确朝向的模型输入，保存第一帧的 KEEP_BLACK 结果对比
+void testRotation(const string& file_path, const string& save_path) {
+    PlayerContext player_ctx;
+    VideoDecoder decoder(player_ctx);
+    if (!decoder.openVideoDecoder(file_path)) {
+        std::cerr << "文件打开失败：" << decoder.getErrorMsg() << std::endl;
+        return;
+    }
+    int width = 0, height = 0;
+    decoder.getVideoSize(width, height);
+    std::cout << "视频尺寸：" << width << "x" << height << "，显示矩阵旋转：" << decoder.getRotation() << "度" << std::endl;
+    
+    MediaFrameGuard<MediaFramePool> frame_guard(decoder.framePool(), decoder.getFrame());
+    VideoFrame::Ptr frame = frame_guard.get();
+    if (!frame || !frame->avFrame()) {
+        std::cerr << "解码失败：" << decoder.getErrorMsg() << std::endl;
+        decoder.close();
+        return;
+    }
+    const RoiRect display = FrameConverter::displayRect(frame->avFrame());
+    std::cout << "显示方向尺寸：" << display.width << "x" << display.height << std::endl;
+    
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    auto start = std::chrono::high_resolution_clock::now();
+    const bool ok = converter.convertCropResizeYuvToBgr(frame->avFrame(), bgr_frame, 224, 224, ResizeMode::KEEP_BLACK);
+    auto end = std::chrono::high_resolution_clock::now();
+    if (ok) {
+        std::cout << "转换耗时：" << fixed << setprecision(3) << std::chrono::duration<double,milli>(end - start).count() << "ms" << std::endl;
+        SaveImage::saveBGRFrameToJPG(bgr_frame, save_path);
+    }
+    av_frame_free(&bgr_frame);
+    decoder.close();
+}
+
 int main() {
     
 //    // 先测试阻塞模式（确保完整接收）
@@ -324,6 +1104,24 @@ int main() {
 //    string file_path = "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/天鹅.mp4";
 ////        testLocalFile(file_path);
 //        testCamera();
+//        benchDecodeProfile(file_path);
+//        testMotionGate(file_path);
+//        testShotDetection(file_path);
+//        testQualityGate(file_path);
+//        testAdaptiveSkip("rtsp://127.0.0.1:8554/live");
+//        benchLogMel();
+//        benchAudioConvert();
+//        benchPreprocess(file_path);
+//        benchConverterService(file_path);
+//        benchSlicedScale(file_path);
+//        testBatchInfer({"/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/clip_001.mp4",
+//                        "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/clip_002.mp4"});
+//        benchMultiRoi(file_path);
+//        benchScalerBackends(file_path);
+//        testRotation("/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/portrait.mp4",
+//                     "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/portrait_224.jpg");
+//        benchBatchDecode({"/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/clip_001.mp4",
+//                          "/Users/elenahao/AaronWorkFiles/Ocean/mp4_ai_analyzer/data/clip_002.mp4"});
     
     return 0;
 }
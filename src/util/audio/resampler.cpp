@@ -0,0 +1,172 @@
+//
+//  resampler.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include "resampler.h"
+#include "../simd/cpu_features.h"
+#include "../../common/log/log.h"
+
+// 相位数上限（系数表大小 = 相位数 * 抽头数）
+static const int kMaxPhases = 4096;
+// Kaiser 窗 beta（约 80dB 阻带衰减）
+static const double kKaiserBeta = 8.0;
+
+static float dotScalar(const float* a, const float* b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#if SIMD_X86_AVX2
+SIMD_TARGET_AVX2
+static float dotAVX2(const float* a, const float* b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    // 两路累加隐藏 FMA 延迟
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum) + dotScalar(a + i, b + i, n - i);
+}
+#endif
+
+// 第一类零阶修正贝塞尔函数（Kaiser 窗用）
+static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum) {
+            break;
+        }
+    }
+    return sum;
+}
+
+Resampler::Resampler(int in_rate, int out_rate, int half_taps)
+: in_rate_(in_rate), out_rate_(out_rate), half_taps_(half_taps), taps_(2 * half_taps) {
+    if (in_rate <= 0 || out_rate <= 0 || half_taps <= 0) {
+        error_msg_ = "重采样参数无效：采样率和抽头数必须大于 0";
+        LOG_ERROR(error_msg_);
+        return;
+    }
+    const int divisor = std::gcd(in_rate, out_rate);
+    up_ = out_rate / divisor;
+    down_ = in_rate / divisor;
+    if (up_ > kMaxPhases) {
+        error_msg_ = "重采样参数无效：采样率比 " + std::to_string(up_) + "/" + std::to_string(down_) + " 相位数过多";
+        LOG_ERROR(error_msg_);
+        return;
+    }
+    use_avx2_ = CpuInfo::hasAVX2();
+    initFilter();
+    reset();
+}
+
+void Resampler::initFilter() {
+    // 截止频率（相对输入奈奎斯特频率）：降采样时取输出奈奎斯特频率，留 10% 过渡带
+    const double cutoff = std::min(1.0, static_cast<double>(up_) / down_) * 0.9;
+    const double i0_beta = besselI0(kKaiserBeta);
+    coeffs_.assign(static_cast<size_t>(up_) * taps_, 0.0f);
+    for (int phase = 0; phase < up_; ++phase) {
+        float* h = coeffs_.data() + static_cast<size_t>(phase) * taps_;
+        double sum = 0.0;
+        for (int k = 0; k < taps_; ++k) {
+            // 输出位置与第 k 个输入采样之间的距离（以输入采样为单位）
+            const double x = static_cast<double>(phase) / up_ + half_taps_ - 1 - k;
+            const double u = cutoff * x;
+            const double sinc = std::fabs(u) < 1e-9 ? 1.0 : std::sin(M_PI * u) / (M_PI * u);
+            const double r = x / half_taps_;
+            const double window = std::fabs(r) >= 1.0 ? 0.0 : besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / i0_beta;
+            const double value = cutoff * sinc * window;
+            h[k] = static_cast<float>(value);
+            sum += value;
+        }
+        // 每个相位单独归一化直流增益，避免相位间增益差异产生调制噪声
+        if (sum != 0.0) {
+            for (int k = 0; k < taps_; ++k) {
+                h[k] = static_cast<float>(h[k] / sum);
+            }
+        }
+    }
+}
+
+void Resampler::reset() {
+    // 前面补 half_taps - 1 个零，第一个输出对齐第一个输入采样
+    history_.assign(half_taps_ - 1, 0.0f);
+    time_ = static_cast<int64_t>(half_taps_ - 1) * up_;
+}
+
+size_t Resampler::process(const float* input, size_t count, std::vector<float>& output) {
+    if (!isValid() || !input || count == 0) {
+        return 0;
+    }
+    history_.insert(history_.end(), input, input + count);
+    
+    const size_t old_size = output.size();
+    // 预估输出个数，减少扩容
+    output.reserve(old_size + count * up_ / down_ + 2);
+    produce(INT64_MAX, output);
+    
+    // 丢弃之后不再用到的历史采样
+    const int64_t size = static_cast<int64_t>(history_.size());
+    const int64_t drop = std::min<int64_t>(time_ / up_ - (half_taps_ - 1), size);
+    if (drop > 0) {
+        history_.erase(history_.begin(), history_.begin() + drop);
+        time_ -= drop * up_;
+    }
+    return output.size() - old_size;
+}
+
+size_t Resampler::flush(std::vector<float>& output) {
+    if (!isValid()) {
+        return 0;
+    }
+    const size_t old_size = output.size();
+    // 输入末尾之后补 half_taps 个零，让最后 half_taps 个输入采样附近的输出也凑满窗口；
+    // 只输出位置在最后一个输入采样之前（含）的采样，总长度为 ceil(输入长度 * L / M)
+    const int64_t end_time = static_cast<int64_t>(history_.size()) * up_;
+    history_.insert(history_.end(), half_taps_, 0.0f);
+    produce(end_time, output);
+    reset();
+    return output.size() - old_size;
+}
+
+void Resampler::produce(int64_t end_time, std::vector<float>& output) {
+    const int64_t size = static_cast<int64_t>(history_.size());
+    while (time_ < end_time) {
+        const int64_t base = time_ / up_;
+        // 需要 history_[base - half_taps + 1, base + half_taps]
+        if (base + half_taps_ >= size) {
+            break;
+        }
+        const int phase = static_cast<int>(time_ % up_);
+        const float* h = coeffs_.data() + static_cast<size_t>(phase) * taps_;
+        const float* x = history_.data() + (base - half_taps_ + 1);
+#if SIMD_X86_AVX2
+        output.push_back(use_avx2_ ? dotAVX2(h, x, taps_) : dotScalar(h, x, taps_));
+#else
+        output.push_back(dotScalar(h, x, taps_));
+#endif
+        time_ += down_;
+    }
+}
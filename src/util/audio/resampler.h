@@ -0,0 +1,73 @@
+//
+//  resampler.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 多相 FIR 重采样（单声道 float，流式）
+ * 采样率比化简为 L/M（如 48000->16000 为 1/3，44100->16000 为 160/441），
+ * 原型滤波器为 Kaiser 窗 sinc，按 L 个相位拆成 L 组系数，每个输出采样只算一组点积（AVX2 / 标量）
+ * 多声道请每个声道一个实例，或先用 SampleConverter::toMonoFloat 混成单声道
+ */
+class Resampler {
+public:
+    /**
+     * @param in_rate 输入采样率
+     * @param out_rate 输出采样率
+     * @param half_taps 每个相位单侧的抽头数（每相位 2*half_taps 个系数），越大过渡带越窄
+     */
+    Resampler(int in_rate, int out_rate, int half_taps = 16);
+    
+    bool isValid() const { return error_msg_.empty(); }
+    std::string getErrorMsg() const { return error_msg_; }
+    int inRate() const { return in_rate_; }
+    int outRate() const { return out_rate_; }
+    
+    /**
+     * 重采样一段输入（跨调用保留滤波器历史）
+     * @param input 输入采样
+     * @param count 输入采样数
+     * @param output 输出追加到末尾
+     * @return 本次输出的采样数
+     */
+    size_t process(const float* input, size_t count, std::vector<float>& output);
+    
+    /**
+     * 输入结束：补零输出缓冲中剩余的采样（最后 half_taps 个输入采样对应的输出），之后状态重置，可以开始新的流
+     * @param output 输出追加到末尾
+     * @return 本次输出的采样数；从 reset() 开始 process() 与 flush() 的输出总数为 ceil(输入总数 * out_rate / in_rate)
+     */
+    size_t flush(std::vector<float>& output);
+    
+    // 清空历史（跳转后调用）
+    void reset();
+    
+private:
+    void initFilter();
+    // 计算位置在 end_time 之前、窗口已凑满的输出采样
+    void produce(int64_t end_time, std::vector<float>& output);
+    
+    int in_rate_ = 0;
+    int out_rate_ = 0;
+    int up_ = 1;                    // L：插值倍数
+    int down_ = 1;                  // M：抽取倍数
+    int half_taps_ = 16;
+    int taps_ = 32;                 // 每个相位的系数个数
+    bool use_avx2_ = false;
+    std::string error_msg_;
+    
+    std::vector<float> coeffs_;     // [L][taps] 多相系数
+    std::vector<float> history_;    // 输入缓冲（含滤波器需要的历史采样）
+    int64_t time_ = 0;              // 下一个输出采样在 history_ 中的位置（单位 1/L 个输入采样）
+};
+
+#endif /* RESAMPLER_H */
@@ -0,0 +1,318 @@
+//
+//  sample_converter.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include "sample_converter.h"
+#include "../simd/cpu_features.h"
+
+// 每次处理的块大小（每个声道），float 中间缓冲区放在栈上，常驻 L1
+static const int kChunkSize = 256;
+
+static const float kS16Scale = 1.0f / 32768.0f;
+static const float kS32Scale = 1.0f / 2147483648.0f;
+static const float kU8Scale = 1.0f / 128.0f;
+// 小于 2^31 的最大 float，防止 S32 转换溢出
+static const float kS32Max = 2147483520.0f;
+
+// planar 格式对应的 packed 格式（内核只区分数据类型）
+static SampleFormat baseFormat(SampleFormat fmt) {
+    switch (fmt) {
+        case SampleFormat::S16P: return SampleFormat::S16;
+        case SampleFormat::FLTP: return SampleFormat::FLT;
+        case SampleFormat::S32P: return SampleFormat::S32;
+        case SampleFormat::U8P:  return SampleFormat::U8;
+        default:                 return fmt;
+    }
+}
+
+// ------------------------------
+// 标量内核（stride 为相邻采样间隔，packed 格式为声道数）
+// ------------------------------
+static void decodeScalar(const uint8_t* src, SampleFormat fmt, int stride, int n, float* out) {
+    switch (fmt) {
+        case SampleFormat::FLT: {
+            const float* p = reinterpret_cast<const float*>(src);
+            for (int i = 0; i < n; ++i) out[i] = p[i * stride];
+            break;
+        }
+        case SampleFormat::S16: {
+            const int16_t* p = reinterpret_cast<const int16_t*>(src);
+            for (int i = 0; i < n; ++i) out[i] = p[i * stride] * kS16Scale;
+            break;
+        }
+        case SampleFormat::S32: {
+            const int32_t* p = reinterpret_cast<const int32_t*>(src);
+            for (int i = 0; i < n; ++i) out[i] = static_cast<float>(p[i * stride]) * kS32Scale;
+            break;
+        }
+        case SampleFormat::U8: {
+            for (int i = 0; i < n; ++i) out[i] = (static_cast<int>(src[i * stride]) - 128) * kU8Scale;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void encodeScalar(const float* in, SampleFormat fmt, int stride, int n, uint8_t* dst) {
+    switch (fmt) {
+        case SampleFormat::FLT: {
+            float* p = reinterpret_cast<float*>(dst);
+            for (int i = 0; i < n; ++i) p[i * stride] = in[i];
+            break;
+        }
+        case SampleFormat::S16: {
+            int16_t* p = reinterpret_cast<int16_t*>(dst);
+            for (int i = 0; i < n; ++i) {
+                const float v = std::nearbyint(in[i] * 32768.0f);
+                p[i * stride] = static_cast<int16_t>(std::min(32767.0f, std::max(-32768.0f, v)));
+            }
+            break;
+        }
+        case SampleFormat::S32: {
+            int32_t* p = reinterpret_cast<int32_t*>(dst);
+            for (int i = 0; i < n; ++i) {
+                const float v = std::nearbyint(in[i] * 2147483648.0f);
+                p[i * stride] = static_cast<int32_t>(std::min(kS32Max, std::max(-2147483648.0f, v)));
+            }
+            break;
+        }
+        case SampleFormat::U8: {
+            for (int i = 0; i < n; ++i) {
+                const float v = std::nearbyint(in[i] * 128.0f + 128.0f);
+                dst[i * stride] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, v)));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void accumulateScalar(const float* in, float gain, int n, float* out) {
+    for (int i = 0; i < n; ++i) {
+        out[i] += in[i] * gain;
+    }
+}
+
+// ------------------------------
+// AVX2 内核（只处理连续数据，尾部交给标量）
+// ------------------------------
+#if SIMD_X86_AVX2
+SIMD_TARGET_AVX2
+static void decodeAVX2(const uint8_t* src, SampleFormat fmt, int n, float* out) {
+    int i = 0;
+    switch (fmt) {
+        case SampleFormat::FLT:
+            std::memcpy(out, src, sizeof(float) * n);
+            return;
+        case SampleFormat::S16: {
+            const int16_t* p = reinterpret_cast<const int16_t*>(src);
+            const __m256 scale = _mm256_set1_ps(kS16Scale);
+            for (; i + 8 <= n; i += 8) {
+                const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+            }
+            break;
+        }
+        case SampleFormat::S32: {
+            const int32_t* p = reinterpret_cast<const int32_t*>(src);
+            const __m256 scale = _mm256_set1_ps(kS32Scale);
+            for (; i + 8 <= n; i += 8) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+            }
+            break;
+        }
+        case SampleFormat::U8: {
+            const __m256 scale = _mm256_set1_ps(kU8Scale);
+            const __m256i bias = _mm256_set1_epi32(128);
+            for (; i + 8 <= n; i += 8) {
+                const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(v, bias)), scale));
+            }
+            break;
+        }
+        default:
+            return;
+    }
+    decodeScalar(src + i * SampleFormatBytes(fmt), fmt, 1, n - i, out + i);
+}
+
+SIMD_TARGET_AVX2
+static void encodeAVX2(const float* in, SampleFormat fmt, int n, uint8_t* dst) {
+    int i = 0;
+    switch (fmt) {
+        case SampleFormat::FLT:
+            std::memcpy(dst, in, sizeof(float) * n);
+            return;
+        case SampleFormat::S16: {
+            int16_t* p = reinterpret_cast<int16_t*>(dst);
+            const __m256 scale = _mm256_set1_ps(32768.0f);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 minus_one = _mm256_set1_ps(-1.0f);
+            for (; i + 8 <= n; i += 8) {
+                // 先钳位到 [-1, 1]：|x| >= 65536 时 cvtps 溢出为 INT_MIN，正的大值会饱和成负数
+                // cvtps 按当前舍入模式（就近取偶）取整，packs 做饱和截断
+                const __m256 x = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i), one), minus_one);
+                const __m256i v = _mm256_cvtps_epi32(_mm256_mul_ps(x, scale));
+                const __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), packed);
+            }
+            break;
+        }
+        case SampleFormat::S32: {
+            int32_t* p = reinterpret_cast<int32_t*>(dst);
+            const __m256 scale = _mm256_set1_ps(2147483648.0f);
+            const __m256 max_val = _mm256_set1_ps(kS32Max);
+            const __m256 min_val = _mm256_set1_ps(-2147483648.0f);
+            for (; i + 8 <= n; i += 8) {
+                __m256 v = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+                v = _mm256_max_ps(_mm256_min_ps(v, max_val), min_val);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i), _mm256_cvtps_epi32(v));
+            }
+            break;
+        }
+        case SampleFormat::U8: {
+            const __m256 scale = _mm256_set1_ps(128.0f);
+            const __m256 bias = _mm256_set1_ps(128.0f);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 minus_one = _mm256_set1_ps(-1.0f);
+            for (; i + 8 <= n; i += 8) {
+                // 钳位原因同 S16
+                const __m256 x = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i), one), minus_one);
+                const __m256i v = _mm256_cvtps_epi32(_mm256_fmadd_ps(x, scale, bias));
+                const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(words, words));
+            }
+            break;
+        }
+        default:
+            return;
+    }
+    encodeScalar(in + i, fmt, 1, n - i, dst + i * SampleFormatBytes(fmt));
+}
+
+SIMD_TARGET_AVX2
+static void accumulateAVX2(const float* in, float gain, int n, float* out) {
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_loadu_ps(in + i), g, _mm256_loadu_ps(out + i)));
+    }
+    accumulateScalar(in + i, gain, n - i, out + i);
+}
+#endif
+
+static void decode(const uint8_t* src, SampleFormat fmt, int stride, int n, float* out, bool use_avx2) {
+#if SIMD_X86_AVX2
+    if (use_avx2 && stride == 1) {
+        decodeAVX2(src, fmt, n, out);
+        return;
+    }
+#endif
+    decodeScalar(src, fmt, stride, n, out);
+}
+
+static void encode(const float* in, SampleFormat fmt, int stride, int n, uint8_t* dst, bool use_avx2) {
+#if SIMD_X86_AVX2
+    if (use_avx2 && stride == 1) {
+        encodeAVX2(in, fmt, n, dst);
+        return;
+    }
+#endif
+    encodeScalar(in, fmt, stride, n, dst);
+}
+
+static void accumulate(const float* in, float gain, int n, float* out, bool use_avx2) {
+#if SIMD_X86_AVX2
+    if (use_avx2) {
+        accumulateAVX2(in, gain, n, out);
+        return;
+    }
+#endif
+    accumulateScalar(in, gain, n, out);
+}
+
+// 第 ch 个声道第 offset 个采样的地址，以及相邻采样的间隔（以采样为单位）
+static const uint8_t* channelPointer(const uint8_t* const* planes, SampleFormat fmt, int channels,
+                                     int ch, int offset, int& stride) {
+    const int bytes = SampleFormatBytes(fmt);
+    if (SampleFormatIsPlanar(fmt) || channels == 1) {
+        stride = 1;
+        return planes[SampleFormatIsPlanar(fmt) ? ch : 0] + static_cast<size_t>(offset) * bytes;
+    }
+    stride = channels;
+    return planes[0] + (static_cast<size_t>(offset) * channels + ch) * bytes;
+}
+
+bool SampleConverter::convert(const uint8_t* const* src, SampleFormat src_fmt,
+                              uint8_t* const* dst, SampleFormat dst_fmt,
+                              int channels, int nb_samples) {
+    if (!src || !dst || channels <= 0 || nb_samples < 0 ||
+        SampleFormatBytes(src_fmt) == 0 || SampleFormatBytes(dst_fmt) == 0) {
+        return false;
+    }
+    const SampleFormat src_base = baseFormat(src_fmt);
+    const SampleFormat dst_base = baseFormat(dst_fmt);
+    const bool use_avx2 = CpuInfo::hasAVX2();
+    float chunk[kChunkSize];
+    for (int ch = 0; ch < channels; ++ch) {
+        for (int offset = 0; offset < nb_samples; offset += kChunkSize) {
+            const int n = std::min(kChunkSize, nb_samples - offset);
+            int src_stride = 1;
+            int dst_stride = 1;
+            const uint8_t* in = channelPointer(src, src_fmt, channels, ch, offset, src_stride);
+            uint8_t* out = const_cast<uint8_t*>(channelPointer(dst, dst_fmt, channels, ch, offset, dst_stride));
+            decode(in, src_base, src_stride, n, chunk, use_avx2);
+            encode(chunk, dst_base, dst_stride, n, out, use_avx2);
+        }
+    }
+    return true;
+}
+
+bool SampleConverter::toMonoFloat(const uint8_t* const* src, SampleFormat src_fmt,
+                                  int channels, int nb_samples, float* dst) {
+    if (!src || !dst || channels <= 0 || nb_samples < 0 || SampleFormatBytes(src_fmt) == 0) {
+        return false;
+    }
+    const SampleFormat src_base = baseFormat(src_fmt);
+    const bool use_avx2 = CpuInfo::hasAVX2();
+    if (channels == 1) {
+        int stride = 1;
+        decode(channelPointer(src, src_fmt, 1, 0, 0, stride), src_base, stride, nb_samples, dst, use_avx2);
+        return true;
+    }
+    const float gain = 1.0f / channels;
+    float chunk[kChunkSize];
+    std::fill(dst, dst + nb_samples, 0.0f);
+    for (int ch = 0; ch < channels; ++ch) {
+        for (int offset = 0; offset < nb_samples; offset += kChunkSize) {
+            const int n = std::min(kChunkSize, nb_samples - offset);
+            int stride = 1;
+            const uint8_t* in = channelPointer(src, src_fmt, channels, ch, offset, stride);
+            decode(in, src_base, stride, n, chunk, use_avx2);
+            accumulate(chunk, gain, n, dst + offset, use_avx2);
+        }
+    }
+    return true;
+}
+
+bool SampleConverter::toMonoFloat(const AudioFrame& frame, float* dst) {
+    std::vector<const uint8_t*> planes(frame.planeCount());
+    for (int i = 0; i < frame.planeCount(); ++i) {
+        planes[i] = frame.planeData(i);
+        if (!planes[i]) {
+            return false;
+        }
+    }
+    return toMonoFloat(planes.data(), frame.sampleFormat(), frame.channels(), frame.nbSamples(), dst);
+}
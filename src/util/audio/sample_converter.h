@@ -0,0 +1,48 @@
+//
+//  sample_converter.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SAMPLE_CONVERTER_H
+#define SAMPLE_CONVERTER_H
+
+#include <cstdint>
+#include "../../common/media_frame.h"
+
+/**
+ * 音频采样格式转换（替代 libswresample，内置 FFmpeg 没有编译它）
+ * 支持 S16/S32/FLT/U8 的 packed 与 planar 任意组合；内部以 float 为中间格式分块处理，
+ * 连续数据（planar 或单声道）的整数/浮点转换在支持 AVX2 的 CPU 上走向量化路径，否则走标量路径
+ * 整数转换约定：S16 按 32768、S32 按 2^31、U8 按 128（中心 128）缩放到 [-1, 1)，反向转换饱和截断
+ */
+class SampleConverter {
+public:
+    /**
+     * 采样格式转换（声道数不变）
+     * @param src 源数据平面：planar 格式每个声道一个平面，packed 格式只用 src[0]
+     * @param src_fmt 源采样格式
+     * @param dst 目标数据平面（同上）
+     * @param dst_fmt 目标采样格式
+     * @param channels 声道数
+     * @param nb_samples 每个声道的采样数
+     * @return 成功返回true；格式不支持返回false
+     */
+    static bool convert(const uint8_t* const* src, SampleFormat src_fmt,
+                        uint8_t* const* dst, SampleFormat dst_fmt,
+                        int channels, int nb_samples);
+    
+    /**
+     * 混成单声道 float（各声道取平均）
+     * @param dst 输出缓冲区，大小至少 nb_samples
+     * @return 成功返回true
+     */
+    static bool toMonoFloat(const uint8_t* const* src, SampleFormat src_fmt,
+                            int channels, int nb_samples, float* dst);
+    
+    // 音频帧混成单声道 float，dst 大小至少 frame.nbSamples()
+    static bool toMonoFloat(const AudioFrame& frame, float* dst);
+};
+
+#endif /* SAMPLE_CONVERTER_H */
@@ -0,0 +1,42 @@
+//
+//  display_rotation.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include "display_rotation.h"
+
+extern "C" {
+#include <libavutil/display.h>
+}
+
+int DisplayRotation::fromMatrix(const int32_t matrix[9]) {
+    if (!matrix) {
+        return 0;
+    }
+    // av_display_rotation_get 返回逆时针角度（-180, 180]，画面需要反向（顺时针）旋转同样的角度
+    const double angle = av_display_rotation_get(matrix);
+    if (std::isnan(angle)) {
+        return 0;
+    }
+    int rotation = -static_cast<int>(std::lround(angle / 90.0)) * 90;
+    rotation %= 360;
+    if (rotation < 0) {
+        rotation += 360;
+    }
+    return rotation;
+}
+
+int DisplayRotation::fromFrame(const AVFrame* frame) {
+    if (!frame) {
+        return 0;
+    }
+    const AVFrameSideData* side_data = av_frame_get_side_data(frame, AV_FRAME_DATA_DISPLAYMATRIX);
+    if (!side_data || side_data->size < 9 * sizeof(int32_t)) {
+        return 0;
+    }
+    return fromMatrix(reinterpret_cast<const int32_t*>(side_data->data));
+}
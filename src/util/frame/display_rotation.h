@@ -0,0 +1,32 @@
+//
+//  display_rotation.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef DISPLAY_ROTATION_H
+#define DISPLAY_ROTATION_H
+
+#include <cstdint>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+/**
+ * 显示矩阵（display matrix）中的旋转角度：手机拍摄的 MP4 在 tkhd 中记录 90/180/270 度旋转，
+ * 解码输出仍是传感器方向的画面，需要按该角度顺时针旋转后才是正确朝向
+ * @note 只取旋转分量，矩阵中的镜像翻转被忽略；非 90 度整数倍的角度取最近的 90 度
+ */
+class DisplayRotation {
+public:
+    // 由显示矩阵计算顺时针旋转角度（0/90/180/270），矩阵奇异时返回 0
+    static int fromMatrix(const int32_t matrix[9]);
+    // 帧副数据 AV_FRAME_DATA_DISPLAYMATRIX 中的旋转角度，没有时返回 0
+    static int fromFrame(const AVFrame* frame);
+    // 90/270 度时宽高互换
+    static bool swapsAxes(int rotation) { return rotation == 90 || rotation == 270; }
+};
+
+#endif /* DISPLAY_ROTATION_H */
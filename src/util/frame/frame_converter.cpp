@@ -6,26 +6,25 @@
 //
 
 #include <stdio.h>
+#include <vector>
+#include <algorithm>
 #include "frame_converter.h"
 
-FrameConverter::FrameConverter() {
-    
+FrameConverter::FrameConverter(SwsContextCache* cache) : cache_(cache) {
+    if (!cache_) {
+        own_cache_.reset(new SwsContextCache(16));
+        cache_ = own_cache_.get();
+    }
+    sws_scaler_.reset(new SwsScaler(cache_));
+    autotuner_.reset(new ScalerAutotuner({sws_scaler_.get(), &simd_scaler_, &opencv_scaler_}));
 }
 
 FrameConverter::~FrameConverter() {
-    if (sws_ctx_) {
-        sws_freeContext(sws_ctx_);
-        sws_ctx_ = nullptr;
-    }
-    if (mid_frame_) {
-        av_frame_free(&mid_frame_);
-        mid_frame_ = nullptr;
-    }
 }
 
 /**
  * YUV→BGR格式转换 + 裁剪/黑边/拉伸 + 缩放
- * @param src_yuv 输入YUV帧（支持YUV420P、UYVY422）
+ * @param src_yuv 输入YUV帧（支持YUV420P、YUVJ420P、NV12、NV21、YUV422P、YUV444P、P010、YUV420P10、UYVY422）
  * @param dst_bgr 输出BGR帧（AV_PIX_FMT_BGR24）
  * @param dst_w 目标宽度
  * @param dst_h 目标高度
@@ -34,14 +33,95 @@ FrameConverter::~FrameConverter() {
  */
 bool FrameConverter::convertCropResizeYuvToBgr(const AVFrame* yuv_frame, AVFrame* bgr_frame,
                                               int dst_w, int dst_h, ResizeMode mode) {
+    if (!yuv_frame || !bgr_frame) {
+        LOG_ERROR("处理失败：输入/输出帧为空");
+        return false;
+    }
+    return convertRoiToBgr(yuv_frame, displayRect(yuv_frame), bgr_frame, dst_w, dst_h, mode);
+}
+
+bool FrameConverter::convertRoisToBgr(const AVFrame* yuv_frame, const std::vector<RoiRect>& rois,
+                                      const std::vector<AVFrame*>& bgr_frames,
+                                      int dst_w, int dst_h, ResizeMode mode) {
+    if (bgr_frames.size() < rois.size()) {
+        LOG_ERROR("ROI转换失败：输出帧数量（" + std::to_string(bgr_frames.size()) + "）少于ROI数量（" + std::to_string(rois.size()) + "）");
+        return false;
+    }
+    bool all_ok = true;
+    for (size_t i = 0; i < rois.size(); ++i) {
+        if (!convertRoiToBgr(yuv_frame, rois[i], bgr_frames[i], dst_w, dst_h, mode)) {
+            LOG_ERROR("第 " + std::to_string(i) + " 个ROI转换失败");
+            all_ok = false;
+        }
+    }
+    return all_ok;
+}
+
+RoiRect FrameConverter::displayRect(const AVFrame* frame) {
+    RoiRect rect;
+    const bool swap = DisplayRotation::swapsAxes(DisplayRotation::fromFrame(frame));
+    rect.width = swap ? frame->height : frame->width;
+    rect.height = swap ? frame->width : frame->height;
+    return rect;
+}
+
+RoiRect FrameConverter::displayRectToSource(const RoiRect& rect, int src_w, int src_h, int rotation) {
+    RoiRect source;
+    switch (rotation) {
+        case 90:    // 显示 (x, y) ← 源 (y, src_h - 1 - x)
+            source.x = rect.y;
+            source.y = src_h - rect.x - rect.width;
+            source.width = rect.height;
+            source.height = rect.width;
+            break;
+        case 180:   // 显示 (x, y) ← 源 (src_w - 1 - x, src_h - 1 - y)
+            source.x = src_w - rect.x - rect.width;
+            source.y = src_h - rect.y - rect.height;
+            source.width = rect.width;
+            source.height = rect.height;
+            break;
+        case 270:   // 显示 (x, y) ← 源 (src_w - 1 - y, x)
+            source.x = src_w - rect.y - rect.height;
+            source.y = rect.x;
+            source.width = rect.height;
+            source.height = rect.width;
+            break;
+        default:
+            source = rect;
+            break;
+    }
+    return source;
+}
+
+bool FrameConverter::clampRoi(const RoiRect& roi, int frame_w, int frame_h, RoiRect& clamped) {
+    const int x0 = std::max(0, roi.x);
+    const int y0 = std::max(0, roi.y);
+    const int x1 = std::min(frame_w, roi.x + roi.width);
+    const int y1 = std::min(frame_h, roi.y + roi.height);
+    clamped.x = x0;
+    clamped.y = y0;
+    clamped.width = x1 - x0;
+    clamped.height = y1 - y0;
+    return clamped.width >= 2 && clamped.height >= 2;
+}
+
+/**
+ * 画面区域 → BGR：格式转换 + 裁剪/黑边/拉伸 + 缩放（+ 按显示矩阵旋转）
+ * @param yuv_frame 输入YUV帧
+ * @param roi 显示方向上的画面区域（整幅画面时即 convertCropResizeYuvToBgr）
+ * @param bgr_frame 输出BGR帧（AV_PIX_FMT_BGR24）
+ * @return 成功返回true
+ */
+bool FrameConverter::convertRoiToBgr(const AVFrame* yuv_frame, const RoiRect& roi, AVFrame* bgr_frame,
+                                     int dst_w, int dst_h, ResizeMode mode) {
     // 1. 入参校验
     if (!yuv_frame || !bgr_frame) {
         LOG_ERROR("处理失败：输入/输出帧为空");
         return false;
     }
     AVPixelFormat src_fmt = static_cast<AVPixelFormat>(yuv_frame->format);
-    if (src_fmt != AV_PIX_FMT_YUV420P && src_fmt != AV_PIX_FMT_UYVY422) {
-        LOG_ERROR("暂不支持的YUV格式（仅支持YUV420P和UYVY422）");
+    if (!isSupportedFormat(src_fmt)) {
+        LOG_ERROR("暂不支持的YUV格式：" + std::string(av_get_pix_fmt_name(src_fmt) ? av_get_pix_fmt_name(src_fmt) : "none"));
         return false;
     }
     if (dst_w <= 0 || dst_h <= 0) {
@@ -49,18 +129,38 @@ bool FrameConverter::convertCropResizeYuvToBgr(const AVFrame* yuv_frame, AVFrame
         return false;
     }
     
-    int mid_w = dst_w, mid_h = dst_h;
-    int crop_w = yuv_frame->width, crop_h = yuv_frame->height;
-    int crop_x = 0, crop_y = 0;
-    calcCropResizeParams(yuv_frame->width, yuv_frame->height, dst_w, dst_h, mode, crop_x, crop_y, crop_w, crop_h, mid_w, mid_h);
+    // 几何在显示方向上计算（帧带显示矩阵时宽高可能互换），最后换算回源图坐标
+    const int rotation = DisplayRotation::fromFrame(yuv_frame);
+    const RoiRect display = displayRect(yuv_frame);
+    RoiRect region;
+    if (!clampRoi(roi, display.width, display.height, region)) {
+        LOG_ERROR("ROI无效（x=" + std::to_string(roi.x) + ", y=" + std::to_string(roi.y) +
+                  ", 宽=" + std::to_string(roi.width) + ", 高=" + std::to_string(roi.height) + "）");
+        return false;
+    }
     
+    // 缩放模式作用于 ROI：在 ROI 内计算裁剪区域，再平移到画面坐标
+    int mid_w = dst_w, mid_h = dst_h;
+    RoiRect crop;
+    crop.width = region.width;
+    crop.height = region.height;
+    calcCropResizeParams(region.width, region.height, dst_w, dst_h, mode, crop.x, crop.y, crop.width, crop.height, mid_w, mid_h);
+    crop.x += region.x;
+    crop.y += region.y;
+    crop = displayRectToSource(crop, yuv_frame->width, yuv_frame->height, rotation);
+    int crop_x = crop.x, crop_y = crop.y;
+    const int crop_w = crop.width, crop_h = crop.height;
     
     // 关键：检查并分配 bgr_frame 的缓冲区（若未分配）
     if (bgr_frame->width != dst_w ||
         bgr_frame->height != dst_h ||
         bgr_frame->format != AV_PIX_FMT_BGR24) {
-        // 尺寸/格式不匹配，先释放旧缓冲区
+        // 尺寸/格式不匹配，先释放旧缓冲区（新缓冲区可能分配在同一地址，黑边缓存作废）
         av_frame_unref(bgr_frame);
+        {
+            std::lock_guard<std::mutex> lock(border_mutex_);
+            border_data_ = nullptr;
+        }
         // 设置新的宽高和格式
         bgr_frame->width = dst_w;//yuv_frame->width;
         bgr_frame->height =dst_h;//yuv_frame->height;
@@ -72,74 +172,88 @@ bool FrameConverter::convertCropResizeYuvToBgr(const AVFrame* yuv_frame, AVFrame
         }
     }
     
-    // 准备数据源，为 crop 做数据准备
-    uint8_t* src_data[4]={nullptr};
-    int src_linesize[4]={0};
-    if (src_fmt == AV_PIX_FMT_YUV420P){
-        // yyyyuuvv
-        src_data[0] = const_cast<uint8_t*>(yuv_frame->data[0]) + crop_y * yuv_frame->linesize[0] + crop_x;
-        src_data[1] = const_cast<uint8_t*>(yuv_frame->data[1]) + crop_y * yuv_frame->linesize[1]/2 + crop_x/2;
-        src_data[2] = const_cast<uint8_t*>(yuv_frame->data[2]) + crop_y * yuv_frame->linesize[2]/2 + crop_x/2;
-        src_linesize[0] = yuv_frame->linesize[0];
-        src_linesize[1] = yuv_frame->linesize[1];
-        src_linesize[2] = yuv_frame->linesize[2];
-    }else if (src_fmt == AV_PIX_FMT_UYVY422) {
-        //bgrbgr
-        src_data[0] = const_cast<uint8_t*>(yuv_frame->data[0]) + crop_y * yuv_frame->linesize[0] + crop_x*2;
-        src_linesize[0] = yuv_frame->linesize[0];
+    // 准备数据源，为 crop 做数据准备：各平面按像素格式描述（色度下采样、每像素字节数）计算裁剪起点
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(src_fmt);
+    // 裁剪起点对齐到色度采样网格，保证亮度和色度对应同一位置
+    crop_x &= ~((1 << desc->log2_chroma_w) - 1);
+    crop_y &= ~((1 << desc->log2_chroma_h) - 1);
+    ScaleJob job;
+    const int plane_count = av_pix_fmt_count_planes(src_fmt);
+    for (int plane = 0; plane < plane_count; ++plane) {
+        // 该平面第一个分量的 step 即每个（色度）像素占用的字节数：NV12 的 UV 为 2，P010 的 UV 为 4，UYVY 的 Y 为 2
+        int step = 1;
+        for (int c = 0; c < desc->nb_components; ++c) {
+            if (desc->comp[c].plane == plane) {
+                step = desc->comp[c].step;
+                break;
+            }
+        }
+        const bool chroma = plane == 1 || plane == 2;
+        const int x = chroma ? (crop_x >> desc->log2_chroma_w) : crop_x;
+        const int y = chroma ? (crop_y >> desc->log2_chroma_h) : crop_y;
+        job.src_data[plane] = const_cast<uint8_t*>(yuv_frame->data[plane]) + static_cast<ptrdiff_t>(y) * yuv_frame->linesize[plane] + x * step;
+        job.src_linesize[plane] = yuv_frame->linesize[plane];
+    }
+    
+    // YUVJ420P 是已弃用的全范围格式：按 YUV420P 处理并显式指定全范围
+    const bool full_range = src_fmt == AV_PIX_FMT_YUVJ420P || yuv_frame->color_range == AVCOL_RANGE_JPEG;
+    if (src_fmt == AV_PIX_FMT_YUVJ420P) {
+        src_fmt = AV_PIX_FMT_YUV420P;
     }
     
-    // 创建缩放上下文
-    int current_dst_w = (mode == ResizeMode::KEEP_BLACK) ? mid_w : dst_w;
-    int current_dst_h = (mode == ResizeMode::KEEP_BLACK) ? mid_h : dst_h;
+    // 输出位置：KEEP_BLACK 时为目标帧中居中的有效区域（偏移后的指针），不经过中间帧
+    const int out_w = (mode == ResizeMode::KEEP_BLACK) ? mid_w : dst_w;
+    const int out_h = (mode == ResizeMode::KEEP_BLACK) ? mid_h : dst_h;
+    const int x_off = (dst_w - out_w) / 2;  // 水平黑边宽度
+    const int y_off = (dst_h - out_h) / 2;  // 垂直黑边高度
     
-    if (!initSwsContext(crop_w, crop_h, src_fmt,
-                        current_dst_w, current_dst_h, AV_PIX_FMT_BGR24)) {
-        return false;
+    job.frame = yuv_frame;
+    job.crop_x = crop_x;
+    job.crop_y = crop_y;
+    job.crop_w = crop_w;
+    job.crop_h = crop_h;
+    job.src_fmt = src_fmt;
+    job.src_full_range = full_range;
+    job.colorspace = yuv_frame->colorspace;
+    job.dst = bgr_frame->data[0] + y_off * bgr_frame->linesize[0] + x_off * 3;
+    job.dst_linesize = bgr_frame->linesize[0];
+    job.dst_w = out_w;
+    job.dst_h = out_h;
+    job.rotation = rotation;
+    
+    // STRETCH/CROP 会写满整个目标帧：这块缓冲区上次填过的黑边被画面覆盖，黑边缓存作废
+    if (mode != ResizeMode::KEEP_BLACK) {
+        std::lock_guard<std::mutex> lock(border_mutex_);
+        if (bgr_frame->data[0] == border_data_) {
+            border_data_ = nullptr;
+        }
     }
     
-    // 执行缩放（同时转换格式）
+    // 执行缩放（同时转换格式）：swscale 处理大图且帧缓冲区为引用计数时按切片并行，否则由选中的后端一次完成；
+    // 需要旋转但没有后端能在取样时旋转（SIMD 内核不支持的格式）时，先缩放再旋转
+    FrameScaler* scaler = selectScaler(job);
+    // 画面中的局部区域（检测框）：每个尺寸都对应一个 SwsContext，框的尺寸各不相同会不断新建上下文、挤占缓存；
+    // SIMD 内核不需要按尺寸创建上下文，格式支持时 ROI 改走内核
+    const bool partial = region.width != display.width || region.height != display.height;
+    if (partial && scaler == sws_scaler_.get() && simd_scaler_.supports(job)) {
+        scaler = &simd_scaler_;
+    }
     bool success = false;
-    if (mode != ResizeMode::KEEP_BLACK) {
-        int ret = sws_scale(sws_ctx_, src_data, src_linesize, 0, crop_h, bgr_frame->data, bgr_frame->linesize);
-        success = ret == dst_h;
+    if (!scaler) {
+        success = scaleThenRotate(job);
+    } else if (scaler == sws_scaler_.get() && slice_count_ > 1 && crop_w * crop_h >= slice_min_src_pixels_ &&
+        yuv_frame->buf[0] && bgr_frame->buf[0]) {
+        success = scaleSliced(SwsScaler::makeKey(job), yuv_frame, job.src_data, bgr_frame, job.dst);
     } else {
-        if (!mid_frame_) {
-            mid_frame_ = av_frame_alloc();
-        }
-        // 检查中间帧尺寸是否匹配，不匹配则重新分配
-        if (mid_frame_->width != mid_w || mid_frame_->height != mid_h || mid_frame_->format != AV_PIX_FMT_BGR24) {
-            av_frame_unref(mid_frame_);  // 释放旧缓冲区
-            mid_frame_->width = mid_w;
-            mid_frame_->height = mid_h;
-            mid_frame_->format = AV_PIX_FMT_BGR24;
-            if (av_frame_get_buffer(mid_frame_, 32) < 0) {
-                LOG_ERROR("中间帧缓冲区分配失败");
-                return false;
-            }
-        }
-        //先缩放到中间帧
-        int ret = sws_scale(sws_ctx_, src_data, src_linesize, 0, crop_h, mid_frame_->data, mid_frame_->linesize);
-        if (ret != mid_h) {
-            LOG_ERROR("中间帧缩放失败");
-            return false;
-        }
-        
-        memset(bgr_frame->data[0], 0, bgr_frame->linesize[0]*bgr_frame->height);
-        // 居中复制中间帧到目标帧（计算偏移：水平/垂直居中）
-        const int x_off = (dst_w - mid_w) / 2;  // 水平黑边宽度
-        const int y_off = (dst_h - mid_h) / 2;  // 垂直黑边高度
-        for (int y = 0; y < mid_h; ++y) {
-            uint8_t* src_row = mid_frame_->data[0]+mid_frame_->linesize[0]*y;
-            uint8_t* dst_row = bgr_frame->data[0]+bgr_frame->linesize[0] * (y+y_off) + x_off*3;
-            memcpy(dst_row, src_row, mid_w * 3);
-        }
-        success = true;
+        success = scaler->scale(job);
     }
     if (!success) {
         LOG_ERROR("缩放失败（实际处理行数不匹配）");
         return false;
     }
+    if (mode == ResizeMode::KEEP_BLACK) {
+        fillLetterboxBorder(bgr_frame, x_off, y_off, mid_w, mid_h);
+    }
     
     return true;
 }
@@ -189,29 +303,200 @@ void FrameConverter::calcCropResizeParams(int src_w, int src_h, int dst_w, int d
     }
 }
 
-bool FrameConverter::initSwsContext(int src_w, int src_h, AVPixelFormat src_fmt, int dst_w, int dst_h, AVPixelFormat dst_fmt){
-    if (sws_ctx_ && src_w == last_src_w_ && src_h == last_src_h_ && src_fmt == last_src_fmt_ && dst_w == last_dst_w_ && dst_h == last_dst_h_) {
-        return true;
+void FrameConverter::setScalerBackend(ScalerBackend backend) {
+    scaler_backend_ = backend;
+}
+
+FrameScaler* FrameConverter::selectScaler(const ScaleJob& job) {
+    FrameScaler* scaler = nullptr;
+    switch (scaler_backend_) {
+        case ScalerBackend::AUTO:
+            scaler = autotuner_->select(job);
+            break;
+        case ScalerBackend::OPENCV:
+            scaler = &opencv_scaler_;
+            break;
+        case ScalerBackend::SIMD:
+            scaler = &simd_scaler_;
+            break;
+        default:
+            break;
     }
-    
-    if (sws_ctx_) {
-        sws_freeContext(sws_ctx_);
-    }
-    // 创建新上下文
-    sws_ctx_ = sws_getContext(
-                                    src_w, src_h, src_fmt,
-                                    dst_w, dst_h, dst_fmt,
-                                    SWS_BILINEAR, nullptr, nullptr, nullptr
-                                    );
-    if (!sws_ctx_) {
-        LOG_ERROR("创建缩放上下文失败");
+    // 指定的后端不支持该任务（格式、颜色空间、奇数尺寸、旋转）时回退：swscale，需要旋转时为 SIMD
+    if (!scaler || !scaler->supports(job)) {
+        scaler = sws_scaler_.get();
+        if (!scaler->supports(job)) {
+            scaler = simd_scaler_.supports(job) ? &simd_scaler_ : nullptr;
+        }
+    }
+    return scaler;
+}
+
+bool FrameConverter::scaleThenRotate(const ScaleJob& job) {
+    // 按源图方向缩放到临时缓冲区（输出尺寸很小，如 224x224），再旋转写入目标区域
+    thread_local std::vector<uint8_t> scaled;
+    const bool swap = DisplayRotation::swapsAxes(job.rotation);
+    ScaleJob upright = job;
+    upright.rotation = 0;
+    upright.dst_w = swap ? job.dst_h : job.dst_w;
+    upright.dst_h = swap ? job.dst_w : job.dst_h;
+    upright.dst_linesize = upright.dst_w * 3;
+    scaled.resize(static_cast<size_t>(upright.dst_linesize) * upright.dst_h);
+    upright.dst = scaled.data();
+    if (!sws_scaler_->scale(upright)) {
         return false;
     }
-    // 更新缓存参数
-    last_src_w_ = src_w;
-    last_src_h_ = src_h;
-    last_src_fmt_ = src_fmt;
-    last_dst_w_ = dst_w;
-    last_dst_h_ = dst_h;    
+    const int w = upright.dst_w, h = upright.dst_h;
+    for (int y = 0; y < job.dst_h; ++y) {
+        uint8_t* dst = job.dst + static_cast<size_t>(y) * job.dst_linesize;
+        for (int x = 0; x < job.dst_w; ++x) {
+            int sx = x, sy = y;
+            if (job.rotation == 90) {
+                sx = y;
+                sy = h - 1 - x;
+            } else if (job.rotation == 180) {
+                sx = w - 1 - x;
+                sy = h - 1 - y;
+            } else if (job.rotation == 270) {
+                sx = w - 1 - y;
+                sy = x;
+            }
+            const uint8_t* src = scaled.data() + static_cast<size_t>(sy) * upright.dst_linesize + sx * 3;
+            dst[3 * x] = src[0];
+            dst[3 * x + 1] = src[1];
+            dst[3 * x + 2] = src[2];
+        }
+    }
     return true;
 }
+
+void FrameConverter::setSliceThreads(int slice_count, ThreadPool* pool, int min_src_pixels) {
+    slice_count_ = slice_count;
+    slice_pool_ = pool;
+    slice_min_src_pixels_ = min_src_pixels;
+}
+
+bool FrameConverter::scaleSliced(const SwsContextCache::Key& key, const AVFrame* yuv_frame, uint8_t* const src_data[4],
+                                 AVFrame* bgr_frame, uint8_t* dst_data0) {
+    // 切片接口要求引用计数帧：用裁剪后的数据指针构造源/目标的视图帧（只增加引用，不复制像素）
+    AVFrame* src_view = av_frame_alloc();
+    AVFrame* dst_view = av_frame_alloc();
+    if (!src_view || !dst_view || av_frame_ref(src_view, yuv_frame) < 0 || av_frame_ref(dst_view, bgr_frame) < 0) {
+        av_frame_free(&src_view);
+        av_frame_free(&dst_view);
+        LOG_ERROR("切片缩放：引用帧失败");
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        src_view->data[i] = src_data[i];
+    }
+    src_view->width = key.src_w;
+    src_view->height = key.src_h;
+    src_view->format = key.src_fmt;
+    dst_view->data[0] = dst_data0;
+    dst_view->width = key.dst_w;
+    dst_view->height = key.dst_h;
+    
+    // 每个切片独占一个上下文：各自读入整幅源图，只输出自己那条的行，结果与单上下文逐像素一致
+    const int slice_count = std::min(slice_count_, key.dst_h);
+    std::vector<SwsContext*> contexts(slice_count, nullptr);
+    bool success = true;
+    for (int i = 0; i < slice_count; ++i) {
+        contexts[i] = cache_->acquire(key);
+        if (!contexts[i]) {
+            LOG_ERROR("创建缩放上下文失败");
+            success = false;
+            break;
+        }
+    }
+    if (success) {
+        const int align = std::max(1u, sws_receive_slice_alignment(contexts[0]));
+        const int rows = (key.dst_h + slice_count - 1) / slice_count;
+        const int slice_rows = (rows + align - 1) / align * align;
+        std::vector<char> results(slice_count, 1);
+        ThreadPool& pool = slice_pool_ ? *slice_pool_ : ThreadPool::shared();
+        pool.parallelFor(slice_count, [&](int i) {
+            const int start = i * slice_rows;
+            if (start >= key.dst_h) {
+                return;
+            }
+            const int height = std::min(slice_rows, key.dst_h - start);
+            SwsContext* sws_ctx = contexts[i];
+            int ret = sws_frame_start(sws_ctx, dst_view, src_view);
+            if (ret >= 0) {
+                ret = sws_send_slice(sws_ctx, 0, key.src_h);
+            }
+            if (ret >= 0) {
+                ret = sws_receive_slice(sws_ctx, start, height);
+            }
+            sws_frame_end(sws_ctx);
+            results[i] = ret >= 0;
+        });
+        success = std::all_of(results.begin(), results.end(), [](char ok) { return ok != 0; });
+    }
+    for (SwsContext* sws_ctx : contexts) {
+        cache_->release(key, sws_ctx);
+    }
+    av_frame_free(&src_view);
+    av_frame_free(&dst_view);
+    return success;
+}
+
+void FrameConverter::setBorderCacheEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(border_mutex_);
+    border_cache_enabled_ = enabled;
+    border_data_ = nullptr;
+}
+
+void FrameConverter::fillLetterboxBorder(AVFrame* bgr_frame, int x_off, int y_off, int mid_w, int mid_h) {
+    std::lock_guard<std::mutex> lock(border_mutex_);
+    // 同一块缓冲区、同样的几何：上次填的黑边还在（缓存开启时调用方保证画面区域之外没有被写过）
+    if (border_cache_enabled_ && bgr_frame->data[0] == border_data_ && bgr_frame->linesize[0] == border_linesize_ &&
+        bgr_frame->width == border_dst_w_ && bgr_frame->height == border_dst_h_ &&
+        mid_w == border_mid_w_ && mid_h == border_mid_h_) {
+        return;
+    }
+    const int dst_w = bgr_frame->width;
+    const int dst_h = bgr_frame->height;
+    const int linesize = bgr_frame->linesize[0];
+    uint8_t* data = bgr_frame->data[0];
+    // 上下黑边：整行清零
+    for (int y = 0; y < y_off; ++y) {
+        memset(data + y * linesize, 0, dst_w * 3);
+    }
+    for (int y = y_off + mid_h; y < dst_h; ++y) {
+        memset(data + y * linesize, 0, dst_w * 3);
+    }
+    // 左右黑边：只清画面两侧
+    const int right_w = dst_w - x_off - mid_w;
+    if (x_off > 0 || right_w > 0) {
+        for (int y = y_off; y < y_off + mid_h; ++y) {
+            uint8_t* row = data + y * linesize;
+            memset(row, 0, x_off * 3);
+            memset(row + (x_off + mid_w) * 3, 0, right_w * 3);
+        }
+    }
+    border_data_ = data;
+    border_linesize_ = linesize;
+    border_dst_w_ = dst_w;
+    border_dst_h_ = dst_h;
+    border_mid_w_ = mid_w;
+    border_mid_h_ = mid_h;
+}
+
+bool FrameConverter::isSupportedFormat(AVPixelFormat fmt) {
+    switch (fmt) {
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P:
+        case AV_PIX_FMT_NV12:
+        case AV_PIX_FMT_NV21:
+        case AV_PIX_FMT_YUV422P:
+        case AV_PIX_FMT_YUV444P:
+        case AV_PIX_FMT_P010LE:
+        case AV_PIX_FMT_YUV420P10LE:
+        case AV_PIX_FMT_UYVY422:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -11,12 +11,23 @@
 #include <stdio.h>
 #include <iostream>
 #include <stdlib.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 extern "C" {
 #include <libswscale/swscale.h>
+#include <libavutil/pixdesc.h>
 }
 
 #include "../../common/log/log.h"
+#include "sws_context_cache.h"
+#include "display_rotation.h"
+#include "scaler/sws_scaler.h"
+#include "scaler/opencv_scaler.h"
+#include "scaler/simd_scaler.h"
+#include "scaler/scaler_autotuner.h"
+#include "../thread/thread_pool.h"
 
 enum class ResizeMode {
     STRETCH,    // 拉伸：直接缩放到目标尺寸（可能变形）
@@ -24,14 +35,62 @@ enum class ResizeMode {
     CROP        // 裁剪适配：先裁剪到目标比例，再缩放（无变形、无黑边）
 };
 
+// 画面中的感兴趣区域（检测框），坐标为显示方向（按显示矩阵旋转后）的亮度像素
+struct RoiRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * 帧转换服务：SwsContext 从 LRU 缓存中按调用租用，同一个转换器可以服务多路流、多种输出尺寸，
+ * 也可以被多个工作线程同时调用（每次调用独占一个上下文，目标帧不能同时被多个线程写入）
+ */
 class FrameConverter {
     
 public:
-    FrameConverter();
+    /**
+     * @param cache 共享的上下文缓存（由调用者持有，生命周期需长于转换器）；nullptr 时使用自己的缓存
+     */
+    explicit FrameConverter(SwsContextCache* cache = nullptr);
     ~FrameConverter();
+    
+    /**
+     * 切片并行缩放（单路低延迟场景，如 4K 输入）：目标画面按行切成 slice_count 条，
+     * 每条用独立的 SwsContext 在线程池上并发输出，结果与单上下文逐像素一致
+     * @param slice_count 切片数（<= 1 关闭，默认关闭）
+     * @param pool 线程池（调用者持有），nullptr 使用 ThreadPool::shared()
+     * @param min_src_pixels 裁剪后源图像素数低于该值时不切片（小图切片的调度开销大于收益）
+     * @note 只追求单帧延迟：每个切片都要做完整的水平缩放准备，总 CPU 略有增加；
+     *       多路并发时各路本身已占满核心，不要开启
+     */
+    void setSliceThreads(int slice_count, ThreadPool* pool = nullptr, int min_src_pixels = 1920 * 1080);
+    
+    /**
+     * 缩放 + 颜色转换后端（默认 SWSCALE）
+     * AUTO：每种（格式、目标尺寸、缩放比例档位）第一次出现时用当前帧实测 swscale / SIMD / OpenCV，之后使用最快的；
+     * 指定的后端不支持当前输入时回退到 swscale；切片并行缩放只在选中 swscale 时生效
+     * @note 各后端的插值取整不同，输出不逐像素一致，需要与历史结果逐像素对比时保持 SWSCALE
+     */
+    void setScalerBackend(ScalerBackend backend);
+    ScalerBackend scalerBackend() const { return scaler_backend_; }
+    // AUTO 模式的测速结果
+    ScalerAutotuner& autotuner() { return *autotuner_; }
+    
+    // 上下文缓存（命中/未命中/淘汰计数）
+    SwsContextCache& contextCache() { return *cache_; }
+    
+    /**
+     * KEEP_BLACK 黑边缓存（默认关闭：每次都填充黑边，只是几条 memset）
+     * 开启后目标缓冲区地址和几何与上次相同时跳过填充，适合反复写入同一个常驻目标帧的渲染输出
+     * @note 开启时调用方需保证：不在黑边区域绘制内容（如叠加文字），目标帧不被释放后重新分配
+     *       （帧池 / av_frame_get_buffer 可能把新缓冲区分配在同一地址）；否则黑边会残留旧内容
+     */
+    void setBorderCacheEnabled(bool enabled);
     /**
      * YUV→BGR格式转换 + 裁剪/黑边/拉伸 + 缩放
-     * @param src_yuv 输入YUV帧（支持YUV420P、UYVY422）
+     * @param src_yuv 输入YUV帧（支持YUV420P、YUVJ420P、NV12、NV21、YUV422P、YUV444P、P010、YUV420P10、UYVY422，由选中的缩放后端一次完成）
      * @param dst_bgr 输出BGR帧（AV_PIX_FMT_BGR24）
      * @param dst_w 目标宽度（如224）
      * @param dst_h 目标高度（如224）
@@ -40,19 +99,81 @@ public:
      */
     bool convertCropResizeYuvToBgr(const AVFrame* yuv_frame, AVFrame* bgr_frame, int dst_w, int dst_h, ResizeMode mode = ResizeMode::KEEP_BLACK);
     
+    /**
+     * 只转换画面中的一个区域：ROI 代替整幅画面作为缩放模式的输入（CROP 在 ROI 内居中裁剪，KEEP_BLACK 按 ROI 比例加黑边）
+     * @param roi 感兴趣区域（超出画面的部分会被裁掉）
+     * @return 成功返回true；ROI 与画面没有交集或小于 2x2 时返回false
+     * @note ROI 小于整幅画面且选中 swscale 时，YUV420P/YUVJ420P/NV12/NV21 改用 SIMD 内核（无需按尺寸创建上下文，
+     *       输出与 swscale 不逐像素一致）；其余格式仍走 swscale，每种不同的 ROI 尺寸都要新建一个 SwsContext，
+     *       尺寸种类超过缓存容量时会反复重建
+     */
+    bool convertRoiToBgr(const AVFrame* yuv_frame, const RoiRect& roi, AVFrame* bgr_frame,
+                         int dst_w, int dst_h, ResizeMode mode = ResizeMode::KEEP_BLACK);
+    
+    /**
+     * 一次调用处理同一帧的多个 ROI（两阶段流水线：检测框 → 分类），第 i 个 ROI 写入 bgr_frames[i]
+     * 输出帧尺寸不变时不重新分配；缩放后端的选择同 convertRoiToBgr（4:2:0 格式不创建 SwsContext）
+     * @return 全部成功返回true；失败的 ROI 会记录日志，其余 ROI 仍然处理
+     */
+    bool convertRoisToBgr(const AVFrame* yuv_frame, const std::vector<RoiRect>& rois,
+                          const std::vector<AVFrame*>& bgr_frames,
+                          int dst_w, int dst_h, ResizeMode mode = ResizeMode::KEEP_BLACK);
+    
+    // ROI 与画面求交，结果小于 2x2 时返回false
+    static bool clampRoi(const RoiRect& roi, int frame_w, int frame_h, RoiRect& clamped);
+    
+    /**
+     * 旋转：帧带有显示矩阵副数据（AV_FRAME_DATA_DISPLAYMATRIX，VideoDecoder 会把流的显示矩阵附到每一帧）时，
+     * 输出为旋转后的正确朝向，ROI 和缩放模式都按显示方向计算
+     * YUV420P/YUVJ420P/NV12/NV21 在 SIMD 内核取样时完成旋转（不增加额外步骤）；其余格式先缩放再旋转小尺寸结果
+     * @return 显示方向上的整幅画面（90/270 度时宽高互换）
+     */
+    static RoiRect displayRect(const AVFrame* frame);
+    // 显示方向上的矩形换算为源图坐标（rotation 为顺时针角度）
+    static RoiRect displayRectToSource(const RoiRect& rect, int src_w, int src_h, int rotation);
+    
+    // 是否支持该输入像素格式
+    static bool isSupportedFormat(AVPixelFormat fmt);
+    
+    // 计算缩放/裁剪参数（源图裁剪区域 + KEEP_BLACK 模式下的有效画面尺寸），调用前 crop_* 为整幅画面、mid_* 为目标尺寸
+    static void calcCropResizeParams(int src_w, int src_h, int dst_w, int dst_h, ResizeMode mode, int& crop_x, int& crop_y, int& crop_w, int& crop_h, int& mid_w, int& mid_h);
+    
 private:
-    SwsContext* sws_ctx_ = nullptr;
-    AVFrame* mid_frame_ = nullptr;
+    std::unique_ptr<SwsContextCache> own_cache_;
+    SwsContextCache* cache_ = nullptr;
     
-    // 缓存上一次的转换参数
-    int last_src_w_ = -1, last_src_h_ = -1;
-    AVPixelFormat last_src_fmt_ = AV_PIX_FMT_NONE;
-    int last_dst_w_ = -1, last_dst_h_ = -1;
+    // 缩放后端（无状态或内部加锁，可被多个线程同时使用）
+    std::unique_ptr<SwsScaler> sws_scaler_;
+    OpenCvScaler opencv_scaler_;
+    SimdScaler simd_scaler_;
+    std::unique_ptr<ScalerAutotuner> autotuner_;
+    ScalerBackend scaler_backend_ = ScalerBackend::SWSCALE;
     
+    // 切片并行缩放
+    int slice_count_ = 1;
+    ThreadPool* slice_pool_ = nullptr;
+    int slice_min_src_pixels_ = 1920 * 1080;
     
-    // 计算缩放/裁剪参数
-    void calcCropResizeParams(int src_w, int src_h, int dst_w, int dst_h, ResizeMode mode, int& crop_x, int& crop_y, int& crop_w, int& crop_h, int& mid_w, int& mid_h);
-    bool initSwsContext(int src_w, int src_h, AVPixelFormat src_fmt, int dst_w, int dst_h, AVPixelFormat dst_fmt);
+    // 上一次填充黑边的目标缓冲区和几何（开启黑边缓存且相同时跳过填充），多线程调用时由 border_mutex_ 保护
+    std::mutex border_mutex_;
+    bool border_cache_enabled_ = false;
+    const uint8_t* border_data_ = nullptr;
+    int border_linesize_ = 0;
+    int border_dst_w_ = -1, border_dst_h_ = -1;
+    int border_mid_w_ = -1, border_mid_h_ = -1;
+    
+    /**
+     * KEEP_BLACK：只填充有效画面四周的黑边
+     * @note 开启黑边缓存且目标缓冲区和几何与上次相同时直接跳过；转换器自己以 STRETCH/CROP 写入该缓冲区时缓存作废
+     */
+    void fillLetterboxBorder(AVFrame* bgr_frame, int x_off, int y_off, int mid_w, int mid_h);
+    // 按当前后端设置选择本次任务的后端（不支持时回退到 swscale；需要旋转而没有后端支持时返回 nullptr）
+    FrameScaler* selectScaler(const ScaleJob& job);
+    // 先按源图方向用 swscale 缩放到临时缓冲区，再旋转写入目标区域
+    bool scaleThenRotate(const ScaleJob& job);
+    // 切片并行缩放（源/目标帧需为引用计数帧），dst_data0 为目标有效区域起点
+    bool scaleSliced(const SwsContextCache::Key& key, const AVFrame* yuv_frame, uint8_t* const src_data[4],
+                     AVFrame* bgr_frame, uint8_t* dst_data0);
 };
 
 
@@ -14,7 +14,9 @@
 template <typename PoolType>
 class MediaFrameGuard {
 public:
-    explicit MediaFrameGuard(PoolType& pool, MediaFramePtr frame):pool_(pool),frame_(std::move(frame)){}
+    using FramePtr = typename PoolType::FramePtr;
+    
+    explicit MediaFrameGuard(PoolType& pool, FramePtr frame):pool_(pool),frame_(std::move(frame)){}
     
     // 禁止复制（避免同一帧被多次归还）
     MediaFrameGuard(const MediaFrameGuard&) = delete;
@@ -26,31 +28,23 @@ public:
     
     ~MediaFrameGuard() {
         if (frame_) {
-            pool_.returnFrame(std::move(frame_));
+            pool_.release(std::move(frame_));
         }
     }
     
     // 获取智能指针（用于访问帧的成员）
-    MediaFramePtr get() {
-        return frame_;
-    }
-    
-    MediaFramePtr& get() const {
+    const FramePtr& get() const {
         return frame_;
     }
     
     // 重载 -> 运算符
-    MediaFramePtr* operator->() {
-        return &frame_;
-    }
-    
-    const MediaFramePtr* operator->() const {
-        return &frame_;
+    typename FramePtr::element_type* operator->() const {
+        return frame_.get();
     }
     
 private:
     PoolType& pool_; // 帧池引用（生命周期由外部保证）
-    MediaFramePtr frame_;  // 管理的帧
+    FramePtr frame_;  // 管理的帧
 };
 
 #endif /* FRAME_GUARD_H */
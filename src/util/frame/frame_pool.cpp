@@ -14,7 +14,7 @@ MediaFramePool::MediaFramePool(size_t max_cache_per_key):max_cache_size_(max_cac
 }
 
 //从池子里取
-MediaFramePtr MediaFramePool::acquire(int width, int height, PixelFormat fmt) {
+VideoFrame::Ptr MediaFramePool::acquire(int width, int height, PixelFormat fmt) {
     if (width <= 0 || height <= 0 || fmt == PixelFormat::UNKNOWN) {
         throw std::invalid_argument("MediaFramePool;:acquire width/height/fmt invalid");
     }
@@ -22,21 +22,23 @@ MediaFramePtr MediaFramePool::acquire(int width, int height, PixelFormat fmt) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = cache_.find(key);
     if (it != cache_.end() && !it->second.empty()) {
-        MediaFramePtr media_frame = it->second.front();
+        VideoFrame::Ptr media_frame = it->second.front();
         it->second.pop();
         reset_frame(media_frame.get());
         return media_frame;
     }
-    return MediaFrame::createEmpty(width, height, fmt);
+    return VideoFrame::create(width, height, fmt);
 }
 
 //释放
-void MediaFramePool::release(MediaFramePtr frame) {
+void MediaFramePool::release(VideoFrame::Ptr frame) {
     if (!frame) {
         return;
     }
+    // 零拷贝帧：立即归还解码器缓冲区，不让帧池拖住解码器的 AVBufferPool
+    frame->unrefAVFrame();
     
-    FrameKey key{frame->width(),frame->height(),frame->format()};
+    FrameKey key{frame->width(),frame->height(),frame->pixelFormat()};
     std::lock_guard<std::mutex> lock(mutex_);
     auto& queue = cache_[key];
     if (queue.size() < max_cache_size_) {
@@ -57,9 +59,53 @@ void MediaFramePool::clearAll() {
     cache_.clear();
 }
 
-void MediaFramePool::reset_frame(MediaFrame *frame) {
+void MediaFramePool::reset_frame(VideoFrame *frame) {
     if(!frame) return;
     frame->setPts(-1);
-    frame->setTimeBase(1, 1);
+    frame->setDts(-1);
+    frame->setDuration(0);
+    frame->setMotionScore(-1.0f);
 }
 
+
+AudioFramePool::AudioFramePool(size_t max_cache_per_key):max_cache_size_(max_cache_per_key) {
+    
+}
+
+AudioFrame::Ptr AudioFramePool::acquire(int sample_rate, int channels, SampleFormat fmt) {
+    if (sample_rate <= 0 || channels <= 0 || fmt == SampleFormat::UNKNOWN) {
+        throw std::invalid_argument("AudioFramePool::acquire sample_rate/channels/fmt invalid");
+    }
+    AudioFrameKey key{sample_rate,channels,fmt};
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end() && !it->second.empty()) {
+        AudioFrame::Ptr audio_frame = it->second.front();
+        it->second.pop();
+        audio_frame->setPts(-1);
+        audio_frame->setDts(-1);
+        audio_frame->setDuration(0);
+        return audio_frame;
+    }
+    return AudioFrame::create(sample_rate, channels, fmt, 0);
+}
+
+void AudioFramePool::release(AudioFrame::Ptr frame) {
+    if (!frame) {
+        return;
+    }
+    // 零拷贝帧：立即归还解码器缓冲区
+    frame->unrefAVFrame();
+    
+    AudioFrameKey key{frame->sampleRate(),frame->channels(),frame->sampleFormat()};
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& queue = cache_[key];
+    if (queue.size() < max_cache_size_) {
+        queue.push(std::move(frame));
+    }
+}
+
+void AudioFramePool::clearAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+}
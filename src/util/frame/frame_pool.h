@@ -25,6 +25,16 @@ struct FrameKey {
     }
 };
 
+struct AudioFrameKey {
+    int sample_rate;
+    int channels;
+    SampleFormat format;
+    
+    bool operator == (const AudioFrameKey& other) const {
+        return sample_rate == other.sample_rate && channels == other.channels && format == other.format;
+    }
+};
+
 namespace std {
 template<> struct hash<FrameKey> {
     size_t operator()(const FrameKey& key) const {
@@ -35,15 +45,27 @@ template<> struct hash<FrameKey> {
         return hash_val;
         }
     };
+template<> struct hash<AudioFrameKey> {
+    size_t operator()(const AudioFrameKey& key) const {
+        size_t hash_val = 17;
+        hash_val = hash_val * 31 + hash<int>()(key.sample_rate);
+        hash_val = hash_val * 31 + hash<int>()(key.channels);
+        hash_val = hash_val * 31 + hash<int>()(static_cast<int>(key.format));
+        return hash_val;
+        }
+    };
 }
 
 /**
- * 标准帧池：复用 MediaFrame，减少 Frame 频繁分配/释放的开销
+ * 标准帧池：复用 VideoFrame，减少 Frame 频繁分配/释放的开销
  * 线程安全，支持多线程并发 acquire/release
+ * 零拷贝帧归还时会释放对解码器缓冲区的引用，深拷贝帧保留自有缓冲区以便复用
  */
 class MediaFramePool {
 
 public:
+    using FramePtr = VideoFrame::Ptr;
+    
     explicit MediaFramePool(size_t max_cache_per_key = 30);
     
     //不允许拷贝构造
@@ -54,11 +76,11 @@ public:
     MediaFramePool(MediaFramePool&&) noexcept = default;
     MediaFramePool& operator=(MediaFramePool&&) noexcept = default;
     
-    //获取帧，若没有，则内部新建
-    MediaFramePtr acquire(int width, int height, PixelFormat fmt);
+    //获取帧，若没有，则内部新建（新建的帧不分配缓冲区）
+    VideoFrame::Ptr acquire(int width, int height, PixelFormat fmt);
     
-    //释放
-    void release(MediaFramePtr frame);
+    //释放（归还帧池）
+    void release(VideoFrame::Ptr frame);
     
     //清理指定的帧池
     void clear(int width, int height, PixelFormat fmt);
@@ -67,20 +89,53 @@ public:
     void clearAll();
     
     
-    int setMaxCacheSize(int max_size) {
+    void setMaxCacheSize(int max_size) {
         std::lock_guard<std::mutex> lock(mutex_);
         max_cache_size_ = max_size;
-        
     }
     
 private:
     // 重置帧状态（复用前清理临时数据）
-    void reset_frame(MediaFrame* frame);
+    void reset_frame(VideoFrame* frame);
     
     mutable std::mutex mutex_; //锁
     size_t max_cache_size_ = 30; //最大缓存数
-    std::unordered_map<FrameKey, std::queue<MediaFramePtr>> cache_;
+    std::unordered_map<FrameKey, std::queue<VideoFrame::Ptr>> cache_;
+
+};
+
+/**
+ * 音频帧池：复用 AudioFrame，用法与 MediaFramePool 相同
+ * 线程安全；零拷贝帧归还时释放对解码器缓冲区的引用
+ */
+class AudioFramePool {
 
+public:
+    using FramePtr = AudioFrame::Ptr;
+    
+    explicit AudioFramePool(size_t max_cache_per_key = 64);
+    
+    AudioFramePool(const AudioFramePool&) = delete;
+    AudioFramePool& operator=(const AudioFramePool&) = delete;
+    
+    //获取帧，若没有，则内部新建（新建的帧不分配缓冲区）
+    AudioFrame::Ptr acquire(int sample_rate, int channels, SampleFormat fmt);
+    
+    //释放（归还帧池）
+    void release(AudioFrame::Ptr frame);
+    
+    //清理所有
+    void clearAll();
+    
+    void setMaxCacheSize(int max_size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_cache_size_ = max_size;
+    }
+    
+private:
+    mutable std::mutex mutex_;
+    size_t max_cache_size_ = 64;
+    std::unordered_map<AudioFrameKey, std::queue<AudioFrame::Ptr>> cache_;
 };
 
 
@@ -0,0 +1,59 @@
+//
+//  frame_scaler.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef FRAME_SCALER_H
+#define FRAME_SCALER_H
+
+#include <cstdint>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+// 缩放 + 颜色转换后端
+enum class ScalerBackend {
+    AUTO,       // 按实际几何/格式启动时测速，选最快的
+    SWSCALE,    // libswscale（SWS_BILINEAR，默认）
+    OPENCV,     // cv::resize + cv::cvtColor
+    SIMD        // 工程内的 YuvResizeKernel（AVX2）
+};
+
+// 一次缩放任务：源帧裁剪区域 → BGR24 输出区域
+struct ScaleJob {
+    const AVFrame* frame = nullptr;                 // 源帧（完整平面、颜色属性）
+    uint8_t* src_data[4] = {nullptr, nullptr, nullptr, nullptr};   // 裁剪区域在各平面的起点
+    int src_linesize[4] = {0, 0, 0, 0};
+    int crop_x = 0;                                 // 裁剪区域（亮度坐标，起点已对齐到色度网格）
+    int crop_y = 0;
+    int crop_w = 0;
+    int crop_h = 0;
+    AVPixelFormat src_fmt = AV_PIX_FMT_NONE;        // YUVJ420P 已换成 YUV420P + src_full_range
+    bool src_full_range = false;
+    int colorspace = AVCOL_SPC_UNSPECIFIED;
+    uint8_t* dst = nullptr;                         // BGR24 输出区域起点
+    int dst_linesize = 0;
+    int dst_w = 0;                                  // 输出尺寸（旋转后的方向）
+    int dst_h = 0;
+    int rotation = 0;                               // 顺时针旋转角度（0/90/180/270）
+};
+
+/**
+ * 缩放后端接口：实现需线程安全（FrameConverter 可能被多个线程同时调用）
+ * 各后端的插值和取整细节不同，输出不逐像素一致，但几何和颜色矩阵一致
+ */
+class FrameScaler {
+public:
+    virtual ~FrameScaler() = default;
+    virtual ScalerBackend backend() const = 0;
+    virtual const char* name() const = 0;
+    // 是否能处理该任务（格式、颜色空间、尺寸限制、能否在缩放时旋转）
+    virtual bool supports(const ScaleJob& job) const = 0;
+    virtual bool scale(const ScaleJob& job) = 0;
+};
+
+#endif /* FRAME_SCALER_H */
@@ -0,0 +1,55 @@
+//
+//  opencv_scaler.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "opencv_scaler.h"
+
+bool OpenCvScaler::supports(const ScaleJob& job) const {
+    const bool format_ok = job.src_fmt == AV_PIX_FMT_YUV420P || job.src_fmt == AV_PIX_FMT_NV12 || job.src_fmt == AV_PIX_FMT_NV21;
+    const bool colorspace_ok = !job.src_full_range && job.colorspace != AVCOL_SPC_BT709;
+    const bool size_ok = job.crop_w % 2 == 0 && job.crop_h % 2 == 0 && job.dst_w % 2 == 0 && job.dst_h % 2 == 0;
+    return format_ok && colorspace_ok && size_ok && job.rotation == 0;
+}
+
+bool OpenCvScaler::scale(const ScaleJob& job) {
+    // 缩放后的 YUV 420 紧凑排列（cvtColor 要求 Y 后紧跟色度），每个线程一块
+    thread_local std::vector<uint8_t> scratch;
+    const int dst_w = job.dst_w, dst_h = job.dst_h;
+    const int chroma_w = dst_w / 2, chroma_h = dst_h / 2;
+    scratch.resize(static_cast<size_t>(dst_w) * dst_h * 3 / 2);
+    uint8_t* scaled_y = scratch.data();
+    uint8_t* scaled_c = scaled_y + static_cast<size_t>(dst_w) * dst_h;
+    
+    const cv::Mat src_y(job.crop_h, job.crop_w, CV_8UC1, job.src_data[0], job.src_linesize[0]);
+    cv::Mat dst_y(dst_h, dst_w, CV_8UC1, scaled_y);
+    cv::resize(src_y, dst_y, dst_y.size(), 0, 0, cv::INTER_LINEAR);
+    
+    int code;
+    if (job.src_fmt == AV_PIX_FMT_YUV420P) {
+        const cv::Mat src_u(job.crop_h / 2, job.crop_w / 2, CV_8UC1, job.src_data[1], job.src_linesize[1]);
+        const cv::Mat src_v(job.crop_h / 2, job.crop_w / 2, CV_8UC1, job.src_data[2], job.src_linesize[2]);
+        cv::Mat dst_u(chroma_h, chroma_w, CV_8UC1, scaled_c);
+        cv::Mat dst_v(chroma_h, chroma_w, CV_8UC1, scaled_c + static_cast<size_t>(chroma_w) * chroma_h);
+        cv::resize(src_u, dst_u, dst_u.size(), 0, 0, cv::INTER_LINEAR);
+        cv::resize(src_v, dst_v, dst_v.size(), 0, 0, cv::INTER_LINEAR);
+        code = cv::COLOR_YUV2BGR_I420;
+    } else {
+        // 交错的 UV 平面按双通道图像缩放
+        const cv::Mat src_uv(job.crop_h / 2, job.crop_w / 2, CV_8UC2, job.src_data[1], job.src_linesize[1]);
+        cv::Mat dst_uv(chroma_h, chroma_w, CV_8UC2, scaled_c);
+        cv::resize(src_uv, dst_uv, dst_uv.size(), 0, 0, cv::INTER_LINEAR);
+        code = job.src_fmt == AV_PIX_FMT_NV12 ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_NV21;
+    }
+    
+    // 目标 Mat 直接包装输出区域（尺寸/类型一致时 cvtColor 不会重新分配）
+    const cv::Mat yuv(dst_h * 3 / 2, dst_w, CV_8UC1, scratch.data());
+    cv::Mat bgr(dst_h, dst_w, CV_8UC3, job.dst, job.dst_linesize);
+    cv::cvtColor(yuv, bgr, code);
+    return bgr.data == job.dst;
+}
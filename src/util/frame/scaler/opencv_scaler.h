@@ -0,0 +1,27 @@
+//
+//  opencv_scaler.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef OPENCV_SCALER_H
+#define OPENCV_SCALER_H
+
+#include "frame_scaler.h"
+
+/**
+ * OpenCV 后端：先在 YUV 域 cv::resize（INTER_LINEAR）各平面，再 cv::cvtColor 直接写入目标帧
+ * 先缩放后转换，下采样时颜色转换只处理输出像素
+ * OpenCV 的 YUV→BGR 只有 BT.601 有限范围矩阵：BT.709 / 全范围的源不支持（交给其他后端）
+ */
+class OpenCvScaler : public FrameScaler {
+public:
+    ScalerBackend backend() const override { return ScalerBackend::OPENCV; }
+    const char* name() const override { return "opencv"; }
+    // YUV420P、NV12、NV21，BT.601 有限范围，裁剪区域和输出宽高为偶数，不旋转
+    bool supports(const ScaleJob& job) const override;
+    bool scale(const ScaleJob& job) override;
+};
+
+#endif /* OPENCV_SCALER_H */
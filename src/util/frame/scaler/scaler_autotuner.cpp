@@ -0,0 +1,133 @@
+//
+//  scaler_autotuner.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include "scaler_autotuner.h"
+#include "../../../common/log/log.h"
+
+bool ScalerAutotuner::Key::operator<(const Key& other) const {
+    return std::tie(src_fmt, dst_w, dst_h, scale_bucket, src_full_range, colorspace, rotation) <
+           std::tie(other.src_fmt, other.dst_w, other.dst_h, other.scale_bucket, other.src_full_range, other.colorspace,
+                    other.rotation);
+}
+
+ScalerAutotuner::ScalerAutotuner(std::vector<FrameScaler*> candidates, int iterations)
+: candidates_(std::move(candidates)), iterations_(std::max(1, iterations)) {
+}
+
+int ScalerAutotuner::scaleBucket(int src_w, int src_h, int dst_w, int dst_h) {
+    const double src_area = std::max(1, src_w) * static_cast<double>(std::max(1, src_h));
+    const double dst_area = std::max(1, dst_w) * static_cast<double>(std::max(1, dst_h));
+    return static_cast<int>(std::lround(2.0 * std::log2(src_area / dst_area)));
+}
+
+FrameScaler* ScalerAutotuner::select(const ScaleJob& job) {
+    const int bucket = scaleBucket(job.crop_w, job.crop_h, job.dst_w, job.dst_h);
+    const Key key{job.src_fmt, job.dst_w, job.dst_h, bucket, job.src_full_range, job.colorspace, job.rotation};
+    std::shared_ptr<Slot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            slot = it->second;
+        } else if (entries_.size() < kMaxEntries) {
+            slot = std::make_shared<Slot>();
+            entries_.emplace(key, slot);
+        }
+    }
+    if (!slot) {
+        // 参数组合过多（如目标尺寸不断变化）：不再测速
+        return firstSupported(job);
+    }
+    std::call_once(slot->once, [&] {
+        slot->entry = tune(job, bucket);
+        slot->ready.store(true, std::memory_order_release);
+    });
+    // 同档位的其他尺寸可能不被测速时选中的后端支持（如尺寸限制），此时退回第一个支持的
+    FrameScaler* scaler = slot->entry.scaler;
+    return scaler && scaler->supports(job) ? scaler : firstSupported(job);
+}
+
+FrameScaler* ScalerAutotuner::firstSupported(const ScaleJob& job) const {
+    for (FrameScaler* scaler : candidates_) {
+        if (scaler && scaler->supports(job)) {
+            return scaler;
+        }
+    }
+    return nullptr;
+}
+
+ScalerAutotuner::Entry ScalerAutotuner::tune(const ScaleJob& job, int scale_bucket) {
+    Entry entry;
+    entry.scaler = nullptr;
+    entry.result.src_w = job.crop_w;
+    entry.result.src_h = job.crop_h;
+    entry.result.src_fmt = job.src_fmt;
+    entry.result.dst_w = job.dst_w;
+    entry.result.dst_h = job.dst_h;
+    entry.result.scale_bucket = scale_bucket;
+    
+    double best_ms = std::numeric_limits<double>::max();
+    for (FrameScaler* scaler : candidates_) {
+        if (!scaler || !scaler->supports(job)) {
+            continue;
+        }
+        // 预热：创建上下文、分配临时缓冲区等一次性开销不计入
+        if (!scaler->scale(job)) {
+            LOG_WARN(std::string("缩放后端测速失败：") + scaler->name());
+            continue;
+        }
+        double min_ms = std::numeric_limits<double>::max();
+        for (int i = 0; i < iterations_; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            scaler->scale(job);
+            auto end = std::chrono::steady_clock::now();
+            min_ms = std::min(min_ms, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        entry.result.timings_ms.emplace_back(scaler->name(), min_ms);
+        if (min_ms < best_ms) {
+            best_ms = min_ms;
+            entry.scaler = scaler;
+        }
+    }
+    if (!entry.scaler) {
+        LOG_ERROR("没有可用的缩放后端（" + std::to_string(job.crop_w) + "x" + std::to_string(job.crop_h) + "）");
+        return entry;
+    }
+    entry.result.selected = entry.scaler->name();
+    
+    std::string detail;
+    for (const auto& timing : entry.result.timings_ms) {
+        detail += " " + timing.first + "=" + std::to_string(timing.second) + "ms";
+    }
+    LOG_INFO("缩放后端选择：" + std::to_string(job.crop_w) + "x" + std::to_string(job.crop_h) + " → " +
+             std::to_string(job.dst_w) + "x" + std::to_string(job.dst_h) + "，选中 " + entry.result.selected + "（" + detail.substr(1) + "）");
+    return entry;
+}
+
+std::vector<ScalerAutotuner::Result> ScalerAutotuner::results() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Result> results;
+    for (const auto& item : entries_) {
+        // 正在测速的槽跳过
+        if (item.second->ready.load(std::memory_order_acquire)) {
+            results.push_back(item.second->entry.result);
+        }
+    }
+    return results;
+}
+
+void ScalerAutotuner::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 正在测速的线程持有槽的引用，测完后结果随槽一起释放
+    entries_.clear();
+}
@@ -0,0 +1,93 @@
+//
+//  scaler_autotuner.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SCALER_AUTOTUNER_H
+#define SCALER_AUTOTUNER_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "frame_scaler.h"
+
+/**
+ * 缩放后端自动选择：每种（格式、颜色属性、目标尺寸、缩放比例档位）第一次出现时，
+ * 用这一帧实测每个支持该任务的后端，之后同参数直接使用最快的
+ * 哪个后端最快随 CPU 和分辨率变化很大（swscale 的汇编路径、OpenCV 的并行、AVX2 融合内核各有优势），不能写死
+ * 源裁剪尺寸按缩放比例分档（每档面积比相差 √2 倍）：ROI 检测框几乎每个尺寸都不同，逐尺寸测速代价远大于收益
+ */
+class ScalerAutotuner {
+public:
+    // 最多记录的参数组合数，超出后新组合不再测速，直接使用第一个支持的后端
+    static constexpr size_t kMaxEntries = 64;
+    
+    // 一种任务参数的测速结果
+    struct Result {
+        int src_w = 0;          // 测速时所用帧的裁剪尺寸（同档位的代表）
+        int src_h = 0;
+        int src_fmt = -1;
+        int dst_w = 0;
+        int dst_h = 0;
+        int scale_bucket = 0;   // 缩放比例档位：round(2 * log2(源面积 / 目标面积))
+        std::string selected;                                   // 选中的后端
+        std::vector<std::pair<std::string, double>> timings_ms; // 各后端的最短耗时
+    };
+    
+    /**
+     * @param candidates 候选后端（由调用者持有），排在前面的在耗时相同时优先
+     * @param iterations 每个后端计时次数（另有一次预热，取最短耗时）
+     */
+    explicit ScalerAutotuner(std::vector<FrameScaler*> candidates, int iterations = 3);
+    
+    /**
+     * 选择后端：首次遇到该任务参数时用这个 job 测速（目标区域会被各后端反复写入），调用方随后用返回的后端正式执行
+     * @return 最快的后端；没有后端支持时返回 nullptr
+     * @note 测速在锁外进行：同一参数只测一次，同时到达的线程等待该参数测速结束，已测过的参数不受影响
+     */
+    FrameScaler* select(const ScaleJob& job);
+    
+    // 已测速的任务参数
+    std::vector<Result> results() const;
+    // 清除测速结果（之后重新测速）
+    void reset();
+    
+    // 缩放比例档位（见 Result::scale_bucket）
+    static int scaleBucket(int src_w, int src_h, int dst_w, int dst_h);
+    
+private:
+    struct Key {
+        int src_fmt, dst_w, dst_h;
+        int scale_bucket;
+        bool src_full_range;
+        int colorspace;
+        int rotation;
+        bool operator<(const Key& other) const;
+    };
+    struct Entry {
+        FrameScaler* scaler;
+        Result result;
+    };
+    // 一个参数组合的测速槽：call_once 保证只测一次，ready 之后 entry 只读
+    struct Slot {
+        std::once_flag once;
+        std::atomic<bool> ready{false};
+        Entry entry{nullptr, Result()};
+    };
+    
+    Entry tune(const ScaleJob& job, int scale_bucket);
+    FrameScaler* firstSupported(const ScaleJob& job) const;
+    
+    std::vector<FrameScaler*> candidates_;
+    int iterations_;
+    mutable std::mutex mutex_;      // 只保护 entries_ 的查找和插入
+    std::map<Key, std::shared_ptr<Slot>> entries_;
+};
+
+#endif /* SCALER_AUTOTUNER_H */
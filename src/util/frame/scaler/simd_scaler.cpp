@@ -0,0 +1,31 @@
+//
+//  simd_scaler.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include "simd_scaler.h"
+#include "../yuv_resize_kernel.h"
+
+bool SimdScaler::supports(const ScaleJob& job) const {
+    return job.frame && YuvResizeKernel::supportsFormat(static_cast<AVPixelFormat>(job.frame->format)) &&
+           job.crop_w > 0 && job.crop_h > 0;
+}
+
+bool SimdScaler::scale(const ScaleJob& job) {
+    YuvResizeJob resize_job;
+    resize_job.frame = job.frame;
+    resize_job.crop_x = job.crop_x;
+    resize_job.crop_y = job.crop_y;
+    resize_job.crop_w = job.crop_w;
+    resize_job.crop_h = job.crop_h;
+    resize_job.out_w = job.dst_w;
+    resize_job.out_h = job.dst_h;
+    resize_job.rotation = job.rotation;
+    resize_job.bgr = job.dst;
+    resize_job.bgr_linesize = job.dst_linesize;
+    YuvResizeKernel::run(resize_job);
+    return true;
+}
@@ -0,0 +1,23 @@
+//
+//  simd_scaler.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SIMD_SCALER_H
+#define SIMD_SCALER_H
+
+#include "frame_scaler.h"
+
+// 工程内 SIMD 后端：YuvResizeKernel 一遍完成双线性缩放 + 颜色转换 + 旋转，输出 BGR24
+class SimdScaler : public FrameScaler {
+public:
+    ScalerBackend backend() const override { return ScalerBackend::SIMD; }
+    const char* name() const override { return "simd"; }
+    // YUV420P、YUVJ420P、NV12、NV21（颜色空间/范围按源帧属性处理，旋转在取样时完成）
+    bool supports(const ScaleJob& job) const override;
+    bool scale(const ScaleJob& job) override;
+};
+
+#endif /* SIMD_SCALER_H */
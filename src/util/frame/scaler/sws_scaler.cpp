@@ -0,0 +1,38 @@
+//
+//  sws_scaler.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include "sws_scaler.h"
+#include "../../../common/log/log.h"
+
+SwsContextCache::Key SwsScaler::makeKey(const ScaleJob& job) {
+    SwsContextCache::Key key;
+    key.src_w = job.crop_w;
+    key.src_h = job.crop_h;
+    key.src_fmt = job.src_fmt;
+    key.dst_w = job.dst_w;
+    key.dst_h = job.dst_h;
+    key.dst_fmt = AV_PIX_FMT_BGR24;
+    key.flags = SWS_BILINEAR;
+    key.src_full_range = job.src_full_range;
+    key.colorspace = job.colorspace;
+    return key;
+}
+
+bool SwsScaler::scale(const ScaleJob& job) {
+    const SwsContextCache::Key key = makeKey(job);
+    SwsContext* sws_ctx = cache_->acquire(key);
+    if (!sws_ctx) {
+        LOG_ERROR("创建缩放上下文失败");
+        return false;
+    }
+    uint8_t* dst_data[4] = {job.dst, nullptr, nullptr, nullptr};
+    int dst_linesize[4] = {job.dst_linesize, 0, 0, 0};
+    const int ret = sws_scale(sws_ctx, job.src_data, job.src_linesize, 0, job.crop_h, dst_data, dst_linesize);
+    cache_->release(key, sws_ctx);
+    return ret == job.dst_h;
+}
@@ -0,0 +1,33 @@
+//
+//  sws_scaler.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SWS_SCALER_H
+#define SWS_SCALER_H
+
+#include "frame_scaler.h"
+#include "../sws_context_cache.h"
+
+// libswscale 后端：上下文从 SwsContextCache 租用，支持 FrameConverter 的所有输入格式
+class SwsScaler : public FrameScaler {
+public:
+    // cache 由调用者持有
+    explicit SwsScaler(SwsContextCache* cache) : cache_(cache) {}
+    
+    ScalerBackend backend() const override { return ScalerBackend::SWSCALE; }
+    const char* name() const override { return "swscale"; }
+    // swscale 不能旋转
+    bool supports(const ScaleJob& job) const override { return job.src_fmt != AV_PIX_FMT_NONE && job.rotation == 0; }
+    bool scale(const ScaleJob& job) override;
+    
+    // 任务对应的上下文参数（切片并行缩放复用）
+    static SwsContextCache::Key makeKey(const ScaleJob& job);
+    
+private:
+    SwsContextCache* cache_;
+};
+
+#endif /* SWS_SCALER_H */
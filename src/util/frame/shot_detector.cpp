@@ -0,0 +1,180 @@
+//
+//  shot_detector.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include "shot_detector.h"
+#include "../simd/cpu_features.h"
+
+// 4 张计数表交错累加：连续像素落在同一级时不会互相等待
+struct HistogramTables {
+    uint32_t counts[4][256];
+};
+
+// 连续字节（step=1）或交错字节（step=2，NV12 的 UV）统计分级计数
+static void histogramScalar(const uint8_t* src, int n, int step, int shift, HistogramTables& tables) {
+    int i = 0;
+    for (; i + 3 < n; i += 4) {
+        tables.counts[0][src[(i    ) * step] >> shift]++;
+        tables.counts[1][src[(i + 1) * step] >> shift]++;
+        tables.counts[2][src[(i + 2) * step] >> shift]++;
+        tables.counts[3][src[(i + 3) * step] >> shift]++;
+    }
+    for (; i < n; ++i) {
+        tables.counts[0][src[i * step] >> shift]++;
+    }
+}
+
+#if SIMD_X86_AVX2
+SIMD_TARGET_AVX2
+static void histogramAVX2(const uint8_t* src, int n, int shift, HistogramTables& tables) {
+    alignas(32) uint8_t bins[32];
+    // srli_epi16 会把高字节的位移进低字节，按字节掩码去掉
+    const __m256i mask = _mm256_set1_epi8(static_cast<char>(0xFF >> shift));
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bins), _mm256_and_si256(_mm256_srl_epi16(v, count), mask));
+        for (int k = 0; k < 32; k += 4) {
+            tables.counts[0][bins[k]]++;
+            tables.counts[1][bins[k + 1]]++;
+            tables.counts[2][bins[k + 2]]++;
+            tables.counts[3][bins[k + 3]]++;
+        }
+    }
+    histogramScalar(src + i, n - i, 1, shift, tables);
+}
+#endif
+
+// 合并 4 张表并归一化
+static void mergeTables(const HistogramTables& tables, int bins, float* out) {
+    uint64_t total = 0;
+    for (int b = 0; b < bins; ++b) {
+        const uint32_t sum = tables.counts[0][b] + tables.counts[1][b] + tables.counts[2][b] + tables.counts[3][b];
+        out[b] = static_cast<float>(sum);
+        total += sum;
+    }
+    const float inv = total > 0 ? 1.0f / total : 0.0f;
+    for (int b = 0; b < bins; ++b) {
+        out[b] *= inv;
+    }
+}
+
+ShotDetector::ShotDetector(const ShotDetectorConfig& config) : config_(config) {
+    config_.row_step = std::max(1, config_.row_step);
+    use_avx2_ = CpuInfo::hasAVX2();
+    prev_histogram_.resize(kHistogramSize);
+    histogram_.resize(kHistogramSize);
+}
+
+bool ShotDetector::computeHistogram(const VideoFrame& frame, float* histogram) {
+    const PixelFormat fmt = frame.pixelFormat();
+    const auto& data = frame.data();
+    const auto& linesize = frame.linesize();
+    // 半平面格式（NV12/NV21）的 U/V 交错在第二个平面；NV21 的 U/V 对调不影响直方图距离
+    const bool semi_planar = fmt == PixelFormat::NV12 || fmt == PixelFormat::NV21;
+    const bool planar = fmt == PixelFormat::YUV420P || fmt == PixelFormat::YUVJ420P ||
+                        fmt == PixelFormat::YUV422P || fmt == PixelFormat::YUV444P;
+    if ((!semi_planar && !planar) || data.size() < (semi_planar ? 2u : 3u) || linesize.size() < (semi_planar ? 2u : 3u)) {
+        return false;
+    }
+    const int width = frame.width();
+    const int height = frame.height();
+    const int chroma_width = fmt == PixelFormat::YUV444P ? width : (width + 1) / 2;
+    const int chroma_height = (fmt == PixelFormat::YUV422P || fmt == PixelFormat::YUV444P) ? height : (height + 1) / 2;
+    const int luma_shift = 2;       // 256 -> 64 级
+    const int chroma_shift = 3;     // 256 -> 32 级
+    
+    auto rows = [this](const uint8_t* plane, int stride, int count, int row_count, int step, int shift, float* out, int bins) {
+        HistogramTables tables = {};
+        for (int y = 0; y < row_count; y += config_.row_step) {
+            const uint8_t* row = plane + static_cast<size_t>(y) * stride;
+#if SIMD_X86_AVX2
+            if (use_avx2_ && step == 1) {
+                histogramAVX2(row, count, shift, tables);
+                continue;
+            }
+#endif
+            histogramScalar(row, count, step, shift, tables);
+        }
+        mergeTables(tables, bins, out);
+    };
+    
+    rows(data[0], linesize[0], width, height, 1, luma_shift, histogram, kLumaBins);
+    if (planar) {
+        rows(data[1], linesize[1], chroma_width, chroma_height, 1, chroma_shift, histogram + kLumaBins, kChromaBins);
+        rows(data[2], linesize[2], chroma_width, chroma_height, 1, chroma_shift, histogram + kLumaBins + kChromaBins, kChromaBins);
+    } else {
+        // NV12/NV21：UV 交错存放
+        rows(data[1], linesize[1], chroma_width, chroma_height, 2, chroma_shift, histogram + kLumaBins, kChromaBins);
+        rows(data[1] + 1, linesize[1], chroma_width, chroma_height, 2, chroma_shift, histogram + kLumaBins + kChromaBins, kChromaBins);
+    }
+    return true;
+}
+
+bool ShotDetector::push(const VideoFrame& frame) {
+    if (!computeHistogram(frame, histogram_.data())) {
+        return false;
+    }
+    bool is_cut = false;
+    if (has_prev_) {
+        // 各分量 L1 距离在 [0, 2]，Y 占一半权重，结果归一化到 [0, 1]
+        float luma = 0.0f;
+        float chroma = 0.0f;
+        for (int i = 0; i < kLumaBins; ++i) {
+            luma += std::fabs(histogram_[i] - prev_histogram_[i]);
+        }
+        for (int i = kLumaBins; i < kHistogramSize; ++i) {
+            chroma += std::fabs(histogram_[i] - prev_histogram_[i]);
+        }
+        last_distance_ = 0.25f * luma + 0.125f * chroma;
+        is_cut = current_.frame_count >= config_.min_shot_frames &&
+                 last_distance_ > config_.threshold &&
+                 last_distance_ > config_.adaptive_ratio * mean_distance_;
+    }
+    
+    if (is_cut || !has_prev_) {
+        if (is_cut) {
+            shots_.push_back(current_);
+            current_.index++;
+        }
+        current_.start_frame = frame_index_;
+        current_.frame_count = 0;
+        current_.start_pts = frame.pts();
+        mean_distance_ = 0.0f;
+    } else {
+        // 镜头内距离的滑动平均（前几帧用算术平均快速收敛）
+        const float alpha = std::max(0.05f, 1.0f / std::max(1, current_.frame_count));
+        mean_distance_ += alpha * (last_distance_ - mean_distance_);
+    }
+    current_.frame_count++;
+    current_.end_pts = frame.pts();
+    frame_index_++;
+    prev_histogram_.swap(histogram_);
+    has_prev_ = true;
+    return is_cut;
+}
+
+void ShotDetector::finish() {
+    if (current_.frame_count > 0) {
+        shots_.push_back(current_);
+        current_.index++;
+        current_.frame_count = 0;
+    }
+    has_prev_ = false;
+}
+
+void ShotDetector::reset() {
+    shots_.clear();
+    current_ = ShotInfo();
+    has_prev_ = false;
+    mean_distance_ = 0.0f;
+    last_distance_ = 0.0f;
+    frame_index_ = 0;
+}
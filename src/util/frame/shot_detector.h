@@ -0,0 +1,81 @@
+//
+//  shot_detector.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SHOT_DETECTOR_H
+#define SHOT_DETECTOR_H
+
+#include <cstdint>
+#include <vector>
+#include "../../common/media_frame.h"
+
+// 镜头切换检测参数
+struct ShotDetectorConfig {
+    float threshold = 0.30f;        // 相邻帧直方图距离的绝对阈值（0~1）
+    float adaptive_ratio = 4.0f;    // 距离还需超过本镜头内平均距离的倍数（抑制快速运动/闪烁的误检）
+    int min_shot_frames = 12;       // 镜头最短帧数（更短的切换视为闪白/转场，不切分）
+    int row_step = 2;               // 隔行采样（1 表示逐行）
+};
+
+// 镜头信息
+struct ShotInfo {
+    int index = 0;                  // 镜头序号（从 0 开始）
+    int start_frame = 0;            // 第一帧序号
+    int frame_count = 0;            // 帧数
+    int64_t start_pts = -1;         // 第一帧 pts
+    int64_t end_pts = -1;           // 最后一帧 pts
+};
+
+/**
+ * 流式镜头切换检测：直接在解码输出的 Y/UV 平面上统计直方图，不需要先转 BGR
+ * 相邻帧 Y（64 级）+ U/V（各 32 级）归一化直方图的 L1 距离同时超过绝对阈值和本镜头平均距离的若干倍时判为切换
+ * 直方图的分级下标用 AVX2 一次算 32 个像素，计数分 4 张表交错累加避免写后读依赖；不支持 AVX2 时走标量
+ * 支持 YUV420P、YUVJ420P、YUV422P、YUV444P、NV12、NV21
+ * 用法：逐帧 push()，返回 true 表示该帧是新镜头的第一帧；结束时 finish() 关闭最后一个镜头
+ */
+class ShotDetector {
+public:
+    explicit ShotDetector(const ShotDetectorConfig& config = ShotDetectorConfig());
+    
+    /**
+     * 输入一帧
+     * @return 该帧开始了新镜头返回true（上一个镜头已加入 shots()）；像素格式不支持时返回false且不计入
+     */
+    bool push(const VideoFrame& frame);
+    
+    // 结束输入，把当前镜头加入 shots()
+    void finish();
+    
+    // 已结束的镜头列表
+    const std::vector<ShotInfo>& shots() const { return shots_; }
+    // 当前（未结束的）镜头
+    const ShotInfo& currentShot() const { return current_; }
+    // 最近一帧与前一帧的直方图距离
+    float lastDistance() const { return last_distance_; }
+    
+    void reset();
+    
+private:
+    static constexpr int kLumaBins = 64;
+    static constexpr int kChromaBins = 32;
+    static constexpr int kHistogramSize = kLumaBins + 2 * kChromaBins;
+    
+    // 统计直方图（归一化到每个分量和为 1），格式不支持返回false
+    bool computeHistogram(const VideoFrame& frame, float* histogram);
+    
+    ShotDetectorConfig config_;
+    bool use_avx2_ = false;
+    std::vector<float> prev_histogram_;
+    std::vector<float> histogram_;
+    bool has_prev_ = false;
+    float mean_distance_ = 0.0f;    // 本镜头内相邻帧距离的滑动平均
+    float last_distance_ = 0.0f;
+    int frame_index_ = 0;
+    ShotInfo current_;
+    std::vector<ShotInfo> shots_;
+};
+
+#endif /* SHOT_DETECTOR_H */
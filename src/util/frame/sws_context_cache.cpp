@@ -0,0 +1,103 @@
+//
+//  sws_context_cache.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include "sws_context_cache.h"
+
+bool SwsContextCache::Key::operator==(const Key& other) const {
+    return src_w == other.src_w && src_h == other.src_h && src_fmt == other.src_fmt &&
+           dst_w == other.dst_w && dst_h == other.dst_h && dst_fmt == other.dst_fmt &&
+           flags == other.flags && src_full_range == other.src_full_range && colorspace == other.colorspace;
+}
+
+SwsContextCache::SwsContextCache(size_t max_idle) : max_idle_(max_idle) {
+}
+
+SwsContextCache::~SwsContextCache() {
+    clear();
+}
+
+SwsContext* SwsContextCache::createContext(const Key& key) {
+    SwsContext* sws_ctx = sws_getContext(key.src_w, key.src_h, static_cast<AVPixelFormat>(key.src_fmt),
+                                         key.dst_w, key.dst_h, static_cast<AVPixelFormat>(key.dst_fmt),
+                                         key.flags, nullptr, nullptr, nullptr);
+    if (!sws_ctx) {
+        return nullptr;
+    }
+    // 颜色矩阵和输入范围（默认 BT.601 有限范围；BT.709 和全范围的源需要显式设置，否则偏色/发灰）
+    const int sws_colorspace = key.colorspace == AVCOL_SPC_BT709 ? SWS_CS_ITU709 : SWS_CS_DEFAULT;
+    sws_setColorspaceDetails(sws_ctx, sws_getCoefficients(sws_colorspace), key.src_full_range ? 1 : 0,
+                             sws_getCoefficients(SWS_CS_DEFAULT), 1, 0, 1 << 16, 1 << 16);
+    return sws_ctx;
+}
+
+SwsContext* SwsContextCache::acquire(const Key& key) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+            if (it->key == key) {
+                SwsContext* sws_ctx = it->sws_ctx;
+                idle_.erase(it);
+                hit_count_++;
+                return sws_ctx;
+            }
+        }
+        miss_count_++;
+    }
+    // 创建耗时较长（初始化滤波器系数），不持锁
+    return createContext(key);
+}
+
+void SwsContextCache::release(const Key& key, SwsContext* sws_ctx) {
+    if (!sws_ctx) {
+        return;
+    }
+    SwsContext* evicted = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_front({key, sws_ctx});
+        if (idle_.size() > max_idle_) {
+            evicted = idle_.back().sws_ctx;
+            idle_.pop_back();
+            eviction_count_++;
+        }
+    }
+    if (evicted) {
+        sws_freeContext(evicted);
+    }
+}
+
+void SwsContextCache::clear() {
+    std::list<Entry> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle.swap(idle_);
+    }
+    for (const Entry& entry : idle) {
+        sws_freeContext(entry.sws_ctx);
+    }
+}
+
+size_t SwsContextCache::hitCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hit_count_;
+}
+
+size_t SwsContextCache::missCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return miss_count_;
+}
+
+size_t SwsContextCache::evictionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return eviction_count_;
+}
+
+size_t SwsContextCache::idleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
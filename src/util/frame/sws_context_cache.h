@@ -0,0 +1,86 @@
+//
+//  sws_context_cache.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef SWS_CONTEXT_CACHE_H
+#define SWS_CONTEXT_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+
+extern "C" {
+#include <libswscale/swscale.h>
+#include <libavutil/pixfmt.h>
+}
+
+/**
+ * SwsContext 缓存（LRU，线程安全）
+ * 一个 FrameConverter 同时服务多路流或多种输出尺寸（如 224x224 模型输入 + 半尺寸渲染）时，
+ * 只缓存一个上下文会在每次调用时反复 sws_getContext
+ * 采用租用方式：acquire 取出的上下文由调用者独占（SwsContext 本身不是线程安全的），用完 release 放回；
+ * 多个线程同时使用同一参数时各自拿到不同的上下文，空闲上下文总数超过上限时释放最久未用的
+ */
+class SwsContextCache {
+public:
+    // 上下文参数：裁剪区域的宽高即 src_w/src_h（裁剪起点只影响源数据指针，与上下文无关）
+    struct Key {
+        int src_w = 0;
+        int src_h = 0;
+        int src_fmt = -1;
+        int dst_w = 0;
+        int dst_h = 0;
+        int dst_fmt = -1;
+        int flags = SWS_BILINEAR;
+        bool src_full_range = false;    // 输入为全范围（0-255）
+        int colorspace = AVCOL_SPC_UNSPECIFIED;    // 输入颜色空间（AVColorSpace）
+        
+        bool operator==(const Key& other) const;
+    };
+    
+    /**
+     * @param max_idle 最多缓存的空闲上下文个数（所有参数合计）
+     */
+    explicit SwsContextCache(size_t max_idle = 16);
+    ~SwsContextCache();
+    
+    SwsContextCache(const SwsContextCache&) = delete;
+    SwsContextCache& operator=(const SwsContextCache&) = delete;
+    
+    /**
+     * 租用上下文：命中时取出空闲上下文，未命中时新建
+     * @return 上下文（调用者独占，用完必须 release），创建失败返回 nullptr
+     */
+    SwsContext* acquire(const Key& key);
+    
+    // 归还上下文（作为最近使用放在队首），空闲数超出上限时释放最久未用的
+    void release(const Key& key, SwsContext* sws_ctx);
+    
+    // 释放所有空闲上下文（租出的不受影响）
+    void clear();
+    
+    size_t hitCount() const;
+    size_t missCount() const;
+    size_t evictionCount() const;
+    size_t idleCount() const;
+    
+private:
+    struct Entry {
+        Key key;
+        SwsContext* sws_ctx;
+    };
+    
+    static SwsContext* createContext(const Key& key);
+    
+    mutable std::mutex mutex_;
+    std::list<Entry> idle_;     // 队首为最近使用
+    size_t max_idle_;
+    size_t hit_count_ = 0;
+    size_t miss_count_ = 0;
+    size_t eviction_count_ = 0;
+};
+
+#endif /* SWS_CONTEXT_CACHE_H */
@@ -0,0 +1,578 @@
+//
+//  yuv_resize_kernel.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "yuv_resize_kernel.h"
+#include "../simd/cpu_features.h"
+
+// 一个方向上的双线性插值抽头：源坐标 index 和 index + next，权重 frac（第二个抽头不越过裁剪区域）
+struct ResizeTaps {
+    std::vector<int32_t> index;
+    std::vector<float> frac;
+    int next = 1;       // 第二个抽头的偏移：区域只有 1 像素时为 0（两个抽头取同一像素，不读区域之外）
+};
+
+// 输出 [0, dst_len) 映射到源 [src_begin, src_begin + src_len)，像素中心对齐；reverse 时从区域末端向起点遍历（旋转/翻转）
+static void buildResizeTaps(int dst_len, int src_begin, int src_len, bool reverse, ResizeTaps& taps) {
+    taps.index.resize(dst_len);
+    taps.frac.resize(dst_len);
+    taps.next = src_len > 1 ? 1 : 0;
+    const double scale = static_cast<double>(src_len) / dst_len;
+    const int last = src_begin + src_len - 1;
+    for (int i = 0; i < dst_len; ++i) {
+        double pos = src_begin + (i + 0.5) * scale - 0.5;
+        pos = std::min(std::max(pos, static_cast<double>(src_begin)), static_cast<double>(last));
+        if (reverse) {
+            pos = src_begin + last - pos;
+        }
+        int index = static_cast<int>(pos);
+        float frac = static_cast<float>(pos - index);
+        if (index >= last) {
+            // 右边界：取 (last - 1, last) 且权重全部给 last；裁剪区域只有 1 像素时退化为同一像素
+            index = std::max(src_begin, last - 1);
+            frac = last > src_begin ? 1.0f : 0.0f;
+        }
+        taps.index[i] = index;
+        taps.frac[i] = frac;
+    }
+}
+
+// YUV -> BGR 系数 + 输出系数：out_c = clamp(BGR_c, 0, 255) * scale_c + bias_c
+struct YuvColorParams {
+    float y_scale, y_offset;        // Y' = (Y - y_offset) * y_scale
+    float c_scale;                  // U' = (U - 128) * c_scale
+    float r_v, g_u, g_v, b_u;       // R = Y' + r_v*V'，G = Y' - g_u*U' - g_v*V'，B = Y' + b_u*U'
+    float scale[3], bias[3];        // 通道顺序 B、G、R
+};
+
+// 一行输出需要的源数据（NV12 的 U/V 指向同一交错行，chroma_step = 2）
+// 常规方向：y0/y1 为上下两行，输出像素沿源行取样，抽头 index 为源列；
+// 转置方向（旋转 90/270）：y0/y1 为同一列在第 0 行和第 1 行的地址，输出像素沿源列取样，抽头 index 为源行（乘以行跨度），
+// fy/fcy 为相邻两列的权重，抽头 frac 为相邻两行的权重
+struct YuvSourceRows {
+    const uint8_t* y0;
+    const uint8_t* y1;
+    const uint8_t* u0;
+    const uint8_t* u1;
+    const uint8_t* v0;
+    const uint8_t* v1;
+    float fy;
+    float fcy;
+    int y_next;         // 转置方向下相邻列的偏移（区域只有 1 列时为 0）
+    int c_next;         // 同上，色度（已乘 chroma_step）
+    int chroma_step;
+    int y_stride;
+    int u_stride;
+    int v_stride;
+};
+
+static inline float lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+template <bool kTransposed>
+static void yuvRowScalar(const YuvSourceRows& rows, const ResizeTaps& lx, const ResizeTaps& cx,
+                         const YuvColorParams& p, int begin, int end, float* out_b, float* out_g, float* out_r) {
+    const int cs = rows.chroma_step;
+    for (int i = begin; i < end; ++i) {
+        float y, u, v;
+        if (kTransposed) {
+            const size_t yo = static_cast<size_t>(lx.index[i]) * rows.y_stride;
+            const size_t uo = static_cast<size_t>(cx.index[i]) * rows.u_stride;
+            const size_t vo = static_cast<size_t>(cx.index[i]) * rows.v_stride;
+            const int yn = rows.y_next;
+            const int cn = rows.c_next;
+            y = lerp(lerp(rows.y0[yo], rows.y0[yo + yn], rows.fy),
+                     lerp(rows.y1[yo], rows.y1[yo + yn], rows.fy), lx.frac[i]);
+            u = lerp(lerp(rows.u0[uo], rows.u0[uo + cn], rows.fcy),
+                     lerp(rows.u1[uo], rows.u1[uo + cn], rows.fcy), cx.frac[i]);
+            v = lerp(lerp(rows.v0[vo], rows.v0[vo + cn], rows.fcy),
+                     lerp(rows.v1[vo], rows.v1[vo + cn], rows.fcy), cx.frac[i]);
+        } else {
+            const int x = lx.index[i];
+            const int c = cx.index[i] * cs;
+            const int xn = lx.next;
+            const int cn = cx.next * cs;
+            y = lerp(lerp(rows.y0[x], rows.y0[x + xn], lx.frac[i]),
+                     lerp(rows.y1[x], rows.y1[x + xn], lx.frac[i]), rows.fy);
+            u = lerp(lerp(rows.u0[c], rows.u0[c + cn], cx.frac[i]),
+                     lerp(rows.u1[c], rows.u1[c + cn], cx.frac[i]), rows.fcy);
+            v = lerp(lerp(rows.v0[c], rows.v0[c + cn], cx.frac[i]),
+                     lerp(rows.v1[c], rows.v1[c + cn], cx.frac[i]), rows.fcy);
+        }
+        const float yy = (y - p.y_offset) * p.y_scale;
+        const float uu = (u - 128.0f) * p.c_scale;
+        const float vv = (v - 128.0f) * p.c_scale;
+        const float b = std::min(std::max(yy + p.b_u * uu, 0.0f), 255.0f);
+        const float g = std::min(std::max(yy - p.g_u * uu - p.g_v * vv, 0.0f), 255.0f);
+        const float r = std::min(std::max(yy + p.r_v * vv, 0.0f), 255.0f);
+        out_b[i] = b * p.scale[0] + p.bias[0];
+        out_g[i] = g * p.scale[1] + p.bias[1];
+        out_r[i] = r * p.scale[2] + p.bias[2];
+    }
+}
+
+#if SIMD_X86_AVX2
+// 8 个输出像素的双线性采样：一次 32 位 gather 同时取到 index 和 index + step 两个相邻样本
+SIMD_TARGET_AVX2
+static inline __m256 bilinearAVX2(const uint8_t* row0, const uint8_t* row1, __m256i index, __m128i next_shift,
+                                  __m256 fx, __m256 fy) {
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i g0 = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row0), index, 1);
+    const __m256i g1 = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row1), index, 1);
+    const __m256 a = _mm256_cvtepi32_ps(_mm256_and_si256(g0, mask));
+    const __m256 b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(g0, next_shift), mask));
+    const __m256 c = _mm256_cvtepi32_ps(_mm256_and_si256(g1, mask));
+    const __m256 d = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(g1, next_shift), mask));
+    const __m256 top = _mm256_fmadd_ps(fx, _mm256_sub_ps(b, a), a);
+    const __m256 bottom = _mm256_fmadd_ps(fx, _mm256_sub_ps(d, c), c);
+    return _mm256_fmadd_ps(fy, _mm256_sub_ps(bottom, top), top);
+}
+
+// 处理 [begin, end)，end - begin 为 8 的倍数；调用方保证 gather 读取的 4 字节不越过行尾
+template <bool kTransposed>
+SIMD_TARGET_AVX2
+static void yuvRowAVX2(const YuvSourceRows& rows, const ResizeTaps& lx, const ResizeTaps& cx,
+                       const YuvColorParams& p, int begin, int end, float* out_b, float* out_g, float* out_r) {
+    const __m128i luma_shift = _mm_cvtsi32_si128(8);
+    const __m128i chroma_shift = _mm_cvtsi32_si128(8 * rows.chroma_step);
+    const __m256i chroma_step = _mm256_set1_epi32(rows.chroma_step);
+    const __m256 fy = _mm256_set1_ps(rows.fy);
+    const __m256 fcy = _mm256_set1_ps(rows.fcy);
+    const __m256 y_offset = _mm256_set1_ps(p.y_offset);
+    const __m256 y_scale = _mm256_set1_ps(p.y_scale);
+    const __m256 c_offset = _mm256_set1_ps(128.0f);
+    const __m256 c_scale = _mm256_set1_ps(p.c_scale);
+    const __m256 r_v = _mm256_set1_ps(p.r_v);
+    const __m256 g_u = _mm256_set1_ps(p.g_u);
+    const __m256 g_v = _mm256_set1_ps(p.g_v);
+    const __m256 b_u = _mm256_set1_ps(p.b_u);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 max_val = _mm256_set1_ps(255.0f);
+    const __m256 scale_b = _mm256_set1_ps(p.scale[0]), bias_b = _mm256_set1_ps(p.bias[0]);
+    const __m256 scale_g = _mm256_set1_ps(p.scale[1]), bias_g = _mm256_set1_ps(p.bias[1]);
+    const __m256 scale_r = _mm256_set1_ps(p.scale[2]), bias_r = _mm256_set1_ps(p.bias[2]);
+    const __m256i y_stride = _mm256_set1_epi32(rows.y_stride);
+    const __m256i u_stride = _mm256_set1_epi32(rows.u_stride);
+    const __m256i v_stride = _mm256_set1_epi32(rows.v_stride);
+    for (int i = begin; i < end; i += 8) {
+        const __m256i lx_index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lx.index.data() + i));
+        const __m256i cx_index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cx.index.data() + i));
+        const __m256 fx = _mm256_loadu_ps(lx.frac.data() + i);
+        const __m256 fcx = _mm256_loadu_ps(cx.frac.data() + i);
+        
+        __m256 y, u, v;
+        if (kTransposed) {
+            // 抽头沿源列方向：偏移为源行 * 行跨度，相邻两列（同一次 gather）按整行统一的 fy/fcy 插值
+            y = bilinearAVX2(rows.y0, rows.y1, _mm256_mullo_epi32(lx_index, y_stride), luma_shift, fy, fx);
+            u = bilinearAVX2(rows.u0, rows.u1, _mm256_mullo_epi32(cx_index, u_stride), chroma_shift, fcy, fcx);
+            v = bilinearAVX2(rows.v0, rows.v1, _mm256_mullo_epi32(cx_index, v_stride), chroma_shift, fcy, fcx);
+        } else {
+            const __m256i c = _mm256_mullo_epi32(cx_index, chroma_step);
+            y = bilinearAVX2(rows.y0, rows.y1, lx_index, luma_shift, fx, fy);
+            u = bilinearAVX2(rows.u0, rows.u1, c, chroma_shift, fcx, fcy);
+            v = bilinearAVX2(rows.v0, rows.v1, c, chroma_shift, fcx, fcy);
+        }
+        
+        const __m256 yy = _mm256_mul_ps(_mm256_sub_ps(y, y_offset), y_scale);
+        const __m256 uu = _mm256_mul_ps(_mm256_sub_ps(u, c_offset), c_scale);
+        const __m256 vv = _mm256_mul_ps(_mm256_sub_ps(v, c_offset), c_scale);
+        __m256 b = _mm256_fmadd_ps(b_u, uu, yy);
+        __m256 g = _mm256_fnmadd_ps(g_v, vv, _mm256_fnmadd_ps(g_u, uu, yy));
+        __m256 r = _mm256_fmadd_ps(r_v, vv, yy);
+        b = _mm256_min_ps(_mm256_max_ps(b, zero), max_val);
+        g = _mm256_min_ps(_mm256_max_ps(g, zero), max_val);
+        r = _mm256_min_ps(_mm256_max_ps(r, zero), max_val);
+        _mm256_storeu_ps(out_b + i, _mm256_fmadd_ps(b, scale_b, bias_b));
+        _mm256_storeu_ps(out_g + i, _mm256_fmadd_ps(g, scale_g, bias_g));
+        _mm256_storeu_ps(out_r + i, _mm256_fmadd_ps(r, scale_r, bias_r));
+    }
+}
+
+// 16 个输出像素的双线性采样（与 bilinearAVX2 相同，512 位）
+SIMD_TARGET_AVX512
+static inline __m512 bilinearAVX512(const uint8_t* row0, const uint8_t* row1, __m512i index, __m128i next_shift,
+                                    __m512 fx, __m512 fy) {
+    const __m512i mask = _mm512_set1_epi32(0xFF);
+    const __m512i g0 = _mm512_i32gather_epi32(index, row0, 1);
+    const __m512i g1 = _mm512_i32gather_epi32(index, row1, 1);
+    const __m512 a = _mm512_cvtepi32_ps(_mm512_and_si512(g0, mask));
+    const __m512 b = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(g0, next_shift), mask));
+    const __m512 c = _mm512_cvtepi32_ps(_mm512_and_si512(g1, mask));
+    const __m512 d = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(g1, next_shift), mask));
+    const __m512 top = _mm512_fmadd_ps(fx, _mm512_sub_ps(b, a), a);
+    const __m512 bottom = _mm512_fmadd_ps(fx, _mm512_sub_ps(d, c), c);
+    return _mm512_fmadd_ps(fy, _mm512_sub_ps(bottom, top), top);
+}
+
+// 处理 [begin, end)，end - begin 为 16 的倍数；其余约束同 yuvRowAVX2
+template <bool kTransposed>
+SIMD_TARGET_AVX512
+static void yuvRowAVX512(const YuvSourceRows& rows, const ResizeTaps& lx, const ResizeTaps& cx,
+                         const YuvColorParams& p, int begin, int end, float* out_b, float* out_g, float* out_r) {
+    const __m128i luma_shift = _mm_cvtsi32_si128(8);
+    const __m128i chroma_shift = _mm_cvtsi32_si128(8 * rows.chroma_step);
+    const __m512i chroma_step = _mm512_set1_epi32(rows.chroma_step);
+    const __m512 fy = _mm512_set1_ps(rows.fy);
+    const __m512 fcy = _mm512_set1_ps(rows.fcy);
+    const __m512 y_offset = _mm512_set1_ps(p.y_offset);
+    const __m512 y_scale = _mm512_set1_ps(p.y_scale);
+    const __m512 c_offset = _mm512_set1_ps(128.0f);
+    const __m512 c_scale = _mm512_set1_ps(p.c_scale);
+    const __m512 r_v = _mm512_set1_ps(p.r_v);
+    const __m512 g_u = _mm512_set1_ps(p.g_u);
+    const __m512 g_v = _mm512_set1_ps(p.g_v);
+    const __m512 b_u = _mm512_set1_ps(p.b_u);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 max_val = _mm512_set1_ps(255.0f);
+    const __m512 scale_b = _mm512_set1_ps(p.scale[0]), bias_b = _mm512_set1_ps(p.bias[0]);
+    const __m512 scale_g = _mm512_set1_ps(p.scale[1]), bias_g = _mm512_set1_ps(p.bias[1]);
+    const __m512 scale_r = _mm512_set1_ps(p.scale[2]), bias_r = _mm512_set1_ps(p.bias[2]);
+    const __m512i y_stride = _mm512_set1_epi32(rows.y_stride);
+    const __m512i u_stride = _mm512_set1_epi32(rows.u_stride);
+    const __m512i v_stride = _mm512_set1_epi32(rows.v_stride);
+    for (int i = begin; i < end; i += 16) {
+        const __m512i lx_index = _mm512_loadu_si512(lx.index.data() + i);
+        const __m512i cx_index = _mm512_loadu_si512(cx.index.data() + i);
+        const __m512 fx = _mm512_loadu_ps(lx.frac.data() + i);
+        const __m512 fcx = _mm512_loadu_ps(cx.frac.data() + i);
+        
+        __m512 y, u, v;
+        if (kTransposed) {
+            y = bilinearAVX512(rows.y0, rows.y1, _mm512_mullo_epi32(lx_index, y_stride), luma_shift, fy, fx);
+            u = bilinearAVX512(rows.u0, rows.u1, _mm512_mullo_epi32(cx_index, u_stride), chroma_shift, fcy, fcx);
+            v = bilinearAVX512(rows.v0, rows.v1, _mm512_mullo_epi32(cx_index, v_stride), chroma_shift, fcy, fcx);
+        } else {
+            const __m512i c = _mm512_mullo_epi32(cx_index, chroma_step);
+            y = bilinearAVX512(rows.y0, rows.y1, lx_index, luma_shift, fx, fy);
+            u = bilinearAVX512(rows.u0, rows.u1, c, chroma_shift, fcx, fcy);
+            v = bilinearAVX512(rows.v0, rows.v1, c, chroma_shift, fcx, fcy);
+        }
+        
+        const __m512 yy = _mm512_mul_ps(_mm512_sub_ps(y, y_offset), y_scale);
+        const __m512 uu = _mm512_mul_ps(_mm512_sub_ps(u, c_offset), c_scale);
+        const __m512 vv = _mm512_mul_ps(_mm512_sub_ps(v, c_offset), c_scale);
+        __m512 b = _mm512_fmadd_ps(b_u, uu, yy);
+        __m512 g = _mm512_fnmadd_ps(g_v, vv, _mm512_fnmadd_ps(g_u, uu, yy));
+        __m512 r = _mm512_fmadd_ps(r_v, vv, yy);
+        b = _mm512_min_ps(_mm512_max_ps(b, zero), max_val);
+        g = _mm512_min_ps(_mm512_max_ps(g, zero), max_val);
+        r = _mm512_min_ps(_mm512_max_ps(r, zero), max_val);
+        _mm512_storeu_ps(out_b + i, _mm512_fmadd_ps(b, scale_b, bias_b));
+        _mm512_storeu_ps(out_g + i, _mm512_fmadd_ps(g, scale_g, bias_g));
+        _mm512_storeu_ps(out_r + i, _mm512_fmadd_ps(r, scale_r, bias_r));
+    }
+}
+#endif
+
+// 一行：[simd_begin, simd_end) 走 SIMD（wide 时先按 16 个一组走 AVX-512，余下的 8 个一组走 AVX2），其余列走标量
+template <bool kTransposed>
+static void processRow(const YuvSourceRows& rows, const ResizeTaps& lx, const ResizeTaps& cx, const YuvColorParams& p,
+                       int simd_begin, int simd_end, bool wide, int out_w, float* out_b, float* out_g, float* out_r) {
+    yuvRowScalar<kTransposed>(rows, lx, cx, p, 0, simd_begin, out_b, out_g, out_r);
+#if SIMD_X86_AVX2
+    if (simd_end > simd_begin) {
+        int begin = simd_begin;
+        if (wide) {
+            const int wide_end = simd_begin + ((simd_end - simd_begin) & ~15);
+            if (wide_end > begin) {
+                yuvRowAVX512<kTransposed>(rows, lx, cx, p, begin, wide_end, out_b, out_g, out_r);
+                begin = wide_end;
+            }
+        }
+        if (simd_end > begin) {
+            yuvRowAVX2<kTransposed>(rows, lx, cx, p, begin, simd_end, out_b, out_g, out_r);
+        }
+    }
+#else
+    simd_end = simd_begin;
+#endif
+    yuvRowScalar<kTransposed>(rows, lx, cx, p, simd_end, out_w, out_b, out_g, out_r);
+}
+
+// 源平面区域 [x0, x0 + w) x [y0, y0 + h) 按 kx * ky 的盒子求平均写入 dst（dst_w x dst_h），step 为相邻像素的字节距离；
+// 边缘不满的盒子只平均区域内的像素
+static void boxDownsample(const uint8_t* src, int src_stride, int step, int x0, int y0, int w, int h, int kx, int ky,
+                          uint8_t* dst, int dst_stride, int dst_w, int dst_h) {
+    std::vector<uint32_t> acc(dst_w);
+    for (int oy = 0; oy < dst_h; ++oy) {
+        const int sy = std::min(y0 + oy * ky, y0 + h - 1);
+        const int rows = std::max(1, std::min(ky, y0 + h - sy));
+        std::fill(acc.begin(), acc.end(), 0u);
+        for (int r = 0; r < rows; ++r) {
+            const uint8_t* line = src + static_cast<size_t>(sy + r) * src_stride;
+            for (int ox = 0; ox < dst_w; ++ox) {
+                const int sx = std::min(x0 + ox * kx, x0 + w - 1);
+                const int cols = std::max(1, std::min(kx, x0 + w - sx));
+                const uint8_t* p = line + static_cast<size_t>(sx) * step;
+                uint32_t sum = 0;
+                for (int c = 0; c < cols; ++c) {
+                    sum += p[c * step];
+                }
+                acc[ox] += sum;
+            }
+        }
+        uint8_t* out = dst + static_cast<size_t>(oy) * dst_stride;
+        for (int ox = 0; ox < dst_w; ++ox) {
+            const int sx = std::min(x0 + ox * kx, x0 + w - 1);
+            const uint32_t count = static_cast<uint32_t>(std::max(1, std::min(kx, x0 + w - sx)) * rows);
+            out[ox] = static_cast<uint8_t>((acc[ox] + count / 2) / count);
+        }
+    }
+}
+
+// 预滤波的中转帧（YUV420P，线程局部，尺寸不变时复用缓冲区）
+struct PrefilterFrame {
+    AVFrame* frame = av_frame_alloc();
+    std::vector<uint8_t> storage;
+    ~PrefilterFrame() { av_frame_free(&frame); }
+};
+
+// 缩小超过 2 倍时：先把源区域按整数倍盒式平均（面积采样）缩到 2 倍以内，再走双线性
+// 2 抽头双线性在大倍率缩小时只用到极少数源像素，会产生混叠；swscale 的 SWS_BILINEAR 缩小时也会按倍率加宽滤波器
+static void runBoxPrefiltered(const YuvResizeJob& job, int kx, int ky) {
+    const AVFrame* src = job.frame;
+    const AVPixelFormat fmt = static_cast<AVPixelFormat>(src->format);
+    const bool nv12 = fmt == AV_PIX_FMT_NV12 || fmt == AV_PIX_FMT_NV21;
+    const bool nv21 = fmt == AV_PIX_FMT_NV21;
+    
+    const int pw = (job.crop_w + kx - 1) / kx;
+    const int ph = (job.crop_h + ky - 1) / ky;
+    const int pcw = (pw + 1) / 2;
+    const int pch = (ph + 1) / 2;
+    // 行跨度留出 gather 一次读 4 字节的余量，并对齐到 32
+    const int y_stride = (pw + 4 + 31) & ~31;
+    const int c_stride = (pcw + 4 + 31) & ~31;
+    
+    thread_local PrefilterFrame prefilter;
+    AVFrame* tmp = prefilter.frame;
+    if (!tmp) {
+        return;
+    }
+    const size_t y_size = static_cast<size_t>(y_stride) * ph;
+    const size_t c_size = static_cast<size_t>(c_stride) * pch;
+    prefilter.storage.resize(y_size + 2 * c_size);
+    tmp->format = AV_PIX_FMT_YUV420P;
+    tmp->width = pw;
+    tmp->height = ph;
+    tmp->colorspace = src->colorspace;
+    tmp->color_range = (fmt == AV_PIX_FMT_YUVJ420P) ? AVCOL_RANGE_JPEG : src->color_range;
+    tmp->data[0] = prefilter.storage.data();
+    tmp->data[1] = tmp->data[0] + y_size;
+    tmp->data[2] = tmp->data[1] + c_size;
+    tmp->linesize[0] = y_stride;
+    tmp->linesize[1] = c_stride;
+    tmp->linesize[2] = c_stride;
+    
+    const int chroma_w = (src->width + 1) / 2;
+    const int chroma_h = (src->height + 1) / 2;
+    const int chroma_x = job.crop_x / 2;
+    const int chroma_y = job.crop_y / 2;
+    const int chroma_crop_w = std::max(1, std::min((job.crop_w + 1) / 2, chroma_w - chroma_x));
+    const int chroma_crop_h = std::max(1, std::min((job.crop_h + 1) / 2, chroma_h - chroma_y));
+    const int chroma_step = nv12 ? 2 : 1;
+    const uint8_t* u_plane = nv12 ? src->data[1] + (nv21 ? 1 : 0) : src->data[1];
+    const uint8_t* v_plane = nv12 ? src->data[1] + (nv21 ? 0 : 1) : src->data[2];
+    const int v_linesize = nv12 ? src->linesize[1] : src->linesize[2];
+    
+    boxDownsample(src->data[0], src->linesize[0], 1, job.crop_x, job.crop_y, job.crop_w, job.crop_h, kx, ky,
+                  tmp->data[0], y_stride, pw, ph);
+    boxDownsample(u_plane, src->linesize[1], chroma_step, chroma_x, chroma_y, chroma_crop_w, chroma_crop_h, kx, ky,
+                  tmp->data[1], c_stride, pcw, pch);
+    boxDownsample(v_plane, v_linesize, chroma_step, chroma_x, chroma_y, chroma_crop_w, chroma_crop_h, kx, ky,
+                  tmp->data[2], c_stride, pcw, pch);
+    
+    YuvResizeJob filtered = job;
+    filtered.frame = tmp;
+    filtered.crop_x = 0;
+    filtered.crop_y = 0;
+    filtered.crop_w = pw;
+    filtered.crop_h = ph;
+    YuvResizeKernel::run(filtered);
+}
+
+bool YuvResizeKernel::supportsFormat(AVPixelFormat fmt) {
+    return fmt == AV_PIX_FMT_YUV420P || fmt == AV_PIX_FMT_YUVJ420P || fmt == AV_PIX_FMT_NV12 || fmt == AV_PIX_FMT_NV21;
+}
+
+void YuvResizeKernel::run(const YuvResizeJob& job) {
+    const AVFrame* yuv_frame = job.frame;
+    const AVPixelFormat src_fmt = static_cast<AVPixelFormat>(yuv_frame->format);
+    const int out_w = job.out_w;
+    const int out_h = job.out_h;
+    
+    // 0. 源图方向上的缩小倍率超过 2 时先做整数倍盒式预滤波（旋转 90/270 时输出的宽对应源图的高）
+    const bool swap_axes = job.rotation == 90 || job.rotation == 270;
+    const int span_x = swap_axes ? out_h : out_w;
+    const int span_y = swap_axes ? out_w : out_h;
+    const int kx = job.crop_w > 2 * span_x ? job.crop_w / span_x : 1;
+    const int ky = job.crop_h > 2 * span_y ? job.crop_h / span_y : 1;
+    if (kx > 1 || ky > 1) {
+        runBoxPrefiltered(job, kx, ky);
+        return;
+    }
+    
+    // 1. 颜色矩阵和输出系数
+    const bool bt709 = yuv_frame->colorspace == AVCOL_SPC_BT709;
+    const bool full_range = src_fmt == AV_PIX_FMT_YUVJ420P || yuv_frame->color_range == AVCOL_RANGE_JPEG;
+    const float kr = bt709 ? 0.2126f : 0.299f;
+    const float kb = bt709 ? 0.0722f : 0.114f;
+    const float kg = 1.0f - kr - kb;
+    YuvColorParams params;
+    params.y_scale = full_range ? 1.0f : 255.0f / 219.0f;
+    params.y_offset = full_range ? 0.0f : 16.0f;
+    params.c_scale = full_range ? 1.0f : 255.0f / 224.0f;
+    params.r_v = 2.0f * (1.0f - kr);
+    params.b_u = 2.0f * (1.0f - kb);
+    params.g_u = 2.0f * kb * (1.0f - kb) / kg;
+    params.g_v = 2.0f * kr * (1.0f - kr) / kg;
+    const bool packed = job.planes[0] == nullptr;
+    for (int c = 0; c < 3; ++c) {
+        params.scale[c] = packed ? 1.0f : job.scale[c];
+        params.bias[c] = packed ? 0.0f : job.bias[c];
+    }
+    
+    // 2. 插值抽头（色度平面按 2:1 下采样的坐标计算）
+    // 输出的 x 方向（lx/cx）和 y 方向（ly/cy）对应的源坐标轴和遍历方向由旋转角度决定，旋转在同一遍取样中完成：
+    // 0：x→源列、y→源行；180：两者反向；90：x→源行（反向）、y→源列；270：x→源行、y→源列（反向）
+    const int rotation = job.rotation;
+    const bool transposed = rotation == 90 || rotation == 270;
+    const bool reverse_x = rotation == 180 || rotation == 90;
+    const bool reverse_y = rotation == 180 || rotation == 270;
+    const int chroma_w = (yuv_frame->width + 1) / 2;
+    const int chroma_h = (yuv_frame->height + 1) / 2;
+    const int chroma_x = job.crop_x / 2;
+    const int chroma_y = job.crop_y / 2;
+    const int chroma_crop_w = std::max(1, std::min((job.crop_w + 1) / 2, chroma_w - chroma_x));
+    const int chroma_crop_h = std::max(1, std::min((job.crop_h + 1) / 2, chroma_h - chroma_y));
+    ResizeTaps lx, ly, cx, cy;
+    if (transposed) {
+        buildResizeTaps(out_w, job.crop_y, job.crop_h, reverse_x, lx);
+        buildResizeTaps(out_h, job.crop_x, job.crop_w, reverse_y, ly);
+        buildResizeTaps(out_w, chroma_y, chroma_crop_h, reverse_x, cx);
+        buildResizeTaps(out_h, chroma_x, chroma_crop_w, reverse_y, cy);
+    } else {
+        buildResizeTaps(out_w, job.crop_x, job.crop_w, reverse_x, lx);
+        buildResizeTaps(out_h, job.crop_y, job.crop_h, reverse_y, ly);
+        buildResizeTaps(out_w, chroma_x, chroma_crop_w, reverse_x, cx);
+        buildResizeTaps(out_h, chroma_y, chroma_crop_h, reverse_y, cy);
+    }
+    
+    // 半平面格式：U/V 在同一交错平面，NV12 为 UV、NV21 为 VU
+    const bool nv12 = src_fmt == AV_PIX_FMT_NV12 || src_fmt == AV_PIX_FMT_NV21;
+    const bool nv21 = src_fmt == AV_PIX_FMT_NV21;
+    const int chroma_step = nv12 ? 2 : 1;
+    const uint8_t* u_plane = nv12 ? yuv_frame->data[1] + (nv21 ? 1 : 0) : yuv_frame->data[1];
+    const uint8_t* v_plane = nv12 ? yuv_frame->data[1] + (nv21 ? 0 : 1) : yuv_frame->data[2];
+    const int y_stride = yuv_frame->linesize[0];
+    const int u_stride = yuv_frame->linesize[1];
+    const int v_stride = nv12 ? yuv_frame->linesize[1] : yuv_frame->linesize[2];
+    
+    // AVX2 的 gather 每次读 4 字节：只对读取不越过行尾（linesize）的源列使用，其余走标量
+    // 常规方向下源列随输出列单调变化，可用的输出列是连续的一段；转置方向下每个输出行只取一列（逐行判断）
+    const int chroma_stride = std::min(u_stride, v_stride);
+    auto columnSafe = [&](int luma_col, int chroma_col) {
+        return luma_col + 3 < y_stride && chroma_col * chroma_step + (nv12 ? 1 : 0) + 3 < chroma_stride;
+    };
+    bool use_simd = false;
+    bool use_wide = false;
+    int simd_begin = 0, simd_end = 0;
+#if SIMD_X86_AVX2
+    use_simd = CpuInfo::hasAVX2();
+    use_wide = CpuInfo::hasAVX512();
+    if (use_simd && !transposed) {
+        if (!reverse_x) {
+            int safe = out_w;
+            while (safe > 0 && !columnSafe(lx.index[safe - 1], cx.index[safe - 1])) {
+                safe--;
+            }
+            simd_end = safe & ~7;
+        } else {
+            int first = 0;
+            while (first < out_w && !columnSafe(lx.index[first], cx.index[first])) {
+                first++;
+            }
+            simd_begin = first;
+            simd_end = first + ((out_w - first) & ~7);
+        }
+    }
+#endif
+    // 转置方向下相邻两行取样：区域只有 1 行时两行取同一行
+    const int luma_next = transposed && job.crop_h > 1 ? y_stride : 0;
+    const int u_next = transposed && chroma_crop_h > 1 ? u_stride : 0;
+    const int v_next = transposed && chroma_crop_h > 1 ? v_stride : 0;
+    
+    // BGR24 输出时先写一行平面浮点，再打包
+    std::vector<float> row_buf(packed ? static_cast<size_t>(3) * out_w : 0);
+    
+    // 3. 逐行输出
+    for (int dy = 0; dy < out_h; ++dy) {
+        YuvSourceRows rows;
+        int row_simd_begin = simd_begin, row_simd_end = simd_end;
+        if (transposed) {
+            rows.y0 = yuv_frame->data[0] + ly.index[dy];
+            rows.y1 = rows.y0 + luma_next;
+            rows.u0 = u_plane + static_cast<size_t>(cy.index[dy]) * chroma_step;
+            rows.u1 = rows.u0 + u_next;
+            rows.v0 = v_plane + static_cast<size_t>(cy.index[dy]) * chroma_step;
+            rows.v1 = rows.v0 + v_next;
+            row_simd_begin = 0;
+            row_simd_end = use_simd && columnSafe(ly.index[dy], cy.index[dy]) ? (out_w & ~7) : 0;
+        } else {
+            rows.y0 = yuv_frame->data[0] + static_cast<size_t>(ly.index[dy]) * y_stride;
+            rows.y1 = rows.y0 + y_stride;
+            rows.u0 = u_plane + static_cast<size_t>(cy.index[dy]) * u_stride;
+            rows.u1 = rows.u0 + u_stride;
+            rows.v0 = v_plane + static_cast<size_t>(cy.index[dy]) * v_stride;
+            rows.v1 = rows.v0 + v_stride;
+            // 裁剪区域只有 1 行时上下两行取同一行
+            if (ly.frac[dy] == 0.0f && ly.index[dy] + 1 >= yuv_frame->height) {
+                rows.y1 = rows.y0;
+            }
+            if (cy.frac[dy] == 0.0f && cy.index[dy] + 1 >= chroma_h) {
+                rows.u1 = rows.u0;
+                rows.v1 = rows.v0;
+            }
+        }
+        rows.fy = ly.frac[dy];
+        rows.fcy = cy.frac[dy];
+        rows.y_next = ly.next;
+        rows.c_next = cy.next * chroma_step;
+        rows.chroma_step = chroma_step;
+        rows.y_stride = y_stride;
+        rows.u_stride = u_stride;
+        rows.v_stride = v_stride;
+        float* out_b;
+        float* out_g;
+        float* out_r;
+        if (packed) {
+            out_b = row_buf.data();
+            out_g = out_b + out_w;
+            out_r = out_g + out_w;
+        } else {
+            const size_t row_offset = static_cast<size_t>(dy) * job.plane_stride;
+            out_b = job.planes[0] + row_offset;
+            out_g = job.planes[1] + row_offset;
+            out_r = job.planes[2] + row_offset;
+        }
+        if (transposed) {
+            processRow<true>(rows, lx, cx, params, row_simd_begin, row_simd_end, use_wide, out_w, out_b, out_g, out_r);
+        } else {
+            processRow<false>(rows, lx, cx, params, row_simd_begin, row_simd_end, use_wide, out_w, out_b, out_g, out_r);
+        }
+        if (packed) {
+            uint8_t* dst = job.bgr + static_cast<size_t>(dy) * job.bgr_linesize;
+            for (int i = 0; i < out_w; ++i) {
+                dst[3 * i] = static_cast<uint8_t>(out_b[i] + 0.5f);
+                dst[3 * i + 1] = static_cast<uint8_t>(out_g[i] + 0.5f);
+                dst[3 * i + 2] = static_cast<uint8_t>(out_r[i] + 0.5f);
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  yuv_resize_kernel.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef YUV_RESIZE_KERNEL_H
+#define YUV_RESIZE_KERNEL_H
+
+#include <cstdint>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+// 一次缩放任务：源图区域 → 输出（平面浮点或 BGR24 打包，二选一）
+struct YuvResizeJob {
+    const AVFrame* frame = nullptr;     // YUV420P、YUVJ420P、NV12、NV21
+    int crop_x = 0;                     // 源区域（亮度坐标，起点需对齐到 2）
+    int crop_y = 0;
+    int crop_w = 0;
+    int crop_h = 0;
+    int out_w = 0;                      // 输出尺寸（旋转后的方向）
+    int out_h = 0;
+    int rotation = 0;                   // 取样时顺时针旋转（0/90/180/270），crop_* 仍为源图坐标
+    
+    // planes 非空时写平面浮点：out_c = clamp(BGR_c, 0, 255) * scale_c + bias_c，通道顺序 B、G、R
+    float* planes[3] = {nullptr, nullptr, nullptr};     // 各平面中输出区域左上角
+    int plane_stride = 0;                               // 平面行跨度（float 个数）
+    float scale[3] = {1.0f, 1.0f, 1.0f};
+    float bias[3] = {0.0f, 0.0f, 0.0f};
+    
+    // 否则写 BGR24 打包（四舍五入到 uint8）
+    uint8_t* bgr = nullptr;
+    int bgr_linesize = 0;
+};
+
+/**
+ * 双线性缩放 + YUV→BGR（+ 旋转）一遍完成（ImagePreprocessor 的融合预处理和 SimdScaler 共用）
+ * 旋转通过选择源图的遍历方向实现（反向抽头 / 沿列取样），不需要额外的旋转步骤
+ * 缩小超过 2 倍的方向先按整数倍做盒式平均预滤波（如 1080→224 先 4:1 面积平均），避免 2 抽头取样的混叠，
+ * 与 swscale 的 SWS_BILINEAR（缩小时按倍率加宽滤波器）结果接近
+ * 颜色矩阵按帧的 colorspace（BT.709 / 其余按 BT.601）和 color_range 选择；
+ * AVX-512 一次处理 16 个、AVX2 一次处理 8 个输出像素（运行时检测，不支持时走标量）
+ */
+class YuvResizeKernel {
+public:
+    static bool supportsFormat(AVPixelFormat fmt);
+    // 调用方保证参数有效（格式受支持、区域在画面内、输出缓冲区足够）
+    static void run(const YuvResizeJob& job);
+};
+
+#endif /* YUV_RESIZE_KERNEL_H */
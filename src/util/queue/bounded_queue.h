@@ -0,0 +1,157 @@
+//
+//  bounded_queue.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// 队列满时的处理策略
+enum class QueuePolicy {
+    BLOCK,       // 阻塞：等待消费者取走数据（保证完整接收，适合文件）
+    DROP_OLDEST  // 丢弃：挤掉最旧的数据（保证实时性，适合摄像头）
+};
+
+/**
+ * 有界阻塞队列：生产者/消费者线程之间传递数据
+ * 线程安全；abort() 后所有阻塞的 push/pop 立即返回
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity, QueuePolicy policy = QueuePolicy::BLOCK)
+    : capacity_(capacity > 0 ? capacity : 1), policy_(policy) {}
+    
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    
+    /**
+     * 入队
+     * @return 成功返回true；队列已中止返回false（数据被丢弃）
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (policy_ == QueuePolicy::BLOCK) {
+            not_full_.wait(lock, [this] { return aborted_ || queue_.size() < capacity_; });
+        }
+        // 先检查中止：中止后的 push 不能再挤掉队列中的旧数据
+        if (aborted_) {
+            return false;
+        }
+        if (policy_ == QueuePolicy::DROP_OLDEST && queue_.size() >= capacity_) {
+            queue_.pop_front();
+            ++dropped_;
+        }
+        queue_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+    
+    /**
+     * 出队（队列为空时阻塞）
+     * @return 取到数据返回true；队列已中止返回false
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return aborted_ || !queue_.empty(); });
+        if (aborted_) {
+            return false;
+        }
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    
+    // 非阻塞出队：队列为空或已中止时返回false
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (aborted_ || queue_.empty()) {
+            return false;
+        }
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    
+    // 中止队列：唤醒所有等待的线程
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+    
+    // 清空数据并恢复可用状态
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        aborted_ = false;
+        not_full_.notify_all();
+    }
+    
+    // 清空数据（不改变中止状态），唤醒被阻塞的生产者
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        not_full_.notify_all();
+    }
+    
+    /**
+     * 取出全部剩余数据（不受中止状态影响），用于停止后回收资源
+     * @return 队列中剩余的数据（按入队顺序）
+     */
+    std::deque<T> takeAll() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::deque<T> items;
+        items.swap(queue_);
+        not_full_.notify_all();
+        return items;
+    }
+    
+    /**
+     * 修改容量和满时策略（队列对象长期存在、每次启动参数不同时使用）
+     * @note 容量缩小不会丢弃已有数据，之后的 push 按新容量等待或丢弃
+     */
+    void configure(size_t capacity, QueuePolicy policy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity > 0 ? capacity : 1;
+        policy_ = policy;
+        not_full_.notify_all();
+    }
+    
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+    
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capacity_;
+    }
+    
+    // DROP_OLDEST 策略下累计丢弃的数量
+    size_t droppedCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+    
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> queue_;
+    size_t capacity_;
+    QueuePolicy policy_;
+    bool aborted_ = false;
+    size_t dropped_ = 0;
+};
+
+#endif /* BOUNDED_QUEUE_H */
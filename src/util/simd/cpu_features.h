@@ -0,0 +1,58 @@
+//
+//  cpu_features.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <atomic>
+
+// x86 上用函数级 target 属性编译 AVX2 内核，运行时按 CPU 能力分发；
+// 整个工程不需要 -mavx2，老 CPU 上走标量路径，其他架构（如 Apple Silicon）标量循环由编译器自动向量化
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_X86_AVX2 1
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#include <immintrin.h>
+#else
+#define SIMD_X86_AVX2 0
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#endif
+
+class CpuInfo {
+public:
+    // 是否使用 AVX2 + FMA（CPU 检测结果在首次调用时缓存）
+    static bool hasAVX2() {
+#if SIMD_X86_AVX2
+        static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return supported && !avx2_disabled_;
+#else
+        return false;
+#endif
+    }
+    
+    // 是否使用 AVX-512F（只有个别热点内核提供 512 位版本；禁用 AVX2 时也一并禁用）
+    static bool hasAVX512() {
+#if SIMD_X86_AVX2
+        static const bool supported = __builtin_cpu_supports("avx512f");
+        return supported && hasAVX2() && !avx512_disabled_;
+#else
+        return false;
+#endif
+    }
+    
+    // 强制走标量路径（基准测试对比、排查 SIMD 问题用）；对之后创建的对象/调用生效
+    static void setAVX2Disabled(bool disabled) { avx2_disabled_ = disabled; }
+    // 只关闭 512 位路径（对比 AVX2 与 AVX-512、规避降频用）
+    static void setAVX512Disabled(bool disabled) { avx512_disabled_ = disabled; }
+    
+private:
+    static inline std::atomic<bool> avx2_disabled_{false};
+    static inline std::atomic<bool> avx512_disabled_{false};
+};
+
+#endif /* CPU_FEATURES_H */
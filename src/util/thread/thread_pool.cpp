@@ -0,0 +1,109 @@
+//
+//  thread_pool.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int thread_count) {
+    if (thread_count < 0) {
+        thread_count = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cond_.notify_all();
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    if (workers_.empty()) {
+        task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    cond_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+            if (stopped_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty()) {
+        for (int i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    // 任务状态放在堆上：辅助任务可能在所有下标完成后才被调度，此时只访问状态、不再调用 fn
+    struct State {
+        std::atomic<int> next{0};
+        int done = 0;
+        std::mutex mutex;
+        std::condition_variable cond;
+    };
+    auto state = std::make_shared<State>();
+    const std::function<void(int)>* fn_ptr = &fn;
+    auto run = [state, fn_ptr, count]() {
+        int finished = 0;
+        for (int i = state->next.fetch_add(1); i < count; i = state->next.fetch_add(1)) {
+            (*fn_ptr)(i);
+            finished++;
+        }
+        if (finished > 0) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done += finished;
+            if (state->done == count) {
+                state->cond.notify_all();
+            }
+        }
+    };
+    const int helpers = std::min(count - 1, threadCount());
+    for (int i = 0; i < helpers; ++i) {
+        submit(run);
+    }
+    run();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cond.wait(lock, [&state, count] { return state->done == count; });
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
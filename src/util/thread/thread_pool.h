@@ -0,0 +1,58 @@
+//
+//  thread_pool.h
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * 固定大小的工作线程池（切片缩放、批量预处理等单帧内的并行任务共用）
+ * parallelFor 时调用线程也参与执行，线程数为 0 的池退化为串行执行
+ */
+class ThreadPool {
+public:
+    /**
+     * @param thread_count 工作线程数（< 0 表示 CPU 核心数 - 1，调用线程算一个）
+     */
+    explicit ThreadPool(int thread_count = -1);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // 提交一个任务（不等待完成）
+    void submit(std::function<void()> task);
+    
+    /**
+     * 并行执行 fn(0) ... fn(count - 1)，全部完成后返回
+     * @note 任务之间不能互相等待；不要在池内任务中嵌套调用同一个池的 parallelFor
+     */
+    void parallelFor(int count, const std::function<void(int)>& fn);
+    
+    // 工作线程数（不含调用线程）
+    int threadCount() const { return static_cast<int>(workers_.size()); }
+    
+    // 进程级共享线程池（首次调用时创建）
+    static ThreadPool& shared();
+    
+private:
+    void workerLoop();
+    
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool stopped_ = false;
+};
+
+#endif /* THREAD_POOL_H */
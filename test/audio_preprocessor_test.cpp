@@ -0,0 +1,135 @@
+//
+//  audio_preprocessor_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest.h>
+
+#include "ai/preprocess/audio_preprocessor.h"
+#include "util/simd/cpu_features.h"
+
+static const double kPi = 3.14159265358979323846;
+
+static double hzToMel(double hz) {
+    return 2595.0 * std::log10(1.0 + hz / 700.0);
+}
+
+static double melToHz(double mel) {
+    return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
+}
+
+// 第 m 个 mel 滤波器的下边界、中心、上边界（HTK 刻度，num_mels + 2 个边界点等间距）
+static void melEdges(const LogMelConfig& config, int m, double& lower, double& center, double& upper) {
+    const double mel_min = hzToMel(config.fmin);
+    const double mel_max = hzToMel(config.fmax);
+    auto edge = [&](int i) { return melToHz(mel_min + (mel_max - mel_min) * i / (config.num_mels + 1)); };
+    lower = edge(m);
+    center = edge(m + 1);
+    upper = edge(m + 2);
+}
+
+// 参考实现：双精度朴素 DFT + 三角滤波器组，与被测的实数 FFT（N/2 点复数 FFT + 后处理）完全独立
+static std::vector<double> referenceLogMel(const LogMelConfig& config, const float* samples) {
+    const int n = config.fft_size;
+    std::vector<double> windowed(n, 0.0);
+    for (int i = 0; i < config.window_size; ++i) {
+        windowed[i] = samples[i] * (0.5 - 0.5 * std::cos(2.0 * kPi * i / config.window_size));
+    }
+    std::vector<double> spectrum(n / 2 + 1);
+    for (int k = 0; k <= n / 2; ++k) {
+        double re = 0.0, im = 0.0;
+        for (int t = 0; t < n; ++t) {
+            re += windowed[t] * std::cos(2.0 * kPi * k * t / n);
+            im -= windowed[t] * std::sin(2.0 * kPi * k * t / n);
+        }
+        const double power = re * re + im * im;
+        spectrum[k] = config.power ? power : std::sqrt(power);
+    }
+    const double bin_hz = static_cast<double>(config.sample_rate) / n;
+    std::vector<double> mel(config.num_mels);
+    for (int m = 0; m < config.num_mels; ++m) {
+        double lower, center, upper;
+        melEdges(config, m, lower, center, upper);
+        double energy = 0.0;
+        for (int k = 0; k <= n / 2; ++k) {
+            const double hz = k * bin_hz;
+            if (hz > lower && hz <= center) {
+                energy += spectrum[k] * (hz - lower) / (center - lower);
+            } else if (hz > center && hz < upper) {
+                energy += spectrum[k] * (upper - hz) / (upper - center);
+            }
+        }
+        mel[m] = std::log(energy + config.log_offset);
+    }
+    return mel;
+}
+
+// 第一帧的 log-mel 与朴素 DFT 参考实现一致：幅度谱和功率谱，标量与 AVX2 路径（路径在构造时选定）
+TEST(LogMelExtractorTest, FirstFrameMatchesNaiveDft) {
+    for (int variant = 0; variant < 4; ++variant) {
+        const bool scalar = variant & 1;
+        const bool power = variant & 2;
+        CpuInfo::setAVX2Disabled(scalar);
+        LogMelConfig config;
+        config.power = power;
+        LogMelExtractor extractor(config);
+        ASSERT_TRUE(extractor.isValid()) << extractor.getErrorMsg();
+        std::vector<float> samples(config.window_size);
+        uint32_t state = 17;
+        for (float& sample : samples) {
+            state = state * 1664525u + 1013904223u;
+            sample = static_cast<float>(state >> 8) / 16777216.0f - 0.5f;
+        }
+        ASSERT_TRUE(extractor.pushSamples(samples.data(), samples.size()));
+        ASSERT_EQ(extractor.availableFrames(), 1u);
+        std::vector<float> mel(config.num_mels);
+        ASSERT_TRUE(extractor.readTensor(mel.data(), 1, 1));
+
+        const std::vector<double> expected = referenceLogMel(config, samples.data());
+        for (int m = 0; m < config.num_mels; ++m) {
+            EXPECT_NEAR(mel[m], expected[m], 1e-3) << "scalar=" << scalar << " power=" << power << " mel=" << m;
+        }
+    }
+    CpuInfo::setAVX2Disabled(false);
+}
+
+// 纯音：能量最大的 mel 频带是中心频率离音调最近的那个
+TEST(LogMelExtractorTest, PureTonePeaksAtNearestMelBand) {
+    LogMelConfig config;
+    for (double tone_hz : {440.0, 1000.0, 3000.0}) {
+        LogMelExtractor extractor(config);
+        ASSERT_TRUE(extractor.isValid()) << extractor.getErrorMsg();
+        std::vector<float> samples(config.sample_rate / 10);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<float>(0.5 * std::sin(2.0 * kPi * tone_hz * i / config.sample_rate));
+        }
+        ASSERT_TRUE(extractor.pushSamples(samples.data(), samples.size()));
+        const size_t frames = extractor.availableFrames();
+        ASSERT_GT(frames, 0u);
+        std::vector<float> mel(frames * config.num_mels);
+        ASSERT_TRUE(extractor.readTensor(mel.data(), static_cast<int>(frames), static_cast<int>(frames)));
+
+        int expected_band = 0;
+        double best_distance = 1e9;
+        for (int m = 0; m < config.num_mels; ++m) {
+            double lower, center, upper;
+            melEdges(config, m, lower, center, upper);
+            if (std::fabs(center - tone_hz) < best_distance) {
+                best_distance = std::fabs(center - tone_hz);
+                expected_band = m;
+            }
+        }
+        for (size_t t = 0; t < frames; ++t) {
+            const float* frame = mel.data() + t * config.num_mels;
+            const int peak = static_cast<int>(std::max_element(frame, frame + config.num_mels) - frame);
+            EXPECT_EQ(peak, expected_band) << "tone=" << tone_hz << " frame=" << t;
+        }
+    }
+}
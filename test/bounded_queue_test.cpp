@@ -0,0 +1,66 @@
+//
+//  bounded_queue_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <thread>
+
+#include <gtest.h>
+#include "util/queue/bounded_queue.h"
+
+// 阻塞模式：队列满时生产者等待，数据完整且有序
+TEST(BoundedQueueTest, BlockPolicyKeepsAllItems) {
+    BoundedQueue<int> queue(2, QueuePolicy::BLOCK);
+    std::thread producer([&queue] {
+        for (int i = 0; i < 100; ++i) {
+            queue.push(i);
+        }
+    });
+    for (int i = 0; i < 100; ++i) {
+        int value = -1;
+        ASSERT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    producer.join();
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+// 丢弃模式：队列满时挤掉最旧的数据
+TEST(BoundedQueueTest, DropPolicyDropsOldest) {
+    BoundedQueue<int> queue(2, QueuePolicy::DROP_OLDEST);
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_EQ(queue.droppedCount(), 1u);
+}
+
+// 中止：唤醒阻塞在 pop 上的消费者
+TEST(BoundedQueueTest, AbortWakesConsumer) {
+    BoundedQueue<int> queue(1);
+    std::thread consumer([&queue] {
+        int value = 0;
+        EXPECT_FALSE(queue.pop(value));
+    });
+    queue.abort();
+    consumer.join();
+    EXPECT_FALSE(queue.push(1));
+    queue.reset();
+    EXPECT_TRUE(queue.push(1));
+}
+
+// 丢弃模式下中止后的 push 不丢弃已有数据
+TEST(BoundedQueueTest, DropPolicyPushAfterAbortKeepsItems) {
+    BoundedQueue<int> queue(2, QueuePolicy::DROP_OLDEST);
+    queue.push(1);
+    queue.push(2);
+    queue.abort();
+    EXPECT_FALSE(queue.push(3));
+    EXPECT_EQ(queue.droppedCount(), 0u);
+    EXPECT_EQ(queue.size(), 2u);
+}
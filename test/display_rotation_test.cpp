@@ -0,0 +1,48 @@
+//
+//  display_rotation_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cstring>
+
+#include <gtest.h>
+
+extern "C" {
+#include <libavutil/display.h>
+#include <libavutil/frame.h>
+}
+
+#include "util/frame/display_rotation.h"
+
+// av_display_rotation_set 的角度是逆时针的，画面需要顺时针旋转同样的角度
+TEST(DisplayRotationTest, FromMatrixReturnsClockwiseRotation) {
+    int32_t matrix[9];
+    const struct { double ccw_angle; int expected; } cases[] = {
+        {0.0, 0}, {-90.0, 90}, {90.0, 270}, {180.0, 180}, {-180.0, 180}, {-80.0, 90}, {-100.0, 90},
+    };
+    for (const auto& c : cases) {
+        av_display_rotation_set(matrix, c.ccw_angle);
+        EXPECT_EQ(DisplayRotation::fromMatrix(matrix), c.expected) << "angle=" << c.ccw_angle;
+    }
+}
+
+TEST(DisplayRotationTest, FromMatrixHandlesInvalidInput) {
+    EXPECT_EQ(DisplayRotation::fromMatrix(nullptr), 0);
+    int32_t singular[9];
+    memset(singular, 0, sizeof(singular));
+    EXPECT_EQ(DisplayRotation::fromMatrix(singular), 0);
+}
+
+TEST(DisplayRotationTest, FromFrameReadsDisplayMatrixSideData) {
+    AVFrame* frame = av_frame_alloc();
+    EXPECT_EQ(DisplayRotation::fromFrame(frame), 0);
+    AVFrameSideData* side_data = av_frame_new_side_data(frame, AV_FRAME_DATA_DISPLAYMATRIX, 9 * sizeof(int32_t));
+    ASSERT_NE(side_data, nullptr);
+    av_display_rotation_set(reinterpret_cast<int32_t*>(side_data->data), -90.0);
+    EXPECT_EQ(DisplayRotation::fromFrame(frame), 90);
+    EXPECT_TRUE(DisplayRotation::swapsAxes(DisplayRotation::fromFrame(frame)));
+    av_frame_free(&frame);
+}
@@ -0,0 +1,95 @@
+//
+//  frame_converter_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cstring>
+
+#include <gtest.h>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include "util/frame/frame_converter.h"
+#include "util/thread/thread_pool.h"
+
+// 伪随机填充 YUV420P 帧（av_frame_get_buffer 分配，带引用计数）
+static AVFrame* makeNoiseFrame(int width, int height, uint32_t seed) {
+    AVFrame* frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    if (av_frame_get_buffer(frame, 32) < 0) {
+        av_frame_free(&frame);
+        return nullptr;
+    }
+    uint32_t state = seed;
+    for (int plane = 0; plane < 3; ++plane) {
+        const int w = plane == 0 ? width : width / 2;
+        const int h = plane == 0 ? height : height / 2;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                state = state * 1664525u + 1013904223u;
+                frame->data[plane][y * frame->linesize[plane] + x] = static_cast<uint8_t>(state >> 24);
+            }
+        }
+    }
+    return frame;
+}
+
+static bool sameBgr(const AVFrame* a, const AVFrame* b) {
+    if (a->width != b->width || a->height != b->height) {
+        return false;
+    }
+    for (int y = 0; y < a->height; ++y) {
+        if (memcmp(a->data[0] + y * a->linesize[0], b->data[0] + y * b->linesize[0], a->width * 3) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 切片并行缩放与单上下文输出逐像素一致（缩小/放大、三种缩放模式、切片数不整除输出行数）
+TEST(FrameConverterTest, SlicedMatchesSingleContext) {
+    AVFrame* frame = makeNoiseFrame(640, 360, 3);
+    ASSERT_NE(frame, nullptr);
+    ThreadPool pool(4);
+    const struct { int w; int h; } sizes[] = {{224, 224}, {300, 170}, {1280, 722}};
+    for (const auto& size : sizes) {
+        for (ResizeMode mode : {ResizeMode::STRETCH, ResizeMode::KEEP_BLACK, ResizeMode::CROP}) {
+            FrameConverter single;
+            FrameConverter sliced;
+            sliced.setSliceThreads(3, &pool, 0);
+            AVFrame* expected = av_frame_alloc();
+            AVFrame* actual = av_frame_alloc();
+            ASSERT_TRUE(single.convertCropResizeYuvToBgr(frame, expected, size.w, size.h, mode));
+            ASSERT_TRUE(sliced.convertCropResizeYuvToBgr(frame, actual, size.w, size.h, mode));
+            EXPECT_TRUE(sameBgr(expected, actual))
+                << size.w << "x" << size.h << " mode=" << static_cast<int>(mode);
+            av_frame_free(&expected);
+            av_frame_free(&actual);
+        }
+    }
+    av_frame_free(&frame);
+}
+
+// 默认每次都填充黑边：调用方在黑边上绘制过内容后再次转换，黑边恢复为黑色
+TEST(FrameConverterTest, LetterboxBorderRefilledByDefault) {
+    AVFrame* frame = makeNoiseFrame(640, 360, 5);
+    ASSERT_NE(frame, nullptr);
+    FrameConverter converter;
+    AVFrame* bgr_frame = av_frame_alloc();
+    ASSERT_TRUE(converter.convertCropResizeYuvToBgr(frame, bgr_frame, 224, 224, ResizeMode::KEEP_BLACK));
+    // 16:9 → 224x224：上下各有黑边，第 0 行一定在黑边内
+    memset(bgr_frame->data[0], 0xff, 224 * 3);
+    ASSERT_TRUE(converter.convertCropResizeYuvToBgr(frame, bgr_frame, 224, 224, ResizeMode::KEEP_BLACK));
+    for (int x = 0; x < 224 * 3; ++x) {
+        ASSERT_EQ(bgr_frame->data[0][x], 0) << "x=" << x;
+    }
+    av_frame_free(&bgr_frame);
+    av_frame_free(&frame);
+}
@@ -0,0 +1,76 @@
+//
+//  image_preprocessor_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <vector>
+
+#include <gtest.h>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include "ai/preprocess/image_preprocessor.h"
+#include "util/frame/frame_converter.h"
+
+// 平滑的二维渐变（双线性与 swscale 的插值差异只在高频处明显，平滑画面上两者应非常接近）
+static AVFrame* makeGradientFrame(int width, int height) {
+    AVFrame* frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    if (av_frame_get_buffer(frame, 32) < 0) {
+        av_frame_free(&frame);
+        return nullptr;
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            frame->data[0][y * frame->linesize[0] + x] = static_cast<uint8_t>(16 + 200 * x / width + 19 * y / height);
+        }
+    }
+    for (int y = 0; y < height / 2; ++y) {
+        for (int x = 0; x < width / 2; ++x) {
+            frame->data[1][y * frame->linesize[1] + x] = static_cast<uint8_t>(96 + 64 * y / (height / 2));
+            frame->data[2][y * frame->linesize[2] + x] = static_cast<uint8_t>(160 - 64 * x / (width / 2));
+        }
+    }
+    return frame;
+}
+
+// 一步到位的 SIMD 内核与 swscale + normalizeBGRFrame 两步流水线在容差内一致（缩小倍率 > 2，经过盒式预滤波）
+TEST(ImagePreprocessorTest, FusedMatchesTwoPassWithinTolerance) {
+    AVFrame* frame = makeGradientFrame(1920, 1080);
+    ASSERT_NE(frame, nullptr);
+    const std::vector<float> mean = {0.0f, 0.0f, 0.0f};
+    const std::vector<float> std = {1.0f, 1.0f, 1.0f};
+    const int dst = 224;
+
+    for (ResizeMode mode : {ResizeMode::STRETCH, ResizeMode::KEEP_BLACK, ResizeMode::CROP}) {
+        FrameConverter converter;
+        AVFrame* bgr_frame = av_frame_alloc();
+        std::vector<float> two_pass(3 * dst * dst);
+        ASSERT_TRUE(converter.convertCropResizeYuvToBgr(frame, bgr_frame, dst, dst, mode));
+        ASSERT_TRUE(ImagePreprocessor::normalizeBGRFrame(bgr_frame, two_pass.data(), mean, std));
+        av_frame_free(&bgr_frame);
+
+        std::vector<float> fused(3 * dst * dst);
+        ASSERT_TRUE(ImagePreprocessor::yuvToNormalizedTensor(frame, fused.data(), dst, dst, mode, mean, std));
+
+        double sum_diff = 0.0;
+        float max_diff = 0.0f;
+        for (size_t i = 0; i < fused.size(); ++i) {
+            const float diff = std::fabs(fused[i] - two_pass[i]);
+            sum_diff += diff;
+            max_diff = std::max(max_diff, diff);
+        }
+        // 值域 [0, 1]：平均误差不超过 1 个灰度级，单点不超过 6 个灰度级（黑边交界处的取整差异）
+        EXPECT_LT(sum_diff / fused.size(), 1.0 / 255.0) << "mode=" << static_cast<int>(mode);
+        EXPECT_LT(max_diff, 6.0f / 255.0f) << "mode=" << static_cast<int>(mode);
+    }
+    av_frame_free(&frame);
+}
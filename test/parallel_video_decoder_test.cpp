@@ -0,0 +1,134 @@
+//
+//  parallel_video_decoder_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <gtest.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include "decoder/parallel_video_decoder.h"
+#include "decoder/video_decoder.h"
+
+// 用 libavcodec 自带的 MPEG-4 编码器生成带 B 帧的 MP4（关键帧 pts 与 dts 不同）
+static bool writeBFrameClip(const std::string& path, int frame_count, int gop_size) {
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    if (!codec) {
+        return false;
+    }
+    AVFormatContext* format_ctx = nullptr;
+    if (avformat_alloc_output_context2(&format_ctx, nullptr, "mp4", path.c_str()) < 0 || !format_ctx) {
+        return false;
+    }
+    AVCodecContext* codec_ctx = avcodec_alloc_context3(codec);
+    codec_ctx->width = 160;
+    codec_ctx->height = 120;
+    codec_ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    codec_ctx->time_base = AVRational{1, 25};
+    codec_ctx->framerate = AVRational{25, 1};
+    codec_ctx->gop_size = gop_size;
+    codec_ctx->max_b_frames = 2;
+    if (format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+        codec_ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    AVStream* stream = avformat_new_stream(format_ctx, nullptr);
+    bool ok = stream && avcodec_open2(codec_ctx, codec, nullptr) >= 0 &&
+              avcodec_parameters_from_context(stream->codecpar, codec_ctx) >= 0;
+    if (ok) {
+        stream->time_base = codec_ctx->time_base;
+        ok = avio_open(&format_ctx->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0 &&
+             avformat_write_header(format_ctx, nullptr) >= 0;
+    }
+
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    frame->format = codec_ctx->pix_fmt;
+    frame->width = codec_ctx->width;
+    frame->height = codec_ctx->height;
+    ok = ok && av_frame_get_buffer(frame, 0) >= 0;
+    for (int i = 0; ok && i <= frame_count; ++i) {
+        AVFrame* input = nullptr;
+        if (i < frame_count) {
+            ok = av_frame_make_writable(frame) >= 0;
+            // 斜向移动的渐变，保证 P/B 帧有真实的运动
+            for (int y = 0; y < frame->height; ++y) {
+                for (int x = 0; x < frame->width; ++x) {
+                    frame->data[0][y * frame->linesize[0] + x] = static_cast<uint8_t>(x + y + i * 3);
+                }
+            }
+            for (int y = 0; y < frame->height / 2; ++y) {
+                for (int x = 0; x < frame->width / 2; ++x) {
+                    frame->data[1][y * frame->linesize[1] + x] = static_cast<uint8_t>(128 + y + i);
+                    frame->data[2][y * frame->linesize[2] + x] = static_cast<uint8_t>(64 + x + i * 2);
+                }
+            }
+            frame->pts = i;
+            input = frame;
+        }
+        ok = ok && avcodec_send_frame(codec_ctx, input) >= 0;
+        while (ok && avcodec_receive_packet(codec_ctx, packet) == 0) {
+            av_packet_rescale_ts(packet, codec_ctx->time_base, stream->time_base);
+            packet->stream_index = stream->index;
+            ok = av_interleaved_write_frame(format_ctx, packet) >= 0;
+        }
+    }
+    ok = ok && av_write_trailer(format_ctx) >= 0;
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&codec_ctx);
+    if (format_ctx->pb) {
+        avio_closep(&format_ctx->pb);
+    }
+    avformat_free_context(format_ctx);
+    return ok;
+}
+
+static std::vector<int64_t> decodeSerial(const std::string& path) {
+    std::vector<int64_t> pts_list;
+    PlayerContext ctx;
+    VideoDecoder decoder(ctx);
+    decoder.setHwAccelEnabled(false);
+    if (!decoder.openVideoDecoder(path)) {
+        return pts_list;
+    }
+    VideoFrame::Ptr frame;
+    while ((frame = decoder.getFrame())) {
+        pts_list.push_back(frame->pts());
+        decoder.framePool().release(std::move(frame));
+    }
+    return pts_list;
+}
+
+// 段边界必须用关键帧的 pts：B 帧片源上，并行拼接的帧数和 pts 序列与顺序解码完全一致
+TEST(ParallelVideoDecoderTest, MatchesSerialDecodeOnBFrameClip) {
+    const std::string path = testing::TempDir() + "parallel_bframes.mp4";
+    if (!writeBFrameClip(path, 120, 12)) {
+        GTEST_SKIP() << "MPEG-4 编码器或 MP4 封装不可用";
+    }
+
+    const std::vector<int64_t> serial = decodeSerial(path);
+    ASSERT_EQ(serial.size(), 120u);
+
+    ParallelVideoDecoder parallel(4, 2);
+    ASSERT_TRUE(parallel.open(path));
+    EXPECT_GT(parallel.segmentCount(), 1u);
+    std::vector<int64_t> stitched;
+    ASSERT_TRUE(parallel.decodeAll([&stitched](const VideoFrame::Ptr& frame) {
+        stitched.push_back(frame->pts());
+        return true;
+    }));
+
+    EXPECT_EQ(stitched.size(), serial.size());
+    EXPECT_EQ(stitched, serial);
+    remove(path.c_str());
+}
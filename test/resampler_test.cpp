@@ -0,0 +1,100 @@
+//
+//  resampler_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include <gtest.h>
+
+#include "util/audio/resampler.h"
+
+struct RateCase {
+    int in_rate;
+    int out_rate;
+};
+
+class ResamplerTest : public testing::TestWithParam<RateCase> {};
+
+// 直流输入：越过开头补零的过渡段后输出恒为 1（每个相位的系数和为 1）
+TEST_P(ResamplerTest, DcGainIsUnity) {
+    const RateCase rates = GetParam();
+    Resampler resampler(rates.in_rate, rates.out_rate);
+    ASSERT_TRUE(resampler.isValid()) << resampler.getErrorMsg();
+    const std::vector<float> input(rates.in_rate / 10, 1.0f);
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+    // 开头 half_taps 个输入采样的窗口里混有补的零
+    const size_t warmup = static_cast<size_t>(16 * static_cast<int64_t>(rates.out_rate) / rates.in_rate) + 1;
+    ASSERT_GT(output.size(), warmup);
+    for (size_t i = warmup; i < output.size(); ++i) {
+        EXPECT_NEAR(output[i], 1.0f, 1e-4f) << "i=" << i;
+    }
+}
+
+// 输出长度 ≈ 输入长度 * out/in，缺少的只是尚未凑满窗口的末尾（不超过 half_taps 个输入采样对应的输出）；
+// 分块输入与一次输入结果一致
+TEST_P(ResamplerTest, OutputLengthFollowsRateAndChunkingIsTransparent) {
+    const RateCase rates = GetParam();
+    const size_t count = static_cast<size_t>(rates.in_rate) / 5;
+    std::vector<float> input(count);
+    for (size_t i = 0; i < count; ++i) {
+        input[i] = static_cast<float>((i * 7919) % 1000) / 1000.0f - 0.5f;
+    }
+
+    Resampler whole(rates.in_rate, rates.out_rate);
+    std::vector<float> expected;
+    whole.process(input.data(), input.size(), expected);
+    const double ideal = static_cast<double>(count) * rates.out_rate / rates.in_rate;
+    const double latency = 16.0 * rates.out_rate / rates.in_rate + 1.0;
+    EXPECT_LE(static_cast<double>(expected.size()), ideal);
+    EXPECT_GE(static_cast<double>(expected.size()), ideal - latency);
+
+    Resampler chunked(rates.in_rate, rates.out_rate);
+    std::vector<float> actual;
+    size_t offset = 0;
+    for (size_t chunk = 1; offset < count; chunk = chunk * 3 % 1031 + 1) {
+        const size_t n = std::min(chunk, count - offset);
+        chunked.process(input.data() + offset, n, actual);
+        offset += n;
+    }
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_FLOAT_EQ(actual[i], expected[i]) << "i=" << i;
+    }
+}
+
+// flush() 补齐末尾：输出总数恰好为 ceil(输入长度 * out / in)，直流输入的末尾样本同样为 1；之后可以开始新的流
+TEST_P(ResamplerTest, FlushEmitsTailWithExactLength) {
+    const RateCase rates = GetParam();
+    Resampler resampler(rates.in_rate, rates.out_rate);
+    for (size_t count : {static_cast<size_t>(rates.in_rate / 10), static_cast<size_t>(rates.in_rate / 10 + 7)}) {
+        const std::vector<float> input(count, 1.0f);
+        std::vector<float> output;
+        resampler.process(input.data(), input.size(), output);
+        const size_t before_flush = output.size();
+        resampler.flush(output);
+        const int64_t numerator = static_cast<int64_t>(count) * rates.out_rate;
+        const size_t expected = static_cast<size_t>((numerator + rates.in_rate - 1) / rates.in_rate);
+        EXPECT_EQ(output.size(), expected) << "count=" << count;
+        EXPECT_GT(output.size(), before_flush);
+        // 末尾窗口里补的零让增益下降，但最后一个输入采样之前的输出仍应接近 1（窗口一半以上是真实输入）
+        const size_t warmup = static_cast<size_t>(16 * static_cast<int64_t>(rates.out_rate) / rates.in_rate) + 1;
+        for (size_t i = warmup; i + warmup < output.size(); ++i) {
+            EXPECT_NEAR(output[i], 1.0f, 1e-4f) << "i=" << i;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(CommonRates, ResamplerTest,
+                         testing::Values(RateCase{48000, 16000}, RateCase{44100, 16000},
+                                         RateCase{16000, 48000}, RateCase{22050, 16000}));
+
+TEST(ResamplerTest, RejectsInvalidRates) {
+    EXPECT_FALSE(Resampler(0, 16000).isValid());
+    EXPECT_FALSE(Resampler(48000, -1).isValid());
+}
@@ -0,0 +1,147 @@
+//
+//  sample_converter_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cstdint>
+#include <vector>
+
+#include <gtest.h>
+
+#include "util/audio/sample_converter.h"
+#include "util/simd/cpu_features.h"
+
+template <typename T>
+static uint8_t* bytes(std::vector<T>& v) {
+    return reinterpret_cast<uint8_t*>(v.data());
+}
+
+// 每个用例在标量和 AVX2 两条路径上各跑一次
+class SampleConverterTest : public testing::TestWithParam<bool> {
+protected:
+    void SetUp() override { CpuInfo::setAVX2Disabled(GetParam()); }
+    void TearDown() override { CpuInfo::setAVX2Disabled(false); }
+};
+
+// S16 → FLT → S16 对全部 65536 个值无损
+TEST_P(SampleConverterTest, S16RoundTripThroughFloatIsExact) {
+    std::vector<int16_t> src(65536);
+    for (int i = 0; i < 65536; ++i) {
+        src[i] = static_cast<int16_t>(i - 32768);
+    }
+    std::vector<float> mid(src.size());
+    std::vector<int16_t> back(src.size());
+    uint8_t* src_planes[1] = {bytes(src)};
+    uint8_t* mid_planes[1] = {bytes(mid)};
+    uint8_t* back_planes[1] = {bytes(back)};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::S16, mid_planes, SampleFormat::FLT, 1, 65536));
+    ASSERT_TRUE(SampleConverter::convert(mid_planes, SampleFormat::FLT, back_planes, SampleFormat::S16, 1, 65536));
+    EXPECT_EQ(back, src);
+    EXPECT_FLOAT_EQ(mid[0], -1.0f);
+    EXPECT_FLOAT_EQ(mid[32768], 0.0f);
+}
+
+// U8 → FLT → U8 对全部 256 个值无损，128 映射到 0
+TEST_P(SampleConverterTest, U8RoundTripThroughFloatIsExact) {
+    std::vector<uint8_t> src(256);
+    for (int i = 0; i < 256; ++i) {
+        src[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<float> mid(src.size());
+    std::vector<uint8_t> back(src.size());
+    uint8_t* src_planes[1] = {src.data()};
+    uint8_t* mid_planes[1] = {bytes(mid)};
+    uint8_t* back_planes[1] = {back.data()};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::U8, mid_planes, SampleFormat::FLT, 1, 256));
+    ASSERT_TRUE(SampleConverter::convert(mid_planes, SampleFormat::FLT, back_planes, SampleFormat::U8, 1, 256));
+    EXPECT_EQ(back, src);
+    EXPECT_FLOAT_EQ(mid[128], 0.0f);
+}
+
+// packed 立体声 S16 → planar S32 → packed S16 无损，且声道拆分正确
+TEST_P(SampleConverterTest, PackedPlanarRoundTripKeepsChannels) {
+    const int nb_samples = 37;
+    std::vector<int16_t> src(2 * nb_samples);
+    for (int i = 0; i < nb_samples; ++i) {
+        src[2 * i] = static_cast<int16_t>(i * 800 - 14000);
+        src[2 * i + 1] = static_cast<int16_t>(-i * 31);
+    }
+    std::vector<int32_t> left(nb_samples), right(nb_samples);
+    std::vector<int16_t> back(src.size());
+    uint8_t* src_planes[1] = {bytes(src)};
+    uint8_t* planar[2] = {bytes(left), bytes(right)};
+    uint8_t* back_planes[1] = {bytes(back)};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::S16, planar, SampleFormat::S32P, 2, nb_samples));
+    EXPECT_EQ(left[5], static_cast<int32_t>(src[10]) * 65536);
+    EXPECT_EQ(right[5], static_cast<int32_t>(src[11]) * 65536);
+    ASSERT_TRUE(SampleConverter::convert(planar, SampleFormat::S32P, back_planes, SampleFormat::S16, 2, nb_samples));
+    EXPECT_EQ(back, src);
+}
+
+// 超出 [-1, 1] 的浮点饱和到各整数格式的极值
+TEST_P(SampleConverterTest, FloatToIntegerSaturates) {
+    std::vector<float> src = {1.5f, -1.5f, 1.0f, -1.0f, 100.0f, -100.0f, 0.0f, 0.5f, 2.0f};
+    const int n = static_cast<int>(src.size());
+    uint8_t* src_planes[1] = {bytes(src)};
+
+    std::vector<int16_t> s16(n);
+    uint8_t* s16_planes[1] = {bytes(s16)};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::FLT, s16_planes, SampleFormat::S16, 1, n));
+    EXPECT_EQ(s16, (std::vector<int16_t>{32767, -32768, 32767, -32768, 32767, -32768, 0, 16384, 32767}));
+
+    std::vector<uint8_t> u8(n);
+    uint8_t* u8_planes[1] = {u8.data()};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::FLT, u8_planes, SampleFormat::U8, 1, n));
+    EXPECT_EQ(u8, (std::vector<uint8_t>{255, 0, 255, 0, 255, 0, 128, 192, 255}));
+
+    // float 表示不了 2^31 - 1，正向饱和到不超过它的最大 float
+    std::vector<int32_t> s32(n);
+    uint8_t* s32_planes[1] = {bytes(s32)};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::FLT, s32_planes, SampleFormat::S32, 1, n));
+    EXPECT_EQ(s32[0], 2147483520);
+    EXPECT_EQ(s32[1], INT32_MIN);
+    EXPECT_EQ(s32[5], INT32_MIN);
+    EXPECT_EQ(s32[6], 0);
+    EXPECT_EQ(s32[7], 1073741824);
+}
+
+// 远超出范围的值（|x| * 32768 超出 int32）也饱和到正确的符号：8 个一组覆盖向量化路径
+TEST_P(SampleConverterTest, LargeOutOfRangeFloatSaturatesWithCorrectSign) {
+    std::vector<float> src = {1e5f, -1e5f, 1e10f, -1e10f, 65536.0f, -65536.0f, 3e38f, -3e38f,
+                              1e5f, -1e5f, 1e10f, -1e10f, 65536.0f, -65536.0f, 3e38f, -3e38f, 1e9f};
+    const int n = static_cast<int>(src.size());
+    uint8_t* src_planes[1] = {bytes(src)};
+
+    std::vector<int16_t> s16(n);
+    uint8_t* s16_planes[1] = {bytes(s16)};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::FLT, s16_planes, SampleFormat::S16, 1, n));
+    std::vector<uint8_t> u8(n);
+    uint8_t* u8_planes[1] = {u8.data()};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::FLT, u8_planes, SampleFormat::U8, 1, n));
+    std::vector<int32_t> s32(n);
+    uint8_t* s32_planes[1] = {bytes(s32)};
+    ASSERT_TRUE(SampleConverter::convert(src_planes, SampleFormat::FLT, s32_planes, SampleFormat::S32, 1, n));
+    for (int i = 0; i < n; ++i) {
+        const bool positive = src[i] > 0;
+        EXPECT_EQ(s16[i], positive ? 32767 : -32768) << "i=" << i;
+        EXPECT_EQ(u8[i], positive ? 255 : 0) << "i=" << i;
+        EXPECT_EQ(s32[i], positive ? 2147483520 : INT32_MIN) << "i=" << i;
+    }
+}
+
+// 多声道取平均混成单声道
+TEST_P(SampleConverterTest, ToMonoFloatAveragesChannels) {
+    const int nb_samples = 20;
+    std::vector<int16_t> left(nb_samples, 16384), right(nb_samples, -8192);
+    uint8_t* planes[2] = {bytes(left), bytes(right)};
+    std::vector<float> mono(nb_samples);
+    ASSERT_TRUE(SampleConverter::toMonoFloat(planes, SampleFormat::S16P, 2, nb_samples, mono.data()));
+    for (float v : mono) {
+        EXPECT_FLOAT_EQ(v, 0.125f);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(ScalarAndSimd, SampleConverterTest, testing::Values(true, false));
@@ -0,0 +1,239 @@
+//
+//  yuv_resize_kernel_test.cpp
+//  mp4_ai_analyzer
+//
+//  Created by Elena Aaron on 16/10/2026.
+//
+
+#include <stdio.h>
+#include <cmath>
+#include <vector>
+
+#include <gtest.h>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include "util/frame/yuv_resize_kernel.h"
+#include "util/simd/cpu_features.h"
+
+// 伪随机填充 YUV420P 帧（固定种子，结果可复现）
+static AVFrame* makeNoiseFrame(int width, int height, uint32_t seed) {
+    AVFrame* frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    if (av_frame_get_buffer(frame, 32) < 0) {
+        av_frame_free(&frame);
+        return nullptr;
+    }
+    uint32_t state = seed;
+    for (int plane = 0; plane < 3; ++plane) {
+        const int w = plane == 0 ? width : (width + 1) / 2;
+        const int h = plane == 0 ? height : (height + 1) / 2;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                state = state * 1664525u + 1013904223u;
+                frame->data[plane][y * frame->linesize[plane] + x] = static_cast<uint8_t>(state >> 24);
+            }
+        }
+    }
+    return frame;
+}
+
+// 平面浮点输出（B、G、R 三个平面连续存放）
+static std::vector<float> runPlanar(const AVFrame* frame, int out_w, int out_h, int rotation) {
+    std::vector<float> out(static_cast<size_t>(3) * out_w * out_h);
+    YuvResizeJob job;
+    job.frame = frame;
+    job.crop_w = frame->width;
+    job.crop_h = frame->height;
+    job.out_w = out_w;
+    job.out_h = out_h;
+    job.rotation = rotation;
+    for (int c = 0; c < 3; ++c) {
+        job.planes[c] = out.data() + static_cast<size_t>(c) * out_w * out_h;
+    }
+    job.plane_stride = out_w;
+    YuvResizeKernel::run(job);
+    return out;
+}
+
+static float maxAbsDiff(const std::vector<float>& a, const std::vector<float>& b) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        diff = std::max(diff, std::fabs(a[i] - b[i]));
+    }
+    return diff;
+}
+
+// 标量、AVX2、AVX-512 三条路径结果一致（只差浮点运算顺序）；输出宽 40 同时覆盖 16 / 8 像素分组和标量尾部
+TEST(YuvResizeKernelTest, SimdPathsMatchScalar) {
+    AVFrame* frame = makeNoiseFrame(96, 64, 7);
+    ASSERT_NE(frame, nullptr);
+    for (int rotation : {0, 90, 180, 270}) {
+        CpuInfo::setAVX2Disabled(true);
+        const std::vector<float> scalar = runPlanar(frame, 40, 36, rotation);
+        CpuInfo::setAVX2Disabled(false);
+        CpuInfo::setAVX512Disabled(true);
+        const std::vector<float> avx2 = runPlanar(frame, 40, 36, rotation);
+        CpuInfo::setAVX512Disabled(false);
+        const std::vector<float> wide = runPlanar(frame, 40, 36, rotation);
+        EXPECT_LT(maxAbsDiff(scalar, avx2), 1e-3f) << "rotation=" << rotation;
+        EXPECT_LT(maxAbsDiff(scalar, wide), 1e-3f) << "rotation=" << rotation;
+    }
+    av_frame_free(&frame);
+}
+
+// 大倍率缩小不混叠：逐像素黑白交替的亮度缩小 8 倍后应接近均匀的灰色（2 抽头取样会得到大片纯黑/纯白）
+TEST(YuvResizeKernelTest, DownscaleBeyondTwoIsAntiAliased) {
+    AVFrame* frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = 512;
+    frame->height = 512;
+    frame->color_range = AVCOL_RANGE_JPEG;
+    ASSERT_GE(av_frame_get_buffer(frame, 32), 0);
+    for (int y = 0; y < frame->height; ++y) {
+        for (int x = 0; x < frame->width; ++x) {
+            frame->data[0][y * frame->linesize[0] + x] = ((x + y) & 1) ? 255 : 0;
+        }
+    }
+    for (int plane = 1; plane < 3; ++plane) {
+        for (int y = 0; y < frame->height / 2; ++y) {
+            for (int x = 0; x < frame->width / 2; ++x) {
+                frame->data[plane][y * frame->linesize[plane] + x] = 128;
+            }
+        }
+    }
+    const std::vector<float> out = runPlanar(frame, 64, 64, 0);
+    for (float value : out) {
+        EXPECT_NEAR(value, 127.5f, 2.0f);
+    }
+    av_frame_free(&frame);
+}
+
+// 按顺时针 rotation 度物理旋转一个平面
+static void rotatePlane(const uint8_t* src, int src_linesize, int w, int h,
+                        uint8_t* dst, int dst_linesize, int rotation) {
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int dx = x, dy = y;
+            if (rotation == 90) {
+                dx = h - 1 - y;
+                dy = x;
+            } else if (rotation == 180) {
+                dx = w - 1 - x;
+                dy = h - 1 - y;
+            } else if (rotation == 270) {
+                dx = y;
+                dy = w - 1 - x;
+            }
+            dst[dy * dst_linesize + dx] = src[y * src_linesize + x];
+        }
+    }
+}
+
+static AVFrame* rotateFrame(const AVFrame* src, int rotation) {
+    const bool swap = rotation == 90 || rotation == 270;
+    AVFrame* dst = av_frame_alloc();
+    dst->format = src->format;
+    dst->width = swap ? src->height : src->width;
+    dst->height = swap ? src->width : src->height;
+    if (av_frame_get_buffer(dst, 32) < 0) {
+        av_frame_free(&dst);
+        return nullptr;
+    }
+    for (int plane = 0; plane < 3; ++plane) {
+        const int w = plane == 0 ? src->width : src->width / 2;
+        const int h = plane == 0 ? src->height : src->height / 2;
+        rotatePlane(src->data[plane], src->linesize[plane], w, h, dst->data[plane], dst->linesize[plane], rotation);
+    }
+    return dst;
+}
+
+// 取样时旋转 == 先物理旋转画面再不旋转取样：1:1 和缩小两种倍率，标量与 SIMD 路径都要满足
+TEST(YuvResizeKernelTest, RotationMatchesPhysicallyRotatedPlanes) {
+    AVFrame* frame = makeNoiseFrame(64, 48, 11);
+    ASSERT_NE(frame, nullptr);
+    for (bool scalar : {true, false}) {
+        CpuInfo::setAVX2Disabled(scalar);
+        for (int rotation : {0, 90, 180, 270}) {
+            AVFrame* rotated = rotateFrame(frame, rotation);
+            ASSERT_NE(rotated, nullptr);
+            const bool swap = rotation == 90 || rotation == 270;
+            for (int divisor : {1, 2}) {
+                const int out_w = (swap ? frame->height : frame->width) / divisor;
+                const int out_h = (swap ? frame->width : frame->height) / divisor;
+                const std::vector<float> sampled = runPlanar(frame, out_w, out_h, rotation);
+                const std::vector<float> reference = runPlanar(rotated, out_w, out_h, 0);
+                EXPECT_LT(maxAbsDiff(sampled, reference), 1e-3f)
+                    << "scalar=" << scalar << " rotation=" << rotation << " divisor=" << divisor;
+            }
+            av_frame_free(&rotated);
+        }
+    }
+    CpuInfo::setAVX2Disabled(false);
+    av_frame_free(&frame);
+}
+
+// 1 像素宽的裁剪区域贴着平面右边缘（亮度和 4:2:0 色度都是最后一列）：第二个抽头不能读到行外。
+// 平面按宽度紧凑存放（linesize == 宽度，没有对齐填充），越界读会落到下一行或缓冲区之外（ASan 可检出）
+TEST(YuvResizeKernelTest, OnePixelCropAtRightEdgeStaysInBounds) {
+    const int width = 63, height = 24;
+    const int chroma_w = (width + 1) / 2, chroma_h = height / 2;
+    std::vector<uint8_t> y_plane(static_cast<size_t>(width) * height, 0);
+    std::vector<uint8_t> u_plane(static_cast<size_t>(chroma_w) * chroma_h, 0);
+    std::vector<uint8_t> v_plane(static_cast<size_t>(chroma_w) * chroma_h, 0);
+    // 最后一列为中灰，其余为黑：读到相邻像素且权重不为 0 时结果会偏离
+    for (int y = 0; y < height; ++y) {
+        y_plane[y * width + width - 1] = 128;
+    }
+    for (int y = 0; y < chroma_h; ++y) {
+        u_plane[y * chroma_w + chroma_w - 1] = 128;
+        v_plane[y * chroma_w + chroma_w - 1] = 128;
+    }
+    AVFrame* frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUVJ420P;
+    frame->width = width;
+    frame->height = height;
+    frame->data[0] = y_plane.data();
+    frame->data[1] = u_plane.data();
+    frame->data[2] = v_plane.data();
+    frame->linesize[0] = width;
+    frame->linesize[1] = chroma_w;
+    frame->linesize[2] = chroma_w;
+
+    for (bool scalar : {true, false}) {
+        CpuInfo::setAVX2Disabled(scalar);
+        for (int rotation : {0, 90, 180, 270}) {
+            const bool swap = rotation == 90 || rotation == 270;
+            const int out_w = swap ? 12 : 8;
+            const int out_h = swap ? 8 : 12;
+            std::vector<float> out(static_cast<size_t>(3) * out_w * out_h);
+            YuvResizeJob job;
+            job.frame = frame;
+            job.crop_x = width - 1;
+            job.crop_y = 0;
+            job.crop_w = 1;
+            job.crop_h = height;
+            job.out_w = out_w;
+            job.out_h = out_h;
+            job.rotation = rotation;
+            for (int c = 0; c < 3; ++c) {
+                job.planes[c] = out.data() + static_cast<size_t>(c) * out_w * out_h;
+            }
+            job.plane_stride = out_w;
+            YuvResizeKernel::run(job);
+            for (float value : out) {
+                EXPECT_NEAR(value, 128.0f, 1e-3f) << "scalar=" << scalar << " rotation=" << rotation;
+            }
+        }
+    }
+    CpuInfo::setAVX2Disabled(false);
+    // 像素数据由 vector 持有，只释放 AVFrame 本身
+    for (int i = 0; i < 3; ++i) {
+        frame->data[i] = nullptr;
+    }
+    av_frame_free(&frame);
+}